@@ -19,6 +19,9 @@
 #include <string.h>
 #include <math.h>
 #include <libconfig.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "global.h"
 #include "configuration.h"
 #include "mpiInit.h"
@@ -58,7 +61,10 @@ getParams( char* configFilename)
 
   }
 
-  config.numNodesPerStream = readInt("numNodesPerStream",N_PROCS,N_PROCS,LARGEINT);
+  config.numFaceGroups = readInt("numFaceGroups", 1, 1, N_PROCS);
+  config.numNodesPerStream = readInt("numNodesPerStream",
+                                     N_PROCS / config.numFaceGroups,
+                                     N_PROCS / config.numFaceGroups, LARGEINT);
   config.numRowsPerFace = readInt("numRowsPerFace", 2, 1, LARGEINT);
   config.numColumnsPerFace = readInt("numColumnsPerFace", 2, 1, LARGEINT);
   config.numEnergySteps = readInt("numEnergySteps", 20, 2, LARGEINT);
@@ -72,6 +78,7 @@ getParams( char* configFilename)
   config.tDel = readDouble("tDel", 0.01041666666667, SMALLFLOAT, LARGEFLOAT);
   config.simStopTime = readDouble("simStopTime", config.simStartTime + config.tDel, config.simStartTime, LARGEFLOAT);
   config.numEpSteps = readInt("numEpSteps", 30, 1, LARGEINT);
+  config.numEpThreads = readInt("numEpThreads", 1, 0, LARGEINT);
   config.aziSunStart = readDouble("aziSunStart", 0.0, 0.0, LARGEFLOAT);
   config.omegaSun = readDouble("omegaSun", 0.001429813, 0.0, LARGEFLOAT);
   config.lamo = readDouble("lamo", 1.0, SMALLFLOAT, LARGEFLOAT);
@@ -118,6 +125,15 @@ getParams( char* configFilename)
   config.useShellDiffusion = readInt("useShellDiffusion", 0, 0, 1);
   config.useParallelDiffusion = readInt("useParallelDiffusion", 1, 0, 1);
   config.useDrift = readInt("useDrift", 0, 0, 1);
+  config.useStreamTranspose = readInt("useStreamTranspose", 0, 0, 1);
+  config.shellRebalanceInterval = readInt("shellRebalanceInterval", 0, 0, LARGEINT);
+  config.useStreamScheduling = readInt("useStreamScheduling", 0, 0, 1);
+  config.useImplicitStreaming = readInt("useImplicitStreaming", 0, 0, 1);
+  config.implicitStreamCfl = readDouble("implicitStreamCfl", 10.0, SMALLFLOAT, LARGEFLOAT);
+  config.streamStepLevels = readInt("streamStepLevels", 0, 0, 10);
+  config.useNodeEpSteps = readInt("useNodeEpSteps", 0, 0, 1);
+  config.quietNodeTolerance = readDouble("quietNodeTolerance", 0.0, 0.0, LARGEFLOAT);
+  config.isotropicTauRatio = readDouble("isotropicTauRatio", 0.0, 0.0, 1.0);
 
   config.numSpecies = readInt("numSpecies", 1, 1, 100);
   Scalar_t defaultMass[1] = {1.0};
@@ -163,6 +179,11 @@ getParams( char* configFilename)
   config.mhdSteadyState = readInt("mhdSteadyState", 1, 0, 1);
   config.mhdDirectory = (char*)readString("mhdDirectory"," ");
   config.mhdDigits = readInt("mhdDigits", 3, 0, 32767);
+  config.mhdPrefetch = readInt("mhdPrefetch", 0, 0, 1);
+  config.mhdCacheFile = (char*)readString("mhdCacheFile", "");
+  config.mhdRadialWindow = readInt("mhdRadialWindow", 0, 0, 32767);
+  config.mhdInterleave = readInt("mhdInterleave", 0, 0, 1);
+  config.mhdCurlOnMesh = readInt("mhdCurlOnMesh", 0, 0, 1);
 
   config.mhdCoupledTime = readInt("mhdCoupledTime", 1, 0, 1);
   config.mhdStartTime = readDouble("mhdStartTime", 0.0, 0.0, LARGEFLOAT);
@@ -410,6 +431,14 @@ setRuntimeConstants( void )
 
   TOTAL_NUM_SHELLS = config.numNodesPerStream;
 
+  // Threads per rank for the energetic-particle update. A value of 0 defers
+  // to the OpenMP runtime (e.g., OMP_NUM_THREADS).
+#ifdef _OPENMP
+  N_THREADS = (config.numEpThreads > 0) ? config.numEpThreads : omp_get_max_threads();
+#else
+  N_THREADS = 1;
+#endif
+
   config.simStartTimeDay = config.simStartTime / DAY;
   config.simStopTimeDay  = config.simStopTime / DAY;
   config.tDel            /= DAY;
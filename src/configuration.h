@@ -18,6 +18,7 @@
 
 typedef struct {
 
+  Index_t  numFaceGroups;
   Index_t  numNodesPerStream;
   Index_t  numRowsPerFace;
   Index_t  numColumnsPerFace;
@@ -34,6 +35,7 @@ typedef struct {
   Scalar_t  simStopTime;
   Scalar_t  tDel;
   Index_t   numEpSteps;
+  Index_t   numEpThreads;
   Scalar_t  aziSunStart;
   Scalar_t  omegaSun;
   Scalar_t  lamo;
@@ -82,6 +84,15 @@ typedef struct {
   Index_t    useShellDiffusion;
   Index_t    useParallelDiffusion;
   Index_t    useDrift;
+  Index_t    useStreamTranspose;
+  Index_t    shellRebalanceInterval;
+  Index_t    useStreamScheduling;
+  Index_t    useImplicitStreaming;
+  Scalar_t   implicitStreamCfl;
+  Index_t    streamStepLevels;
+  Index_t    useNodeEpSteps;
+  Scalar_t   quietNodeTolerance;
+  Scalar_t   isotropicTauRatio;
 
   Index_t fluxLimiter;
 
@@ -107,6 +118,11 @@ typedef struct {
   Index_t mhdSteadyState;
   char* mhdDirectory;
   Index_t mhdDigits;
+  Index_t mhdPrefetch;
+  char* mhdCacheFile;
+  Index_t mhdRadialWindow;
+  Index_t mhdInterleave;
+  Index_t mhdCurlOnMesh;
 
   Index_t mhdCoupledTime;
   Scalar_t mhdStartTime;
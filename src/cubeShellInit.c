@@ -58,10 +58,30 @@
 /*-----------------------------------------------------------------------*/
 {
 
+  Index_t face, row, col;
+
+  Node_t *cube;
+
   /*-- Give each array element on the inner-most cube its cube --*/
-  /*-- surface grid neighbor links.                            --*/
+  /*-- surface grid neighbor links. They are worked out on a   --*/
+  /*-- whole scratch shell, as the links of the nodes stored   --*/
+  /*-- on this rank reach nodes that are not.                  --*/
 
-  initNEWS( INNER_SHELL );
+  cube = (Node_t *) malloc(sizeof(Node_t) * FRC);
+
+  initNEWS( cube, INNER_SHELL );
+
+  for (face = 0; face < NUM_FACES; face++)
+    for (row = 0; row < FACE_ROWS; row++)
+      for (col = 0; col < FACE_COLS; col++)
+        if (LOCAL_NODE(face,row,col)) {
+          grid[idx_frcs(face,row,col,INNER_SHELL)].n = cube[idx_frc(face,row,col)].n;
+          grid[idx_frcs(face,row,col,INNER_SHELL)].e = cube[idx_frc(face,row,col)].e;
+          grid[idx_frcs(face,row,col,INNER_SHELL)].w = cube[idx_frc(face,row,col)].w;
+          grid[idx_frcs(face,row,col,INNER_SHELL)].s = cube[idx_frc(face,row,col)].s;
+        }
+
+  free(cube);
 
   /*-- Give each array element of the inner-most cube its        --*/
   /*-- unit cube coordinates. Cube center is at origin (0,0,0).  --*/
@@ -94,10 +114,11 @@
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 /*--*/          void                                                /*---*/
-/*--*/    initNEWS( Index_t shell )                                 /*---*/
+/*--*/    initNEWS( Node_t *cube, Index_t shell )                   /*---*/
 /*--*                                                                *---*/
-/*--*  Give each node on this shell its cube-surface grid links to   *---*/
-/*--*  its NEWS neighbors on the cube surface.                       *---*/
+/*--*  Give each node of cube, all nodes of a shell indexed by       *---*/
+/*--*  idx_frc, its cube-surface grid links to its NEWS neighbors on *---*/
+/*--*  the cube surface, as links on this shell.                     *---*/
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 {
@@ -123,29 +144,29 @@
     for (row = 0; row < FACE_ROWS; row++){
       for (col = 0; col < FACE_COLS; col++){
 
-        grid[idx_frcs(face,row,col,shell)].n.face  = face;
-        grid[idx_frcs(face,row,col,shell)].n.row   = row - 1;
-        grid[idx_frcs(face,row,col,shell)].n.col   = col;
-        grid[idx_frcs(face,row,col,shell)].n.shell = shell;
-        grid[idx_frcs(face,row,col,shell)].n.rank  = mpi_rank ;
-
-        grid[idx_frcs(face,row,col,shell)].e.face  = face;
-        grid[idx_frcs(face,row,col,shell)].e.row   = row;
-        grid[idx_frcs(face,row,col,shell)].e.col   = col + 1;
-        grid[idx_frcs(face,row,col,shell)].e.shell = shell;
-        grid[idx_frcs(face,row,col,shell)].e.rank  = mpi_rank ;
-
-        grid[idx_frcs(face,row,col,shell)].w.face  = face;
-        grid[idx_frcs(face,row,col,shell)].w.row   = row;
-        grid[idx_frcs(face,row,col,shell)].w.col   = col - 1;
-        grid[idx_frcs(face,row,col,shell)].w.shell = shell;
-        grid[idx_frcs(face,row,col,shell)].w.rank  = mpi_rank ;
-
-        grid[idx_frcs(face,row,col,shell)].s.face  = face;
-        grid[idx_frcs(face,row,col,shell)].s.row   = row + 1;
-        grid[idx_frcs(face,row,col,shell)].s.col   = col;
-        grid[idx_frcs(face,row,col,shell)].s.shell = shell;
-        grid[idx_frcs(face,row,col,shell)].s.rank  = mpi_rank ;
+        cube[idx_frc(face,row,col)].n.face  = face;
+        cube[idx_frc(face,row,col)].n.row   = row - 1;
+        cube[idx_frc(face,row,col)].n.col   = col;
+        cube[idx_frc(face,row,col)].n.shell = shell;
+        cube[idx_frc(face,row,col)].n.rank  = mpi_rank ;
+
+        cube[idx_frc(face,row,col)].e.face  = face;
+        cube[idx_frc(face,row,col)].e.row   = row;
+        cube[idx_frc(face,row,col)].e.col   = col + 1;
+        cube[idx_frc(face,row,col)].e.shell = shell;
+        cube[idx_frc(face,row,col)].e.rank  = mpi_rank ;
+
+        cube[idx_frc(face,row,col)].w.face  = face;
+        cube[idx_frc(face,row,col)].w.row   = row;
+        cube[idx_frc(face,row,col)].w.col   = col - 1;
+        cube[idx_frc(face,row,col)].w.shell = shell;
+        cube[idx_frc(face,row,col)].w.rank  = mpi_rank ;
+
+        cube[idx_frc(face,row,col)].s.face  = face;
+        cube[idx_frc(face,row,col)].s.row   = row + 1;
+        cube[idx_frc(face,row,col)].s.col   = col;
+        cube[idx_frc(face,row,col)].s.shell = shell;
+        cube[idx_frc(face,row,col)].s.rank  = mpi_rank ;
 
 	    }/*for col*/
     }/*for row*/
@@ -181,15 +202,15 @@
   row2  = 0;                  /*-- top of RIGHT. --*/
   for (col = 0; col < FACE_COLS; col++){
     col2 = col;  /*-- same x alignment. --*/
-    grid[idx_frcs(face,row,col,shell)].s.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].s.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].s.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].s.rank   = mpi_rank ;
-
-    grid[idx_frcs(face2,row2,col2,shell)].n.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].n.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].n.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].n.rank   = mpi_rank ;
+    cube[idx_frc(face,row,col)].s.face  = face2;
+    cube[idx_frc(face,row,col)].s.row   = row2;
+    cube[idx_frc(face,row,col)].s.col   = col2;
+    cube[idx_frc(face,row,col)].s.rank   = mpi_rank ;
+
+    cube[idx_frc(face2,row2,col2)].n.face  = face;
+    cube[idx_frc(face2,row2,col2)].n.row   = row;
+    cube[idx_frc(face2,row2,col2)].n.col   = col;
+    cube[idx_frc(face2,row2,col2)].n.rank   = mpi_rank ;
   }
 
   /*-- connect top/N of TOP to top/N of LEFT --*/
@@ -199,15 +220,15 @@
   row2  = 0;                  /*-- top of LEFT. --*/
   for (col = 0; col < FACE_COLS; col++){
     col2 = (FACE_COLS - 1) - col;  /*-- counter x alignment. --*/
-    grid[idx_frcs(face,row,col,shell)].n.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].n.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].n.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].n.rank   = mpi_rank;
-
-    grid[idx_frcs(face2,row2,col2,shell)].n.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].n.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].n.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].n.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].n.face  = face2;
+    cube[idx_frc(face,row,col)].n.row   = row2;
+    cube[idx_frc(face,row,col)].n.col   = col2;
+    cube[idx_frc(face,row,col)].n.rank   = mpi_rank;
+
+    cube[idx_frc(face2,row2,col2)].n.face  = face;
+    cube[idx_frc(face2,row2,col2)].n.row   = row;
+    cube[idx_frc(face2,row2,col2)].n.col   = col;
+    cube[idx_frc(face2,row2,col2)].n.rank   = mpi_rank;
   }
 
   /*-- connect left/W of TOP to top/N of BACK --*/
@@ -219,18 +240,18 @@
   for (row = 0; row < FACE_ROWS; row++){
     col2 = (Index_t) ((0.5*dh/dw) - 0.5 + (row*dh/dw) + 0.499) ;
     /*-- y alignment: BACK col to TOP row. --*/
-    grid[idx_frcs(face,row,col,shell)].w.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].w.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].w.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].w.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].w.face  = face2;
+    cube[idx_frc(face,row,col)].w.row   = row2;
+    cube[idx_frc(face,row,col)].w.col   = col2;
+    cube[idx_frc(face,row,col)].w.rank   = mpi_rank;
   }
 
   for (col2 = 0; col2 < FACE_COLS; col2++) {
     row = (Index_t) ((0.5*dw/dh) - 0.5 + (col2*dw/dh) + 0.499) ;
-    grid[idx_frcs(face2,row2,col2,shell)].n.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].n.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].n.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].n.rank   = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].n.face  = face;
+    cube[idx_frc(face2,row2,col2)].n.row   = row;
+    cube[idx_frc(face2,row2,col2)].n.col   = col;
+    cube[idx_frc(face2,row2,col2)].n.rank   = mpi_rank;
   }
 
   /*-- connect right/E of TOP to top/N of FRONT --*/
@@ -241,19 +262,19 @@
   for (row = 0; row < FACE_ROWS; row++){
     col2p = (Index_t) ((0.5*dh/dw) - 0.5 + (row*dh/dw) + 0.499) ;
     col2 = (FACE_COLS - 1) - col2p;  /*-- y: FRONT -col to TOP row. --*/
-    grid[idx_frcs(face,row,col,shell)].e.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].e.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].e.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].e.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].e.face  = face2;
+    cube[idx_frc(face,row,col)].e.row   = row2;
+    cube[idx_frc(face,row,col)].e.col   = col2;
+    cube[idx_frc(face,row,col)].e.rank   = mpi_rank;
   }
 
   for (col2p = 0; col2p < FACE_COLS; col2p++){
     col2 = (FACE_COLS - 1) - col2p; /* col2 runs from high to low number */
     row = (Index_t) ((0.5*dw/dh) - 0.5 + (col2p*dw/dh) + 0.499) ; /* row runs from low to high */
-    grid[idx_frcs(face2,row2,col2,shell)].n.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].n.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].n.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].n.rank   = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].n.face  = face;
+    cube[idx_frc(face2,row2,col2)].n.row   = row;
+    cube[idx_frc(face2,row2,col2)].n.col   = col;
+    cube[idx_frc(face2,row2,col2)].n.rank   = mpi_rank;
   }
 
   /*-- connect left/W of BOTTOM to bottom/S of FRONT --*/
@@ -268,20 +289,20 @@
   for (row = 0; row < FACE_ROWS; row++){
     col2p = (Index_t) ((0.5*dh/dw) - 0.5 + (row*dh/dw) + 0.499) ;
     col2 = (FACE_COLS - 1) - col2p;
-    grid[idx_frcs(face,row,col,shell)].w.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].w.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].w.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].w.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].w.face  = face2;
+    cube[idx_frc(face,row,col)].w.row   = row2;
+    cube[idx_frc(face,row,col)].w.col   = col2;
+    cube[idx_frc(face,row,col)].w.rank   = mpi_rank;
   }
 
   /* run through columns on Front Face */
   for (col2p=0; col2p < FACE_COLS; col2p++){
     col2 = (FACE_COLS - 1) - col2p;  /* col 2 runs high to low */
     row = (Index_t) ((0.5*dw/dh) - 0.5 + (col2p*dw/dh) + 0.499) ; /* row runs from low to high */
-    grid[idx_frcs(face2,row2,col2,shell)].s.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].s.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].s.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].s.rank  = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].s.face  = face;
+    cube[idx_frc(face2,row2,col2)].s.row   = row;
+    cube[idx_frc(face2,row2,col2)].s.col   = col;
+    cube[idx_frc(face2,row2,col2)].s.rank  = mpi_rank;
   }
 
   /*-- connect right/E of BOTTOM to bottom/S of BACK --*/
@@ -295,18 +316,18 @@
 
   for (row = 0; row < FACE_ROWS; row++){
     col2 = (Index_t) ((0.5*dh/dw) - 0.5 + (row*dh/dw) + 0.499) ;
-    grid[idx_frcs(face,row,col,shell)].e.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].e.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].e.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].e.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].e.face  = face2;
+    cube[idx_frc(face,row,col)].e.row   = row2;
+    cube[idx_frc(face,row,col)].e.col   = col2;
+    cube[idx_frc(face,row,col)].e.rank   = mpi_rank;
   }
 
   for (col2 = 0; col2 < FACE_COLS; col2++){
     row = (Index_t) ((0.5*dw/dh) - 0.5 + (col2*dw/dh) + 0.499) ;
-    grid[idx_frcs(face2,row2,col2,shell)].s.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].s.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].s.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].s.rank   = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].s.face  = face;
+    cube[idx_frc(face2,row2,col2)].s.row   = row;
+    cube[idx_frc(face2,row2,col2)].s.col   = col;
+    cube[idx_frc(face2,row2,col2)].s.rank   = mpi_rank;
   }
 
   /*-- connect top/N of BOTTOM to bottom/S of LEFT --*/
@@ -319,15 +340,15 @@
   col2  = 0;                  /*-- col 0 => col +i =  -x direction. --*/
 
   for (i = 0; i < FACE_COLS; i++){
-    grid[idx_frcs(face,row,col,shell)].n.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].n.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].n.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].n.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].n.face  = face2;
+    cube[idx_frc(face,row,col)].n.row   = row2;
+    cube[idx_frc(face,row,col)].n.col   = col2;
+    cube[idx_frc(face,row,col)].n.rank   = mpi_rank;
 
-    grid[idx_frcs(face2,row2,col2,shell)].s.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].s.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].s.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].s.rank   = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].s.face  = face;
+    cube[idx_frc(face2,row2,col2)].s.row   = row;
+    cube[idx_frc(face2,row2,col2)].s.col   = col;
+    cube[idx_frc(face2,row2,col2)].s.rank   = mpi_rank;
 
     col++;   /*-- move -y direction for BOTTOM. --*/
     col2++;  /*-- move -y direction for LEFT. --*/
@@ -343,15 +364,15 @@
   col2  = FACE_COLS - 1;      /*-- col k => col k-i =  -x direction. --*/
 
   for (i = 0; i < FACE_COLS; i++){
-    grid[idx_frcs(face,row,col,shell)].s.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].s.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].s.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].s.rank  = mpi_rank;
+    cube[idx_frc(face,row,col)].s.face  = face2;
+    cube[idx_frc(face,row,col)].s.row   = row2;
+    cube[idx_frc(face,row,col)].s.col   = col2;
+    cube[idx_frc(face,row,col)].s.rank  = mpi_rank;
 
-    grid[idx_frcs(face2,row2,col2,shell)].s.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].s.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].s.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].s.rank  = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].s.face  = face;
+    cube[idx_frc(face2,row2,col2)].s.row   = row;
+    cube[idx_frc(face2,row2,col2)].s.col   = col;
+    cube[idx_frc(face2,row2,col2)].s.rank  = mpi_rank;
 
     col++;   /*-- move -y direction for BOTTOM. --*/
     col2--;  /*-- move -y direction for RIGHT. --*/
@@ -367,15 +388,15 @@
   col2  = 0;                  /*-- left of LEFT. --*/
 
   for (i = 0; i < FACE_ROWS; i++){
-    grid[idx_frcs(face,row,col,shell)].e.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].e.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].e.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].e.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].e.face  = face2;
+    cube[idx_frc(face,row,col)].e.row   = row2;
+    cube[idx_frc(face,row,col)].e.col   = col2;
+    cube[idx_frc(face,row,col)].e.rank   = mpi_rank;
 
-    grid[idx_frcs(face2,row2,col2,shell)].w.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].w.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].w.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].w.rank  = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].w.face  = face;
+    cube[idx_frc(face2,row2,col2)].w.row   = row;
+    cube[idx_frc(face2,row2,col2)].w.col   = col;
+    cube[idx_frc(face2,row2,col2)].w.rank  = mpi_rank;
 
     row++;   /*-- move -z direction for FRONT. --*/
     row2++;  /*-- move -z direction for LEFT. --*/
@@ -391,15 +412,15 @@
   col2  = 0;                  /*-- left. --*/
 
   for (i = 0; i < FACE_ROWS; i++){
-    grid[idx_frcs(face,row,col,shell)].e.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].e.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].e.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].e.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].e.face  = face2;
+    cube[idx_frc(face,row,col)].e.row   = row2;
+    cube[idx_frc(face,row,col)].e.col   = col2;
+    cube[idx_frc(face,row,col)].e.rank   = mpi_rank;
 
-    grid[idx_frcs(face2,row2,col2,shell)].w.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].w.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].w.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].w.rank   = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].w.face  = face;
+    cube[idx_frc(face2,row2,col2)].w.row   = row;
+    cube[idx_frc(face2,row2,col2)].w.col   = col;
+    cube[idx_frc(face2,row2,col2)].w.rank   = mpi_rank;
 
     row++;   /*-- move -z direction. --*/
     row2++;  /*-- move -z direction. --*/
@@ -415,15 +436,15 @@
   col2  = 0;                  /*-- left. --*/
 
   for (i = 0; i < FACE_ROWS; i++){
-    grid[idx_frcs(face,row,col,shell)].e.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].e.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].e.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].e.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].e.face  = face2;
+    cube[idx_frc(face,row,col)].e.row   = row2;
+    cube[idx_frc(face,row,col)].e.col   = col2;
+    cube[idx_frc(face,row,col)].e.rank   = mpi_rank;
 
-    grid[idx_frcs(face2,row2,col2,shell)].w.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].w.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].w.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].w.rank   = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].w.face  = face;
+    cube[idx_frc(face2,row2,col2)].w.row   = row;
+    cube[idx_frc(face2,row2,col2)].w.col   = col;
+    cube[idx_frc(face2,row2,col2)].w.rank   = mpi_rank;
 
     row++;   /*-- move -z direction. --*/
     row2++;  /*-- move -z direction. --*/
@@ -439,15 +460,15 @@
   col2  = 0;                  /*-- left. --*/
 
   for (i = 0; i < FACE_ROWS; i++){
-    grid[idx_frcs(face,row,col,shell)].e.face  = face2;
-    grid[idx_frcs(face,row,col,shell)].e.row   = row2;
-    grid[idx_frcs(face,row,col,shell)].e.col   = col2;
-    grid[idx_frcs(face,row,col,shell)].e.rank   = mpi_rank;
+    cube[idx_frc(face,row,col)].e.face  = face2;
+    cube[idx_frc(face,row,col)].e.row   = row2;
+    cube[idx_frc(face,row,col)].e.col   = col2;
+    cube[idx_frc(face,row,col)].e.rank   = mpi_rank;
 
-    grid[idx_frcs(face2,row2,col2,shell)].w.face  = face;
-    grid[idx_frcs(face2,row2,col2,shell)].w.row   = row;
-    grid[idx_frcs(face2,row2,col2,shell)].w.col   = col;
-    grid[idx_frcs(face2,row2,col2,shell)].w.rank   = mpi_rank;
+    cube[idx_frc(face2,row2,col2)].w.face  = face;
+    cube[idx_frc(face2,row2,col2)].w.row   = row;
+    cube[idx_frc(face2,row2,col2)].w.col   = col;
+    cube[idx_frc(face2,row2,col2)].w.rank   = mpi_rank;
 
     row++;   /*-- move -z direction. --*/
     row2++;  /*-- move -z direction. --*/
@@ -472,6 +493,8 @@
     for (row=0; row<FACE_ROWS; row++) {
       for (col=0; col<FACE_COLS; col++){
 
+        if (!LOCAL_NODE(face,row,col)) continue;
+
         neighbor = grid[idx_frcs(face,row,col,shell)].n;
         if ( ( ( neighbor.face >= NUM_FACES )
               ||   (neighbor.row >= FACE_ROWS))
@@ -569,9 +592,12 @@
 	    row++;                 /*-- move one row in -y direction. --*/
 	    y -= cellHeight;
     }
-    grid[idx_frcs(TOP_FACE,row,col,shell)].r.x = x;
-    grid[idx_frcs(TOP_FACE,row,col,shell)].r.y = y;
-    grid[idx_frcs(TOP_FACE,row,col,shell)].r.z = +0.5;
+    /*-- only the nodes stored on this rank (see NODE_SLOT) --*/
+    if (LOCAL_NODE(TOP_FACE,row,col)) {
+      grid[idx_frcs(TOP_FACE,row,col,shell)].r.x = x;
+      grid[idx_frcs(TOP_FACE,row,col,shell)].r.y = y;
+      grid[idx_frcs(TOP_FACE,row,col,shell)].r.z = +0.5;
+    }
 
     col++;                /*-- move in +x direction to next cell. --*/
     x += cellWidth;
@@ -601,9 +627,11 @@
 	    row++;                /*-- move one row in -y direction. --*/
 	    y -= cellHeight;
     }
-    grid[idx_frcs(BOTTOM_FACE,row,col,shell)].r.x = x;
-    grid[idx_frcs(BOTTOM_FACE,row,col,shell)].r.y = y;
-    grid[idx_frcs(BOTTOM_FACE,row,col,shell)].r.z = -0.5;
+    if (LOCAL_NODE(BOTTOM_FACE,row,col)) {
+      grid[idx_frcs(BOTTOM_FACE,row,col,shell)].r.x = x;
+      grid[idx_frcs(BOTTOM_FACE,row,col,shell)].r.y = y;
+      grid[idx_frcs(BOTTOM_FACE,row,col,shell)].r.z = -0.5;
+    }
 
     col++;                /*-- move in -x direction to next cell. --*/
     x -= cellWidth;
@@ -633,9 +661,11 @@
 	    row++;                 /*-- move one row in -z direction. --*/
 	    z -= cellHeight;
     }
-    grid[idx_frcs(FRONT_FACE,row,col,shell)].r.x = +0.5;
-    grid[idx_frcs(FRONT_FACE,row,col,shell)].r.y = y;
-    grid[idx_frcs(FRONT_FACE,row,col,shell)].r.z = z;
+    if (LOCAL_NODE(FRONT_FACE,row,col)) {
+      grid[idx_frcs(FRONT_FACE,row,col,shell)].r.x = +0.5;
+      grid[idx_frcs(FRONT_FACE,row,col,shell)].r.y = y;
+      grid[idx_frcs(FRONT_FACE,row,col,shell)].r.z = z;
+    }
 
     col++;                /*-- move in +y direction to next cell. --*/
     y += cellWidth;
@@ -665,9 +695,11 @@
 	    row++;                /*-- move one row in -z direction. --*/
 	    z -= cellHeight;
     }
-    grid[idx_frcs(BACK_FACE,row,col,shell)].r.x = -0.5;
-    grid[idx_frcs(BACK_FACE,row,col,shell)].r.y = y;
-    grid[idx_frcs(BACK_FACE,row,col,shell)].r.z = z;
+    if (LOCAL_NODE(BACK_FACE,row,col)) {
+      grid[idx_frcs(BACK_FACE,row,col,shell)].r.x = -0.5;
+      grid[idx_frcs(BACK_FACE,row,col,shell)].r.y = y;
+      grid[idx_frcs(BACK_FACE,row,col,shell)].r.z = z;
+    }
 
     col++;                /*-- move in -y direction to next cell. --*/
     y -= cellWidth;
@@ -697,9 +729,11 @@
 	    row++;                /*-- move one row in -z direction. --*/
 	    z -= cellHeight;
     }
-    grid[idx_frcs(RIGHT_FACE,row,col,shell)].r.x = x;
-    grid[idx_frcs(RIGHT_FACE,row,col,shell)].r.y = -0.5;
-    grid[idx_frcs(RIGHT_FACE,row,col,shell)].r.z = z;
+    if (LOCAL_NODE(RIGHT_FACE,row,col)) {
+      grid[idx_frcs(RIGHT_FACE,row,col,shell)].r.x = x;
+      grid[idx_frcs(RIGHT_FACE,row,col,shell)].r.y = -0.5;
+      grid[idx_frcs(RIGHT_FACE,row,col,shell)].r.z = z;
+    }
 
     col++;                /*-- move in +x direction to next cell. --*/
     x += cellWidth;
@@ -729,9 +763,11 @@
 	    row++;                /*-- move one row in -z direction. --*/
 	    z -= cellHeight;
     }
-    grid[idx_frcs(LEFT_FACE,row,col,shell)].r.x = x;
-    grid[idx_frcs(LEFT_FACE,row,col,shell)].r.y = +0.5;
-    grid[idx_frcs(LEFT_FACE,row,col,shell)].r.z = z;
+    if (LOCAL_NODE(LEFT_FACE,row,col)) {
+      grid[idx_frcs(LEFT_FACE,row,col,shell)].r.x = x;
+      grid[idx_frcs(LEFT_FACE,row,col,shell)].r.y = +0.5;
+      grid[idx_frcs(LEFT_FACE,row,col,shell)].r.z = z;
+    }
 
     col++;                /*-- move in -x direction to next cell. --*/
     x -= cellWidth;
@@ -776,6 +812,12 @@
       for (col  = 0; col  < FACE_COLS; col++ )
       {
 
+        // count runs over every node of the shell
+        if (!LOCAL_NODE(face,row,col)) {
+          count++;
+          continue;
+        }
+
         r = grid[idx_frcs(face,row,col,shell)].r;
         rmag  = sqrt( (r.x * r.x) + (r.y * r.y) + (r.z * r.z) );
         r.x   = r.x / rmag;
@@ -833,7 +875,7 @@
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 {
-  Index_t face, row, col, loopFlag, crossCount;
+  Index_t face, row, col, loopFlag, crossCount, totalCrossCount;
   Scalar_t dt;
   Vec_t r;
   Scalar_t  rmag;
@@ -864,6 +906,7 @@
   // set flag and counters
   loopFlag = 0;
   crossCount = 0;
+  totalCrossCount = 0;
   count = 0;
 
   // set the timestep
@@ -874,6 +917,15 @@
     for (row = 0; row < FACE_ROWS; row++) {
       for (col  = 0; col < FACE_COLS; col++) {
 
+        // nodes not stored here count as crossed already
+        nodeFlag[idx_frc(face,row,col)] = LOCAL_NODE(face,row,col) ? 0 : 1;
+        counter[idx_frc(face,row,col)] = 0;
+
+        if (!LOCAL_NODE(face,row,col)) {
+          count++;
+          continue;
+        }
+
         r = grid[idx_frcs(face,row,col,shell)].r;
         rmag  = sqrt( (r.x * r.x) + (r.y * r.y) + (r.z * r.z) );
         r.x   = r.x / rmag;
@@ -907,10 +959,6 @@
         originalNodePositions[idx_frc(face,row,col)].y = rmag * sin(zen) * sin(azi);
         originalNodePositions[idx_frc(face,row,col)].z = rmag * cos(zen);
 
-        // initialize nodeFlag
-        nodeFlag[idx_frc(face,row,col)] = 0;
-        counter[idx_frc(face,row,col)] = 0;
-
         count++;
 
       }
@@ -946,7 +994,9 @@
 
             } else {
 
-              crossCount += 1;
+              // halo nodes are counted by the face group owning them
+              if (nodeRole[idx_frc(face,row,col)] == NODE_OWNED)
+                crossCount += 1;
               nodeFlag[idx_frc(face,row,col)] = 1;
 
               node = grid[idx_frcs(face,row,col,shell)];
@@ -958,8 +1008,8 @@
               diff0 = vectorMag(vectorDifference(r, originalNodePositions[idx_frc(face,row,col)]));
 
               // display number of nodes crossed
-              if (mpi_rank == 0)
-                printf("Cross count: %i / %i  DistFromOrigPos: %16.8e\n", crossCount, FRC, diff0);
+              if (mpi_rank_world == 0)
+                printf("Cross count: %i / %i  DistFromOrigPos: %16.8e\n", crossCount, GROUP_NUM_STREAMS, diff0);
 
             }
 
@@ -969,10 +1019,14 @@
       }
     }
 
+    // every face group stops on the same step, so the halo nodes end
+    // up where their owners put them
+    MPI_Allreduce(&crossCount, &totalCrossCount, 1, MPI_INT, MPI_SUM, comm_face);
+
     // evaluate condition for completion
-    if ( (config.mhdInitFromOuterBoundary == 1) && (crossCount > 0) )
+    if ( (config.mhdInitFromOuterBoundary == 1) && (totalCrossCount > 0) )
         loopFlag = 1;
-    if ( (config.mhdInitFromOuterBoundary == 2) && (crossCount == FRC) )
+    if ( (config.mhdInitFromOuterBoundary == 2) && (totalCrossCount == FRC) )
         loopFlag = 1;
 
   } while (loopFlag == 0);
@@ -1050,7 +1104,7 @@
           // if new forward walk is closer than orginial, set it as the new footpoint and reset the search
           if (diffMin < diff0) {
 
-            if (mpi_rank == 0)
+            if (mpi_rank_world == 0)
               printf("Closer! Old:%0.6f\t New:%0.6f\n",diff0 * config.rScale, diffMin * config.rScale);
             diff0 = diffMin;
             nodePosition0[idx_frc(face,row,col)] = rWalkMin;
@@ -1064,7 +1118,7 @@
         }
 
         cnt += 1;
-        if (mpi_rank == 0)
+        if (mpi_rank_world == 0)
           printf("Walks Completed: %i\t %0.6f\n", cnt, diff0 / tol);
 
       }
@@ -1076,6 +1130,8 @@
     for (row = 0; row < FACE_ROWS; row++) {
       for (col = 0; col < FACE_COLS; col++) {
 
+        if (!LOCAL_NODE(face,row,col)) continue;
+
         r = nodePosition0[idx_frc(face,row,col)];
         rmag  = sqrt( (r.x * r.x) + (r.y * r.y) + (r.z * r.z) );
 
@@ -1134,6 +1190,8 @@
       for (col = 0; col < FACE_COLS; col++ )
       {
 
+        if (!LOCAL_NODE(face,row,col)) continue;
+
         neighborN = grid[idx_frcs(face,row,col,INNER_SHELL)].n;
         neighborE = grid[idx_frcs(face,row,col,INNER_SHELL)].e;
         neighborW = grid[idx_frcs(face,row,col,INNER_SHELL)].w;
@@ -1194,13 +1252,34 @@
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 {
-  Index_t face, row, col, shell;
+  Index_t shell;
+
+  for (shell = 0; shell < LOCAL_NUM_SHELLS; shell++)
+    setStreamNeighbors(shell);
+
+} /*------ END  initStreamNeighbors ( ) ---------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                /*---*/
+/*--*/    setStreamNeighbors( Index_t shell )                       /*---*/
+/*--*                                                                *---*/
+/*--* Set the stream links of every node in one shell. The links     *---*/
+/*--* only depend on the shell's position along the local stream,    *---*/
+/*--* so rippleShellsOut() calls this for the few shells whose       *---*/
+/*--* position changes meaning when the shell ring rotates.          *---*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+  Index_t face, row, col;
 
-  for (shell = 0; shell < LOCAL_NUM_SHELLS; shell++){
     for (face  = 0; face  < NUM_FACES;  face++ ){
       for (row   = 0; row   < FACE_ROWS;  row++  ){
         for (col   = 0; col   < FACE_COLS;  col++  ){
 
+          if (!LOCAL_NODE(face,row,col)) continue;
+
           grid[idx_frcs(face,row,col,shell)].streamIn.shell  = shell - 1;
           grid[idx_frcs(face,row,col,shell)].streamOut.shell = shell + 1;
           grid[idx_frcs(face,row,col,shell)].streamIn.face   = face;
@@ -1249,8 +1328,8 @@
             }
           }
 
-        }}}}
-} /*------ END  initStreamNeighbors ( ) ---------------------------------*/
+        }}}
+} /*------ END  setStreamNeighbors ( ) ----------------------------------*/
 /*-----------------------------------------------------------------------*/
 
 /*-----------------------------------------------------------------------*/
@@ -1272,6 +1351,8 @@
     for (row = 0; row < FACE_ROWS; row++) {
       for (col = 0; col < FACE_COLS; col++) {
 
+        if (!LOCAL_NODE(face,row,col)) continue;
+
         grid[idx_frcs(face,row,col,shell)].rOld.x = 0.0;
         grid[idx_frcs(face,row,col,shell)].rOld.y = 0.0;
         grid[idx_frcs(face,row,col,shell)].rOld.z = 0.0;
@@ -24,15 +24,17 @@
 #define CUBESHELLINIT_H
 
 #include "baseTypes.h"
+#include "cubeShellStruct.h"
 
 void gridStructInit( void ); /*-- Init. the grid.             --*/
-void initNEWS( Index_t shell ); /*-- Grid cells get NEWS links.  --*/
+void initNEWS( Node_t *cube, Index_t shell ); /*-- Grid cells get NEWS links.  --*/
 void checkNEWS( Index_t shell ); /*-- Grid cells check NEWS links.  --*/
 void initCubeCoords( Index_t shell ); /*-- Set unit-cube coords.       --*/
 void initSphereCoordsFromOuterBoundary( Index_t shell ); /*-- Set unit-cube coords.       --*/
 void initSphereCoords( Index_t shell ); /*-- Scale to unit sphere.       --*/
 void initCopyAll( void ); /*-- Copy inner shell to all.    --*/
 void initStreamNeighbors(void ); /*-- Set all stream links.       --*/
+void setStreamNeighbors( Index_t shell ); /*-- Set one shell's stream links. --*/
 void initInnerShellValues( void );      /*-- Initializing the values on the inner-most shell --*/
 
 #endif
@@ -34,6 +34,11 @@ MPI_Datatype NodeData_T;
 MPI_Datatype StreamData_T;
 MPI_Datatype ShellData_T;
 MPI_Datatype ShellLinks_T;
+MPI_Datatype StreamNode_T;
+MPI_Datatype StreamSeam_T;
+MPI_Datatype StreamNodes_T;
+MPI_Datatype StreamSeams_T;
+MPI_Datatype StreamEparts_T;
 
 /*---------------------------------------------------------------------*/
 /*---------------------------------------------------------------------*/
@@ -93,6 +98,15 @@ MPI_Datatype ShellLinks_T;
 /*---                                                               ---*/
 /*--- ShellLinks_T: all links in a single shell on a proc.          ---*/
 /*--- Usage: MPI_Send( & grid[0][0][0][shell], 1, ShellLinks_T...   ---*/
+/*---                                                               ---*/
+/*--- StreamNode_T: the few fields of a node the stream solvers     ---*/
+/*--- and the stream outputs read. StreamSeam_T: the fields the      ---*/
+/*--- stream solvers write back (see updateStreamValues). Both span  ---*/
+/*--- a whole Node_t, so streams are still arrays of Node_t.         ---*/
+/*---                                                               ---*/
+/*--- StreamNodes_T/StreamSeams_T/StreamEparts_T: the active part of ---*/
+/*--- a stream on a proc, following the shell ring (see             ---*/
+/*--- initMPI_streamRing).                                          ---*/
 /*---------------------------------------------------------------------*/
 /*---------------------------------------------------------------------*/
 {
@@ -106,6 +120,7 @@ MPI_Datatype ShellLinks_T;
   MPI_Aint     disps[MAX_FLDS]; /*-- memory offset to each type. --*/
   MPI_Aint     base;            /*-- memory address of Node_t.   --*/
   MPI_Aint     stride;
+  MPI_Datatype tmp_T;
   int          span;
   int          i;
   int          cnt;
@@ -252,6 +267,56 @@ MPI_Datatype ShellLinks_T;
   MPI_Type_commit( & Node_T );
   /*--------------- END Node_T ----------*/
 
+  /*--------------- StreamNode_T ----------*/
+  /*-- Only what crosses from the shells into a stream: position, --*/
+  /*-- |B| for the seam, and the MHD values of the stream outputs. --*/
+  for( i = 0; i < NUM_STREAM_FLDS; i++ ){ spans[i] = 1; }
+  MPI_Get_address( & grid[0]        ,  & base );
+  i = 0;
+  types[i] = Vec_T;
+  MPI_Get_address( & grid[0].r      , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].rmag   , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdDensity , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdBr , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdBphi , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdBtheta , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdBmag , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdVr , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdVtheta , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdVphi , & disps[i]); disps[i++] -= base;
+  /*-- Build datatype describing structure; stretch it over a whole --*/
+  /*-- Node_t so that counts of it step through arrays of Node_t.   --*/
+  MPI_Type_create_struct( NUM_STREAM_FLDS, spans, disps, types, & tmp_T );
+  MPI_Type_create_resized( tmp_T, 0, (MPI_Aint)sizeof(Node_t), & StreamNode_T );
+  MPI_Type_free( & tmp_T );
+  MPI_Type_commit( & StreamNode_T );
+  /*--------------- END StreamNode_T ----------*/
+
+  /*--------------- StreamSeam_T ----------*/
+  /*-- Only what crosses from a stream back into the shells.       --*/
+  for( i = 0; i < NUM_SEAM_FLDS; i++ ){ spans[i] = 1; }
+  i = 0;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].ds     , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdBmagPlus , & disps[i]); disps[i++] -= base;
+  types[i] = Scalar_T;
+  MPI_Get_address( & grid[0].mhdBmagMinus , & disps[i]); disps[i++] -= base;
+  MPI_Type_create_struct( NUM_SEAM_FLDS, spans, disps, types, & tmp_T );
+  MPI_Type_create_resized( tmp_T, 0, (MPI_Aint)sizeof(Node_t), & StreamSeam_T );
+  MPI_Type_free( & tmp_T );
+  MPI_Type_commit( & StreamSeam_T );
+  /*--------------- END StreamSeam_T ----------*/
+
 
   /*---------------  StreamData_T -----------------------*/
   /*-- Collective: all data in a per-proc streamline. ---*/
@@ -263,12 +328,12 @@ MPI_Datatype ShellLinks_T;
   /*-- Collective: all data/links in a shell. ------------------------*/
   /*-- Get base memory address of a Node_t.                         --*/
   MPI_Get_address( & grid[0]        ,  & base );
-  /*-- Get memory address of next Node_t in same shell.             --*/
-  MPI_Get_address( & grid[idx_frcs(0,0,1,0)]        ,  & stride );
+  /*-- Get memory address of next stored Node_t in same shell.      --*/
+  MPI_Get_address( & grid[LOCAL_NUM_SHELLS]        ,  & stride );
   /*-- Compute stride between nodes in same shell.                  --*/
   stride -= base;
-  /*-- Compute num nodes in a shell.                                --*/
-  cnt = NUM_FACES * FACE_ROWS * FACE_COLS;
+  /*-- Compute num nodes of a shell stored on this proc.            --*/
+  cnt = NUM_LOCAL_NODES;
   /*-- Set num nodes at each stride.                                --*/
   span = 1;
   /*-- Build datatype describing structure for data.                --*/
@@ -279,7 +344,76 @@ MPI_Datatype ShellLinks_T;
   MPI_Type_commit( & ShellLinks_T );
   /*------------ END ShellData_T and ShellLinks_t --------------------*/
 
+  /*---------------  StreamNodes_T and StreamEparts_T ----------------*/
+  StreamNodes_T  = MPI_DATATYPE_NULL;
+  StreamSeams_T  = MPI_DATATYPE_NULL;
+  StreamEparts_T = MPI_DATATYPE_NULL;
+  initMPI_streamRing();
+  /*------------ END StreamNodes_T and StreamEparts_T ----------------*/
+
 }
 /*--------END initMPI_cubeShellStruct(void)-----------------------*/
 /*----------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+/*---*/         void                                              /*---*/
+/*---*/   initMPI_streamRing(void)                                /*---*/
+/*---                                                               ---*/
+/*--- (Re)build the datatypes describing the active part of a       ---*/
+/*--- stream on a proc, i.e. shells INNER_ACTIVE_SHELL..OUTER_SHELL. ---*/
+/*--- The shells are stored as a ring (see RING_SHELL in global.h), ---*/
+/*--- so those ACTIVE_STREAM_SIZE nodes are contiguous up to the    ---*/
+/*--- end of the stream's storage and then wrap around to its start. ---*/
+/*--- The datatypes are relative to the INNER_ACTIVE_SHELL node and ---*/
+/*--- have the same type signature as ACTIVE_STREAM_SIZE            ---*/
+/*--- StreamNode_T (resp. StreamSeam_T, ACTIVE_STREAM_SIZE*SPEM      ---*/
+/*--- Scalar_T), so they match the contiguous streamGrid/ePartsStream ---*/
+/*--- buffers on the other side. Gathers into a stream use          ---*/
+/*--- StreamNodes_T, scatters back to the shells StreamSeams_T.      ---*/
+/*--- Must be called again whenever SHELL_OFFSET changes.           ---*/
+/*---                                                               ---*/
+/*--- Usage: MPI_Send( & grid[idx_frcs(f,r,c,INNER_ACTIVE_SHELL)],  ---*/
+/*---                  1, StreamNodes_T...                          ---*/
+/*---        MPI_Send( & eParts[idx_frcsspem(f,r,c,INNER_ACTIVE_SHELL,---*/
+/*---                  0,0,0)], 1, StreamEparts_T...                ---*/
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+{
+
+  int      spans[2];
+  MPI_Aint disps[2];
+  Index_t  first;
+
+  if (StreamNodes_T != MPI_DATATYPE_NULL)
+    MPI_Type_free( & StreamNodes_T );
+  if (StreamSeams_T != MPI_DATATYPE_NULL)
+    MPI_Type_free( & StreamSeams_T );
+  if (StreamEparts_T != MPI_DATATYPE_NULL)
+    MPI_Type_free( & StreamEparts_T );
+
+  /*-- Physical slot of INNER_ACTIVE_SHELL. The nodes up to the end --*/
+  /*-- of the stream come first, the rest wrap around to slot 0.    --*/
+  first    = RING_SHELL(INNER_ACTIVE_SHELL);
+  spans[0] = (int)(LOCAL_NUM_SHELLS - first);
+  if (spans[0] > ACTIVE_STREAM_SIZE) spans[0] = (int)ACTIVE_STREAM_SIZE;
+  spans[1] = (int)ACTIVE_STREAM_SIZE - spans[0];
+
+  disps[0] = 0;
+  disps[1] = -(MPI_Aint)first * (MPI_Aint)sizeof(Node_t);
+  MPI_Type_create_hindexed( 2, spans, disps, StreamNode_T, & StreamNodes_T );
+  MPI_Type_commit( & StreamNodes_T );
+
+  MPI_Type_create_hindexed( 2, spans, disps, StreamSeam_T, & StreamSeams_T );
+  MPI_Type_commit( & StreamSeams_T );
+
+  spans[0] *= (int)SPEM;
+  spans[1] *= (int)SPEM;
+  disps[1]  = -(MPI_Aint)first * (MPI_Aint)SPEM * (MPI_Aint)sizeof(Scalar_t);
+  MPI_Type_create_hindexed( 2, spans, disps, Scalar_T, & StreamEparts_T );
+  MPI_Type_commit( & StreamEparts_T );
+
+}
+/*--------END initMPI_streamRing(void)----------------------------*/
+/*----------------------------------------------------------------*/
 /*-- MPI equivalent types --*/
@@ -97,6 +97,10 @@ extern "C" {
 #define NUM_DATA_FLDS 29
   /*-- Number of neighbor link fields in  Node_t.  --*/
 #define NUM_LINK_FLDS 6
+  /*-- Number of Node_t fields in StreamNode_T.     --*/
+#define NUM_STREAM_FLDS 10
+  /*-- Number of Node_t fields in StreamSeam_T.     --*/
+#define NUM_SEAM_FLDS 3
   
   typedef Node_t *  NodePTR_t;
   
@@ -153,10 +157,18 @@ extern "C" {
   extern MPI_Datatype ShellData_T;
   extern MPI_Datatype ShellLinks_T;
   extern MPI_Datatype Node_T;
+  extern MPI_Datatype StreamNode_T;
+  extern MPI_Datatype StreamSeam_T;
+  extern MPI_Datatype StreamNodes_T;
+  extern MPI_Datatype StreamSeams_T;
+  extern MPI_Datatype StreamEparts_T;
   
   
   /*---*/         void                                              /*---*/
   /*---*/   initMPI_cubeShellStruct(void )                          /*---*/;
+
+  /*---*/         void                                              /*---*/
+  /*---*/   initMPI_streamRing(void )                               /*---*/;
   
 #ifdef __cplusplus
 }
@@ -25,6 +25,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <float.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "baseTypes.h"
 #include "global.h"
@@ -38,6 +41,7 @@
 #include "flow.h"
 #include "observerOutput.h"
 #include "timers.h"
+#include "workspace.h"
 
 Scalar_t *deltaShell;
 Scalar_t *shockDist;
@@ -48,6 +52,19 @@ Index_t *shockCalcFlag;
 
 Scalar_t dsMin;
 
+// Each thread scatters shell updates into its own NUM_LOCAL_NODES*NUM_MUSTEPS
+// slice of deltaShell.
+#ifdef _OPENMP
+#define DELTA_SHELL_SLICE (deltaShell + NUM_LOCAL_NODES*NUM_MUSTEPS*omp_get_thread_num())
+#else
+#define DELTA_SHELL_SLICE (deltaShell)
+#endif
+
+// DiffuseStreamData(): the level of the face between a cell of the
+// stream list and the next one is the finer of their levels.
+#define FACE_LEVEL(slist) \
+  ((level[(slist)] < level[(slist) + 1]) ? level[(slist)] : level[(slist) + 1])
+
 Index_t maxsubcycles_energychange = 0;
 Index_t maxsubcycles_focusing = 0;
 Index_t maxsubcycles_energychangeGlobal = 0;
@@ -55,6 +72,11 @@ Index_t maxsubcycles_focusingGlobal = 0;
 Scalar_t min_tau        = DBL_MAX;
 Scalar_t min_tau_global = DBL_MAX;
 
+// Nodes passed through the adiabatic change since the last report, and
+// how many of them were skipped as quiet (see nodeQuiet).
+Scalar_t nodes_energychange      = 0;
+Scalar_t quietnodes_energychange = 0;
+
 Scalar_t leaving_left = 0;
 Scalar_t leaving_right = 0;
 Scalar_t leaving_leftGlobal = 0;
@@ -82,6 +104,137 @@ Scalar_t leaving_rightGlobal = 0;
 /*------------------------------------------------------------------*/
 
 
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/             void                                         /*--*/
+/*--*/     initEnergeticParticlesWorkspace( void )              /*--*/
+/*--                                                              --*/
+/*-- Size and set up the per-thread workspaces (see workspace.h)  --*/
+/*-- that hold the scratch arrays of the EP solver, and take the  --*/
+/*-- shell-wide buffers of updateEnergeticParticles() from them   --*/
+/*-- once for the whole run.                                      --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  size_t tile, changeBytes, focusBytes, streamBytes, threadBytes;
+  size_t shellBytes, shockBytes, flagBytes;
+
+  // AdiabaticChange(): f, f1, vel, s1, v_avg, seed and work.
+  tile        = workspaceBytes(EP_TILE*SPEM, sizeof(Scalar_t));
+  changeBytes = 4*tile
+              + workspaceBytes(EP_TILE*NUM_SPECIES*(NUM_ESTEPS+1)*NUM_MUSTEPS,
+                               sizeof(Scalar_t))
+              + workspaceBytes(EP_TILE*NUM_SPECIES*2, sizeof(Scalar_t))
+              + workspaceBytes(EP_TILE*(NUM_SPECIES*(NUM_ESTEPS+1)*NUM_MUSTEPS
+                                        + 3*SPEM), sizeof(Scalar_t));
+
+  // AdiabaticFocusing(): f, f1, vel, s1, v_avg and work.
+  focusBytes  = 4*tile
+              + workspaceBytes(EP_TILE*NUM_SPECIES*NUM_ESTEPS*(NUM_MUSTEPS+1),
+                               sizeof(Scalar_t))
+              + workspaceBytes(EP_TILE*(NUM_SPECIES*NUM_ESTEPS*(NUM_MUSTEPS+1)
+                                        + 3*SPEM), sizeof(Scalar_t));
+
+  // DiffuseStreamData(): a stream list is never longer than shellList.
+  // With streamStepLevels, also the flux sums, the levels, the cells
+  // and faces sorted by level, and where each level starts.
+  streamBytes = 3*workspaceBytes(TOTAL_NUM_SHELLS*NUM_MUSTEPS, sizeof(Scalar_t))
+              + 4*workspaceBytes(TOTAL_NUM_SHELLS, sizeof(Scalar_t))
+              + workspaceBytes(3, sizeof(Scalar_t))
+              + workspaceBytes(NUM_MUSTEPS, sizeof(Scalar_t))
+              + 3*workspaceBytes(TOTAL_NUM_SHELLS, sizeof(Index_t))
+              + 2*workspaceBytes(config.streamStepLevels + 2, sizeof(Index_t));
+
+  threadBytes = changeBytes;
+  if (focusBytes  > threadBytes) threadBytes = focusBytes;
+  if (streamBytes > threadBytes) threadBytes = streamBytes;
+
+  shellBytes = workspaceBytes(NUM_LOCAL_NODES*NUM_MUSTEPS*N_THREADS, sizeof(Scalar_t));
+  shockBytes = workspaceBytes(NUM_LOCAL_NODES*MAX_LOCAL_NUM_SHELLS*SPEM, sizeof(Scalar_t));
+  flagBytes  = workspaceBytes(NUM_LOCAL_NODES*MAX_LOCAL_NUM_SHELLS*NUM_SPECIES, sizeof(Index_t));
+
+  initWorkspace(shellBytes + shockBytes + 2*flagBytes, threadBytes);
+
+  // These stay at the bottom of the master thread's workspace; the
+  // workspace starts out zeroed, as the flags expect.
+  deltaShell    = (Scalar_t *) workspaceAlloc(shellBytes);
+  shockDist     = (Scalar_t *) workspaceAlloc(shockBytes);
+  shockFlag     = (Index_t *)  workspaceAlloc(flagBytes);
+  shockCalcFlag = (Index_t *)  workspaceAlloc(flagBytes);
+
+}/*-------- END initEnergeticParticlesWorkspace() ------------------*/
+/*------------------------------------------------------------------*/
+
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static Index_t                                       /*--*/
+/*--*/     nodeEpSteps( Index_t shell,                          /*--*/
+/*--*/                  Index_t firstStream,                    /*--*/
+/*--*/                  Index_t numNodes,                       /*--*/
+/*--*/                  Index_t step,                           /*--*/
+/*--*/                  Scalar_t dt,                            /*--*/
+/*--*/                  Scalar_t *dtLane )                      /*--*/
+/*--                                                              --*/
+/*-- Set the time step focusing and adiabatic change take on each --*/
+/*-- node of a tile in EP step `step` of length dt. Every node     --*/
+/*-- takes dt, unless useNodeEpSteps is set: a node then steps     --*/
+/*-- once every m EP steps, m being as many as fit in its shortest --*/
+/*-- scattering time (at least 1, at most numEpSteps), and takes 0 --*/
+/*-- in between; its last step ends with the last EP step.         --*/
+/*-- Returns the number of nodes that take a step.                 --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  Index_t lane, species, energy, idx, face, row, col, m, numSteps;
+  Scalar_t tau, tauMin;
+
+  numSteps = 0;
+
+  for (lane = 0; lane < EP_TILE; lane++) {
+
+    dtLane[lane] = (lane < numNodes) ? dt : 0.0;
+
+    if ( (config.useNodeEpSteps == 0) || (lane >= numNodes) ) continue;
+
+    face = computeLines[firstStream+lane][0];
+    row  = computeLines[firstStream+lane][1];
+    col  = computeLines[firstStream+lane][2];
+    idx  = idx_frcs(face,row,col,shell);
+
+    tauMin = DBL_MAX;
+
+    for (species = 0; species < NUM_SPECIES; species++) {
+      for (energy = 0; energy < NUM_ESTEPS; energy++) {
+        tau = meanFreePath(species, energy, grid[idx].rmag*config.rScale)
+              /vgrid[energy];
+        if (tau < tauMin) tauMin = tau;
+      }
+    }
+
+    if (tauMin >= config.numEpSteps*dt)
+      m = config.numEpSteps;
+    else
+      m = (tauMin > dt) ? (Index_t) (tauMin/dt) : 1;
+
+    // Step at the end of every m EP steps, and at the last one, over
+    // the EP steps taken since the previous step.
+    if ( ((step + 1) % m == 0) || (step == config.numEpSteps - 1) )
+      dtLane[lane] = (step + 1 - (step/m)*m)*dt;
+    else
+      dtLane[lane] = 0.0;
+
+  }
+
+  for (lane = 0; lane < numNodes; lane++)
+    if (dtLane[lane] > 0.0) numSteps++;
+
+  return numSteps;
+
+}/*-------- END nodeEpSteps() --------------------------------------*/
+/*------------------------------------------------------------------*/
+
+
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 /*--*/             void                                         /*--*/
@@ -100,25 +253,20 @@ Scalar_t leaving_rightGlobal = 0;
   Index_t face, row, col, shell, innerComputeShell, step, idx;
   Time_t  t_global_saved;
   Scalar_t dt,tau;
-  Index_t computeIndex, numIters, iterIndex, species, energy;
-
-  // Each MPI rank computes numIters number of streams seqentially.
-  numIters = NUM_STREAMS / N_PROCS;
+  Index_t computeIndex, lastComputeIndex, numIters, iterIndex, species, energy;
+  Index_t subcycles, numNodes, lane, numQuiet, numActive;
+  Scalar_t dtLane[EP_TILE];
 
   double timer_tmp = 0;
+  double timer_shell = 0;
+  double timer_stream = 0;
+
+  // Hand out the streams by the cost measured in the last EP update.
+  if (config.useStreamScheduling > 0)
+    scheduleStreams();
 
-  /* Allocate temporary arrays used in several functions here */
-  deltaShell    = (Scalar_t*) malloc(sizeof(Scalar_t)*FRC*NUM_MUSTEPS);
-  shockDist     = (Scalar_t*) malloc(sizeof(Scalar_t)*NUM_FACES
-                                                  *FACE_ROWS*FACE_COLS
-                                         *LOCAL_NUM_SHELLS*NUM_SPECIES
-                                               *NUM_ESTEPS*NUM_MUSTEPS);
-  shockFlag     = (Index_t*)  calloc(NUM_FACES*FACE_ROWS*FACE_COLS
-                                     *LOCAL_NUM_SHELLS*NUM_SPECIES,
-                                     sizeof(Index_t));
-  shockCalcFlag = (Index_t*)  calloc(NUM_FACES*FACE_ROWS*FACE_COLS
-                                     *LOCAL_NUM_SHELLS*NUM_SPECIES,
-                                     sizeof(Index_t));
+  // Each MPI rank computes up to numIters streams seqentially.
+  numIters = STREAM_SCHEDULE_LENGTH;
 
   // Save global time (the time step update happens after this routine).
   t_global_saved = t_global;
@@ -130,12 +278,29 @@ Scalar_t leaving_rightGlobal = 0;
   for (step = 0; step < config.numEpSteps; step++ )
   {
 
+    // With useStreamTranspose, every stream of this rank is gathered
+    // in one exchange up front and scattered back in one after the loop.
+    // Otherwise the streams go through a pipeline: while one stream is
+    // computed, the gather of the next and the scatter of the previous
+    // one are in flight.
+    if (config.useStreamTranspose > 0)
+      update_streams_from_shells();
+    else if (numIters > 0)
+      start_stream_from_shells( 0 );
+
     // Requires entire stream on one process.  Sequential on the rank.
-    for (iterIndex = 0; iterIndex <= numIters; iterIndex++)
+    for (iterIndex = 0; iterIndex < numIters; iterIndex++)
     {
 
       // Gather up current stream from shells across all ranks.
-      update_stream_from_shells( iterIndex );
+      if (config.useStreamTranspose > 0) {
+        select_stream( iterIndex );
+      } else {
+        finish_stream_from_shells( iterIndex );
+        if (iterIndex + 1 < numIters) start_stream_from_shells( iterIndex + 1 );
+      }
+
+      timer_stream = MPI_Wtime();
 
       // Set stream values that require +/- nodes along the stream.
       // NOTE!  This sets imporant values used in focusing!
@@ -160,9 +325,20 @@ Scalar_t leaving_rightGlobal = 0;
                               + (MPI_Wtime() - timer_tmp);
       }
 
+      if (iterIndex < RANK_NUM_STREAMS(mpi_rank))
+        streamCost[WORK_INDEX(mpi_rank, iterIndex)] += MPI_Wtime() - timer_stream;
+
       // Scatter current stream to shells across all ranks.
-      update_shells_from_stream( iterIndex );
+      if (config.useStreamTranspose == 0)
+        start_shells_from_stream( iterIndex );
+
+    }
 
+    if (config.useStreamTranspose > 0) {
+      select_stream( -1 );
+      update_shells_from_streams();
+    } else {
+      finish_shells_from_stream();
     }
 
     // Make sure not to compute the inner shell on proc 0
@@ -173,62 +349,137 @@ Scalar_t leaving_rightGlobal = 0;
       innerComputeShell = INNER_ACTIVE_SHELL;
     }
 
+    // The nodes of a shell are independent in the focusing and change
+    // operators, so each stream loop below walks the shell in tiles of
+    // EP_TILE nodes (see AdiabaticFocusing()) and splits the tiles across
+    // N_THREADS.
+    // Focusing finishes on every node before change starts, which matches
+    // the per-node order of the serial loop. The min/max reductions do not
+    // depend on the order in which threads finish, so the diagnostics are
+    // the same for any thread count. Timers are read outside the parallel
+    // regions because MPI is only initialized with MPI_THREAD_FUNNELED.
+    // Only the nodes of this face group are computed (see nodeRole).
+    lastComputeIndex = FIRST_GROUP_STREAM + GROUP_NUM_STREAMS;
+
     for (shell = innerComputeShell; shell < LOCAL_NUM_SHELLS; shell++ )
     {
 
-      // computed on local process
-      for (computeIndex = 0; computeIndex < NUM_STREAMS; computeIndex++)
-      {
-
-        face = computeLines[computeIndex][0];
-        row  = computeLines[computeIndex][1];
-        col  = computeLines[computeIndex][2];
-        idx = idx_frcs(face,row,col,shell);
+      // Measured per shell, for rebalanceShells().
+      timer_shell = MPI_Wtime();
 //
-//     ****** Find minimum mean free path time scale.
+//    ****** Find minimum mean free path time scale.
+//    ****** ADIABATIC FOCUS ******
 //
-        for (species = 0; species < NUM_SPECIES; species++) {
-          for (energy = 0; energy < NUM_ESTEPS; energy++) {
-            tau = meanFreePath(species, energy,
-                  grid[idx_frcs(face,row,col,shell)].rmag*config.rScale)
-                  /vgrid[energy];
-            if (tau < min_tau){
-              min_tau = tau;
+      timer_tmp = MPI_Wtime();
+
+#ifdef _OPENMP
+      #pragma omp parallel for num_threads(N_THREADS) schedule(static) \
+                               private(face, row, col, idx, species, energy, tau, \
+                                       subcycles, numNodes, lane, dtLane) \
+                               reduction(min:min_tau) reduction(max:maxsubcycles_focusing)
+#endif
+      for (computeIndex = FIRST_GROUP_STREAM; computeIndex < lastComputeIndex; computeIndex += EP_TILE)
+      {
+
+        numNodes = (lastComputeIndex - computeIndex < EP_TILE) ?
+                   lastComputeIndex - computeIndex : EP_TILE;
+
+        for (lane = 0; lane < numNodes; lane++) {
+
+          face = computeLines[computeIndex+lane][0];
+          row  = computeLines[computeIndex+lane][1];
+          col  = computeLines[computeIndex+lane][2];
+          idx = idx_frcs(face,row,col,shell);
+
+          for (species = 0; species < NUM_SPECIES; species++) {
+            for (energy = 0; energy < NUM_ESTEPS; energy++) {
+              tau = meanFreePath(species, energy,
+                    grid[idx].rmag*config.rScale)
+                    /vgrid[energy];
+              if (tau < min_tau){
+                min_tau = tau;
+              }
             }
           }
+
         }
-//
-//      ****** ADIABATIC FOCUS ******
-//
-        if ( config.useAdiabaticFocus > 0 ){
 
-          timer_tmp = MPI_Wtime();
+        if ( config.useAdiabaticFocus > 0 ){
 
-          AdiabaticFocusing(face, row, col, shell, dt);
+          subcycles = nodeEpSteps(shell, computeIndex, numNodes, step, dt, dtLane) ?
+                      AdiabaticFocusing(shell, computeIndex, numNodes, dtLane) : 0;
 
-          timer_adiabaticfocus = timer_adiabaticfocus
-                                 + (MPI_Wtime() - timer_tmp);
+          if (subcycles > maxsubcycles_focusing){
+            maxsubcycles_focusing = subcycles;
+          }
 
         }
+
+      } // Stream index
+
+      if ( config.useAdiabaticFocus > 0 ){
+        timer_adiabaticfocus = timer_adiabaticfocus
+                               + (MPI_Wtime() - timer_tmp);
+      }
 //
-//      ****** ADIABATIC CHANGE ******
+//    ****** ADIABATIC CHANGE ******
 //
-        if ( config.useAdiabaticChange > 0 ) {
+      if ( config.useAdiabaticChange > 0 ) {
+
+        timer_tmp = MPI_Wtime();
+
+#ifdef _OPENMP
+        #pragma omp parallel for num_threads(N_THREADS) schedule(static) \
+                                 private(face, row, col, subcycles, numNodes, lane, \
+                                         numQuiet, numActive, dtLane) \
+                                 reduction(max:maxsubcycles_energychange) \
+                                 reduction(+:nodes_energychange, quietnodes_energychange)
+#endif
+        for (computeIndex = FIRST_GROUP_STREAM; computeIndex < lastComputeIndex; computeIndex += EP_TILE)
+        {
+
+          numNodes = (lastComputeIndex - computeIndex < EP_TILE) ?
+                     lastComputeIndex - computeIndex : EP_TILE;
+
+          // Skip tiles whose nodes all take no step now or are quiet;
+          // AdiabaticChange() leaves those nodes of the others alone.
+          numActive = nodeEpSteps(shell, computeIndex, numNodes, step, dt, dtLane);
+          numQuiet  = 0;
+
+          if (config.quietNodeTolerance > 0.0) {
+            for (lane = 0; lane < numNodes; lane++) {
+              if (dtLane[lane] == 0.0) continue;
+              face = computeLines[computeIndex+lane][0];
+              row  = computeLines[computeIndex+lane][1];
+              col  = computeLines[computeIndex+lane][2];
+              numQuiet += nodeQuiet[idx_frcs(face,row,col,shell)];
+            }
+          }
 
-          timer_tmp = MPI_Wtime();
+          nodes_energychange      += numActive;
+          quietnodes_energychange += numQuiet;
 
-          AdiabaticChange(face, row, col, shell, dt);
-          
-          timer_adiabaticchange = timer_adiabaticchange + (MPI_Wtime() - timer_tmp);
-          
-        } // adiabaticChange
+          if (numQuiet == numActive) continue;
+
+          subcycles = AdiabaticChange(shell, computeIndex, numNodes, dtLane);
+
+          if (subcycles > maxsubcycles_energychange){
+            maxsubcycles_energychange = subcycles;
+          }
+
+        } // Stream index
+
+        timer_adiabaticchange = timer_adiabaticchange + (MPI_Wtime() - timer_tmp);
+
+      } // adiabaticChange
 
-      } // Stream index
 //
 //    ****** DIFFUSE SHELL DATA ******
 //
       if ( config.useShellDiffusion > 0){
 
+        exchangeFaceGroupHalo( shell );
+
         timer_tmp = MPI_Wtime();
 
         DiffuseShellData( shell, dt );
@@ -241,6 +492,8 @@ Scalar_t leaving_rightGlobal = 0;
 //
       if (config.useDrift > 0){
 
+        exchangeFaceGroupHalo( shell );
+
         timer_tmp = MPI_Wtime();
 
         DriftShellData( shell, dt );
@@ -250,6 +503,8 @@ Scalar_t leaving_rightGlobal = 0;
 
       }
 
+      shellCost[shell] += MPI_Wtime() - timer_shell;
+
     }
 //
 //   ****** UPDATE EpSubcycle TIME ******
@@ -257,15 +512,13 @@ Scalar_t leaving_rightGlobal = 0;
     t_global += dt;
   }
 
-  // Free up temporary arrays.
-  free(deltaShell);
-  free(shockDist);
-  free(shockFlag);
-  free(shockCalcFlag);
-
   // Reset time since t_global is updated after this routine.
   t_global = t_global_saved;
 
+  // The stream outputs stay with the round-robin owners of the streams.
+  if (config.useStreamScheduling > 0)
+    roundRobinStreams();
+
 }/*-------- END updateEnergeticParticles() -------------------------*/
 /*------------------------------------------------------------------*/
 
@@ -343,6 +596,8 @@ Scalar_t leaving_rightGlobal = 0;
       for (row  = 0; row < FACE_ROWS; row++) {
         for (col  = 0;  col < FACE_COLS; col++) {
 
+          if (!LOCAL_NODE(face,row,col)) continue;
+
           node = grid[idx_frcs(face,row,col,shell)];
           n    = node.n;
           e    = node.e;
@@ -360,115 +615,124 @@ Scalar_t leaving_rightGlobal = 0;
           eb.z = node.mhdBvec.z / node.mhdBmag;
 
           /* North Neighbor */
-          node1 = grid[idx_frcs(n.face,n.row,n.col,n.shell)];
-          r1 = node1.r;
+          // a halo node may link to a node this rank does not store
+          if (LOCAL_NODE(n.face,n.row,n.col)) {
+            node1 = grid[idx_frcs(n.face,n.row,n.col,shell)];
+            r1 = node1.r;
 
-          r1.x *= config.rScale;
-          r1.y *= config.rScale;
-          r1.z *= config.rScale;
+            r1.x *= config.rScale;
+            r1.y *= config.rScale;
+            r1.z *= config.rScale;
 
-          en.x = r1.x - r.x;
-          en.y = r1.y - r.y;
-          en.z = r1.z - r.z;
+            en.x = r1.x - r.x;
+            en.y = r1.y - r.y;
+            en.z = r1.z - r.z;
 
-          dl = sqrt(en.x*en.x + en.y*en.y + en.z*en.z);
-          grid[idx_frcs(face,row,col,shell)].n.dl = dl;
+            dl = sqrt(en.x*en.x + en.y*en.y + en.z*en.z);
+            grid[idx_frcs(face,row,col,shell)].n.dl = dl;
 
-          en.x /= dl;
-          en.y /= dl;
-          en.z /= dl;
+            en.x /= dl;
+            en.y /= dl;
+            en.z /= dl;
 
-          dot = en.x*eb.x + en.y*eb.y + en.z*eb.z;
+            dot = en.x*eb.x + en.y*eb.y + en.z*eb.z;
 
-          grid[idx_frcs(face,row,col,shell)].n.dlPer =
-          dl * sqrt( 1.0 - dot * dot );
+            grid[idx_frcs(face,row,col,shell)].n.dlPer =
+            dl * sqrt( 1.0 - dot * dot );
 
 
-          if (grid[idx_frcs(face,row,col,shell)].n.dlPer < dlPerMin[shell]) {
-            dlPerMin[shell] = grid[idx_frcs(face,row,col,shell)].n.dlPer;
+            if (grid[idx_frcs(face,row,col,shell)].n.dlPer < dlPerMin[shell]) {
+              dlPerMin[shell] = grid[idx_frcs(face,row,col,shell)].n.dlPer;
+            }
           }
 
           /* South neighbor */
-          node1 = grid[idx_frcs(s.face,s.row,s.col,s.shell)];
-          r1 = node1.r;
+          if (LOCAL_NODE(s.face,s.row,s.col)) {
+            node1 = grid[idx_frcs(s.face,s.row,s.col,shell)];
+            r1 = node1.r;
 
-          r1.x *= config.rScale;
-          r1.y *= config.rScale;
-          r1.z *= config.rScale;
+            r1.x *= config.rScale;
+            r1.y *= config.rScale;
+            r1.z *= config.rScale;
 
-          en.x = r1.x - r.x;
-          en.y = r1.y - r.y;
-          en.z = r1.z - r.z;
+            en.x = r1.x - r.x;
+            en.y = r1.y - r.y;
+            en.z = r1.z - r.z;
 
-          dl = sqrt(en.x*en.x + en.y*en.y + en.z*en.z);
-          grid[idx_frcs(face,row,col,shell)].s.dl = dl;
+            dl = sqrt(en.x*en.x + en.y*en.y + en.z*en.z);
+            grid[idx_frcs(face,row,col,shell)].s.dl = dl;
 
-          en.x /= dl;
-          en.y /= dl;
-          en.z /= dl;
+            en.x /= dl;
+            en.y /= dl;
+            en.z /= dl;
 
-          dot = en.x*eb.x + en.y*eb.y + en.z*eb.z;
+            dot = en.x*eb.x + en.y*eb.y + en.z*eb.z;
 
-          grid[idx_frcs(face,row,col,shell)].s.dlPer =
-          dl * sqrt( 1.0 - dot * dot );
+            grid[idx_frcs(face,row,col,shell)].s.dlPer =
+            dl * sqrt( 1.0 - dot * dot );
 
-          if (grid[idx_frcs(face,row,col,shell)].s.dlPer  < dlPerMin[shell]) {
-            dlPerMin[shell] = grid[idx_frcs(face,row,col,shell)].s.dlPer;
+            if (grid[idx_frcs(face,row,col,shell)].s.dlPer  < dlPerMin[shell]) {
+              dlPerMin[shell] = grid[idx_frcs(face,row,col,shell)].s.dlPer;
+            }
           }
 
           /* E Neighbor */
-          node1 = grid[idx_frcs(e.face,e.row,e.col,e.shell)];
-          r1 = node1.r;
+          if (LOCAL_NODE(e.face,e.row,e.col)) {
+            node1 = grid[idx_frcs(e.face,e.row,e.col,shell)];
+            r1 = node1.r;
 
-          r1.x *= config.rScale;
-          r1.y *= config.rScale;
-          r1.z *= config.rScale;
+            r1.x *= config.rScale;
+            r1.y *= config.rScale;
+            r1.z *= config.rScale;
 
-          en.x = r1.x - r.x;
-          en.y = r1.y - r.y;
-          en.z = r1.z - r.z;
+            en.x = r1.x - r.x;
+            en.y = r1.y - r.y;
+            en.z = r1.z - r.z;
 
-          dl = sqrt(en.x*en.x + en.y*en.y + en.z*en.z);
-          grid[idx_frcs(face,row,col,shell)].e.dl = dl;
+            dl = sqrt(en.x*en.x + en.y*en.y + en.z*en.z);
+            grid[idx_frcs(face,row,col,shell)].e.dl = dl;
 
-          en.x /= dl;
-          en.y /= dl;
-          en.z /= dl;
+            en.x /= dl;
+            en.y /= dl;
+            en.z /= dl;
 
-          dot = en.x*eb.x + en.y*eb.y + en.z*eb.z;
+            dot = en.x*eb.x + en.y*eb.y + en.z*eb.z;
 
-          grid[idx_frcs(face,row,col,shell)].e.dlPer =
-          dl * sqrt( 1.0 - dot * dot );
+            grid[idx_frcs(face,row,col,shell)].e.dlPer =
+            dl * sqrt( 1.0 - dot * dot );
 
-          if (grid[idx_frcs(face,row,col,shell)].e.dlPer  < dlPerMin[shell]) {
-            dlPerMin[shell] = grid[idx_frcs(face,row,col,shell)].e.dlPer;
+            if (grid[idx_frcs(face,row,col,shell)].e.dlPer  < dlPerMin[shell]) {
+              dlPerMin[shell] = grid[idx_frcs(face,row,col,shell)].e.dlPer;
+            }
           }
 
           /* W Neighbor */
-          node1 = grid[idx_frcs(w.face,w.row,w.col,w.shell)];
-          r1 = node1.r;
+          if (LOCAL_NODE(w.face,w.row,w.col)) {
+            node1 = grid[idx_frcs(w.face,w.row,w.col,shell)];
+            r1 = node1.r;
 
-          r1.x *= config.rScale;
-          r1.y *= config.rScale;
-          r1.z *= config.rScale;
+            r1.x *= config.rScale;
+            r1.y *= config.rScale;
+            r1.z *= config.rScale;
 
-          en.x = r1.x - r.x;
-          en.y = r1.y - r.y;
-          en.z = r1.z - r.z;
+            en.x = r1.x - r.x;
+            en.y = r1.y - r.y;
+            en.z = r1.z - r.z;
 
-          dl = sqrt(en.x*en.x + en.y*en.y + en.z*en.z);
-          grid[idx_frcs(face,row,col,shell)].w.dl = dl;
+            dl = sqrt(en.x*en.x + en.y*en.y + en.z*en.z);
+            grid[idx_frcs(face,row,col,shell)].w.dl = dl;
 
-          en.x /= dl;
-          en.y /= dl;
-          en.z /= dl;
+            en.x /= dl;
+            en.y /= dl;
+            en.z /= dl;
 
-          dot = en.x*eb.x + en.y*eb.y + en.z*eb.z;
+            dot = en.x*eb.x + en.y*eb.y + en.z*eb.z;
 
-          grid[idx_frcs(face,row,col,shell)].w.dlPer = dl * sqrt( 1.0 - dot * dot );
+            grid[idx_frcs(face,row,col,shell)].w.dlPer = dl * sqrt( 1.0 - dot * dot );
 
-          if (grid[idx_frcs(face,row,col,shell)].w.dlPer  < dlPerMin[shell]) {
-            dlPerMin[shell] = grid[idx_frcs(face,row,col,shell)].w.dlPer;
+            if (grid[idx_frcs(face,row,col,shell)].w.dlPer  < dlPerMin[shell]) {
+              dlPerMin[shell] = grid[idx_frcs(face,row,col,shell)].w.dlPer;
+            }
           }
 
         }
@@ -493,20 +757,27 @@ Scalar_t leaving_rightGlobal = 0;
 
   Index_t face, row, col, species, energy, mu;
 
-  Scalar_t* mfp;
+  Scalar_t *delta;
 
-  Scalar_t dt_kper, delN, delE, delW, delS;
+  Scalar_t mfp, dt_kper, delN, delE, delW, delS;
 
   Node_t node;
 
-  mfp = (Scalar_t*)malloc(NUM_FACES*FACE_ROWS*FACE_COLS*sizeof(Scalar_t));
-
+  // Each (species, energy) slice only updates its own eParts entries, so
+  // the slices are split across threads, each with its own deltaShell.
+#ifdef _OPENMP
+  #pragma omp parallel for collapse(2) num_threads(N_THREADS) schedule(static) \
+                           private(face, row, col, mu, delta, node, \
+                                   mfp, dt_kper, delN, delE, delW, delS)
+#endif
   for (species = 0; species < NUM_SPECIES; species++)
   {
     for (energy = 0; energy < NUM_ESTEPS; energy++)
     {
 
-      // set mfp and zero out deltaShell
+      delta = DELTA_SHELL_SLICE;
+
+      // zero out deltaShell
       for (face = 0; face < NUM_FACES; face++)
       {
         for (row = 0; row < FACE_ROWS; row++)
@@ -514,14 +785,11 @@ Scalar_t leaving_rightGlobal = 0;
           for (col = 0; col < FACE_COLS; col++)
           {
 
-            mfp[idx_frc(face,row,col)] = 0.0;
+            if (!LOCAL_NODE(face,row,col))
+              continue;
 
             for (mu = 0; mu < NUM_MUSTEPS; mu++)
-              deltaShell[idx_frcm(face,row,col,mu)] = 0.0;
-
-            mfp[idx_frc(face,row,col)] =
-               meanFreePath(species, energy,
-               grid[idx_frcs(face,row,col,shell)].rmag * config.rScale);
+              delta[idx_frcm(face,row,col,mu)] = 0.0;
 
           }
 
@@ -539,9 +807,16 @@ Scalar_t leaving_rightGlobal = 0;
           for (col = 0; col < FACE_COLS; col++ )
           {
 
+            // Remote nodes feed no node of this face group and are not
+            // stored on this rank.
+            if (!LOCAL_NODE(face,row,col))
+              continue;
+
             node = grid[idx_frcs(face,row,col,shell)];
 
-            dt_kper = dt * 0.33333333 * mfp[idx_frc(face,row,col)]
+            mfp = meanFreePath(species, energy, node.rmag * config.rScale);
+
+            dt_kper = dt * 0.33333333 * mfp
               * vgrid[energy] * config.kperxkpar;
 
             delN = dt_kper / (node.n.dlPer * node.n.dlPer + SMALLFLOAT);
@@ -563,19 +838,23 @@ Scalar_t leaving_rightGlobal = 0;
             for (mu = 0; mu < NUM_MUSTEPS; mu++)
             {
 
-              deltaShell[idx_frcm(node.n.face,node.n.row,node.n.col,mu)]
-              += delN * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+              if (LOCAL_NODE(node.n.face,node.n.row,node.n.col))
+                delta[idx_frcm(node.n.face,node.n.row,node.n.col,mu)]
+                += delN * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-              deltaShell[idx_frcm(node.e.face,node.e.row,node.e.col,mu)]
-              += delE * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+              if (LOCAL_NODE(node.e.face,node.e.row,node.e.col))
+                delta[idx_frcm(node.e.face,node.e.row,node.e.col,mu)]
+                += delE * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-              deltaShell[idx_frcm(node.w.face,node.w.row,node.w.col,mu)]
-              += delW * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+              if (LOCAL_NODE(node.w.face,node.w.row,node.w.col))
+                delta[idx_frcm(node.w.face,node.w.row,node.w.col,mu)]
+                += delW * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-              deltaShell[idx_frcm(node.s.face,node.s.row,node.s.col,mu)]
-              += delS * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+              if (LOCAL_NODE(node.s.face,node.s.row,node.s.col))
+                delta[idx_frcm(node.s.face,node.s.row,node.s.col,mu)]
+                += delS * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-              deltaShell[idx_frcm(face,row,col,mu)]
+              delta[idx_frcm(face,row,col,mu)]
               -= (delN+delE+delW+delS) * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
             }
@@ -590,10 +869,15 @@ Scalar_t leaving_rightGlobal = 0;
       for (face = 0; face < NUM_FACES; face++){
         for (row= 0; row < FACE_ROWS; row++){
           for (col = 0; col < FACE_COLS; col++){
+
+            // Halo nodes are updated by the face group owning them.
+            if (nodeRole[idx_frc(face,row,col)] != NODE_OWNED)
+              continue;
+
             for (mu = 0; mu < NUM_MUSTEPS; mu++){
 
               eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)]
-                               += deltaShell[idx_frcm(face,row,col,mu)];
+                               += delta[idx_frcm(face,row,col,mu)];
 
               // check for NaN and Inf
               // check for NaN and Inf
@@ -613,8 +897,6 @@ Scalar_t leaving_rightGlobal = 0;
 
   }
 
-  free(mfp);
-
 }
 /*--------- END DiffuseShellData()    ------------------------------*/
 /*------------------------------------------------------------------*/
@@ -640,22 +922,35 @@ Scalar_t leaving_rightGlobal = 0;
 
   Scalar_t vdp, del;
 
+  Scalar_t *delta;
 
+  // Same threading as DiffuseShellData().
+#ifdef _OPENMP
+  #pragma omp parallel for collapse(2) num_threads(N_THREADS) schedule(static) \
+                           private(face, row, col, mu, delta, node, node1, \
+                                   n, e, w, s, rv, rv1, en, vd, vdp, del)
+#endif
   for (species = 0; species < NUM_SPECIES; species++)
   {
     for (energy = 0; energy < NUM_ESTEPS; energy++)
     {
 
+      delta = DELTA_SHELL_SLICE;
+
       for (face = 0; face < NUM_FACES; face++ )
       {
         for (row = 0; row < FACE_ROWS; row++ )
         {
           for (col = 0; col < FACE_COLS; col++ )
           {
+
+            if (!LOCAL_NODE(face,row,col))
+              continue;
+
             for (mu = 0; mu < NUM_MUSTEPS; mu++ )
             {
 
-              deltaShell[idx_frcm(face,row,col,mu)] = 0.0;
+              delta[idx_frcm(face,row,col,mu)] = 0.0;
 
             }
           }
@@ -669,6 +964,10 @@ Scalar_t leaving_rightGlobal = 0;
           for (col = 0; col < FACE_COLS; col++ )
           {
 
+            // As in DiffuseShellData().
+            if (!LOCAL_NODE(face,row,col))
+              continue;
+
             node = grid[idx_frcs(face,row,col,shell)];
 
             n    = node.n;
@@ -682,146 +981,159 @@ Scalar_t leaving_rightGlobal = 0;
 
             /* N move */
 
-            node1 = grid[idx_frcs(n.face,n.row,n.col,n.shell)];
-            rv1 = node1.r;
+            // a halo node may link to a node this rank does not store
+            if (LOCAL_NODE(n.face,n.row,n.col))
+            {
+              node1 = grid[idx_frcs(n.face,n.row,n.col,shell)];
+              rv1 = node1.r;
 
-            en.x = rv1.x - rv.x;
-            en.y = rv1.y - rv.y;
-            en.z = rv1.z - rv.z;
+              en.x = rv1.x - rv.x;
+              en.y = rv1.y - rv.y;
+              en.z = rv1.z - rv.z;
 
-            vdp = (vd.x * en.x + vd.y * en.y + vd.z * en.z ) * config.rScale / node.n.dl;
+              vdp = (vd.x * en.x + vd.y * en.y + vd.z * en.z ) * config.rScale / node.n.dl;
 
-            if (vdp > 0.0)
-            {
+              if (vdp > 0.0)
+              {
 
-              del = vdp * dt /  node.n.dl  ;
+                del = vdp * dt /  node.n.dl  ;
 
-              if (del > THRESH)
-                del = THRESH;
+                if (del > THRESH)
+                  del = THRESH;
 
-              //vd.x -= vdp * en.x / node.n.dl;
-              //vd.y -= vdp * en.y / node.n.dl;
-              //vd.z -= vdp * en.z / node.n.dl;
+                //vd.x -= vdp * en.x / node.n.dl;
+                //vd.y -= vdp * en.y / node.n.dl;
+                //vd.z -= vdp * en.z / node.n.dl;
 
-              for (mu = 0; mu < NUM_MUSTEPS; mu++)
-              {
+                for (mu = 0; mu < NUM_MUSTEPS; mu++)
+                {
 
-                deltaShell[idx_frcm(node.n.face,node.n.row,node.n.col,mu)]
-                  += del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+                  delta[idx_frcm(node.n.face,node.n.row,node.n.col,mu)]
+                    += del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-                deltaShell[idx_frcm(face,row,col,mu)]
-                  -= del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+                  delta[idx_frcm(face,row,col,mu)]
+                    -= del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-              }
+                }
 
+              }
             }
 
             /* E move */
 
-            node1 = grid[idx_frcs(e.face,e.row,e.col,e.shell)];
-            rv1 = node1.r;
+            if (LOCAL_NODE(e.face,e.row,e.col))
+            {
+              node1 = grid[idx_frcs(e.face,e.row,e.col,shell)];
+              rv1 = node1.r;
 
-            en.x = rv1.x - rv.x;
-            en.y = rv1.y - rv.y;
-            en.z = rv1.z - rv.z;
+              en.x = rv1.x - rv.x;
+              en.y = rv1.y - rv.y;
+              en.z = rv1.z - rv.z;
 
-            vdp = (vd.x * en.x + vd.y * en.y + vd.z * en.z ) * config.rScale / node.e.dl;
+              vdp = (vd.x * en.x + vd.y * en.y + vd.z * en.z ) * config.rScale / node.e.dl;
 
-            if (vdp > 0.0)
-            {
+              if (vdp > 0.0)
+              {
 
-              del = vdp * dt /  node.e.dl  ;
+                del = vdp * dt /  node.e.dl  ;
 
-              if (del > THRESH)
-                del = THRESH;
+                if (del > THRESH)
+                  del = THRESH;
 
-              //vd.x -= vdp * en.x / node.e.dl;
-              //vd.y -= vdp * en.y / node.e.dl;
-              //vd.z -= vdp * en.z / node.e.dl;
+                //vd.x -= vdp * en.x / node.e.dl;
+                //vd.y -= vdp * en.y / node.e.dl;
+                //vd.z -= vdp * en.z / node.e.dl;
 
-              for (mu = 0; mu<NUM_MUSTEPS; mu++)
-              {
+                for (mu = 0; mu<NUM_MUSTEPS; mu++)
+                {
 
-                deltaShell[idx_frcm(node.e.face,node.e.row,node.e.col,mu)]
-                  += del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+                  delta[idx_frcm(node.e.face,node.e.row,node.e.col,mu)]
+                    += del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-                deltaShell[idx_frcm(face,row,col,mu)]
-                  -= del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+                  delta[idx_frcm(face,row,col,mu)]
+                    -= del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-              }
+                }
 
+              }
             }
 
             /* W diffuse */
 
-            node1 = grid[idx_frcs(w.face,w.row,w.col,w.shell)];
-            rv1 = node1.r;
+            if (LOCAL_NODE(w.face,w.row,w.col))
+            {
+              node1 = grid[idx_frcs(w.face,w.row,w.col,shell)];
+              rv1 = node1.r;
 
-            en.x = rv1.x - rv.x;
-            en.y = rv1.y - rv.y;
-            en.z = rv1.z - rv.z;
+              en.x = rv1.x - rv.x;
+              en.y = rv1.y - rv.y;
+              en.z = rv1.z - rv.z;
 
-            vdp = (vd.x * en.x + vd.y * en.y + vd.z * en.z ) * config.rScale / node.w.dl;
+              vdp = (vd.x * en.x + vd.y * en.y + vd.z * en.z ) * config.rScale / node.w.dl;
 
-            if (vdp > 0.0)
-            {
+              if (vdp > 0.0)
+              {
 
-              del = vdp * dt /  node.w.dl ;
+                del = vdp * dt /  node.w.dl ;
 
-              if (del > THRESH)
-                del = THRESH;
+                if (del > THRESH)
+                  del = THRESH;
 
-              //vd.x -= vdp * en.x / node.w.dl;
-              //vd.y -= vdp * en.y / node.w.dl;
-              //vd.z -= vdp * en.z / node.w.dl;
+                //vd.x -= vdp * en.x / node.w.dl;
+                //vd.y -= vdp * en.y / node.w.dl;
+                //vd.z -= vdp * en.z / node.w.dl;
 
-              for (mu = 0; mu<NUM_MUSTEPS; mu++)
-              {
+                for (mu = 0; mu<NUM_MUSTEPS; mu++)
+                {
 
-                deltaShell[idx_frcm(node.w.face,node.w.row,node.w.col,mu)]
-                  += del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+                  delta[idx_frcm(node.w.face,node.w.row,node.w.col,mu)]
+                    += del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-                deltaShell[idx_frcm(face,row,col,mu)]
-                  -= del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+                  delta[idx_frcm(face,row,col,mu)]
+                    -= del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-              }
+                }
 
+              }
             }
 
             /* S diffuse */
 
-            node1 = grid[idx_frcs(s.face,s.row,s.col,s.shell)];
-            rv1 = node1.r;
+            if (LOCAL_NODE(s.face,s.row,s.col))
+            {
+              node1 = grid[idx_frcs(s.face,s.row,s.col,shell)];
+              rv1 = node1.r;
 
-            en.x = rv1.x - rv.x;
-            en.y = rv1.y - rv.y;
-            en.z = rv1.z - rv.z;
+              en.x = rv1.x - rv.x;
+              en.y = rv1.y - rv.y;
+              en.z = rv1.z - rv.z;
 
-            vdp = (vd.x * en.x + vd.y * en.y + vd.z * en.z ) * config.rScale  / node.s.dl;
+              vdp = (vd.x * en.x + vd.y * en.y + vd.z * en.z ) * config.rScale  / node.s.dl;
 
-            if (vdp > 0.0)
-            {
+              if (vdp > 0.0)
+              {
 
-              del = vdp * dt /  node.s.dl ;
+                del = vdp * dt /  node.s.dl ;
 
-              if (del > THRESH)
-                del = THRESH;
+                if (del > THRESH)
+                  del = THRESH;
 
-              //vd.x -= vdp*en.x/node.s.dl;
-              //vd.y -= vdp*en.y/node.s.dl;
-              //vd.z -= vdp*en.z/node.s.dl;
+                //vd.x -= vdp*en.x/node.s.dl;
+                //vd.y -= vdp*en.y/node.s.dl;
+                //vd.z -= vdp*en.z/node.s.dl;
 
-              for (mu = 0; mu<NUM_MUSTEPS; mu++)
-              {
+                for (mu = 0; mu<NUM_MUSTEPS; mu++)
+                {
 
-                deltaShell[idx_frcm(node.s.face,node.s.row,node.s.col,mu)]
-                  += del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+                  delta[idx_frcm(node.s.face,node.s.row,node.s.col,mu)]
+                    += del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-                deltaShell[idx_frcm(face,row,col,mu)]
-                  -= del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
+                  delta[idx_frcm(face,row,col,mu)]
+                    -= del * eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
 
-              }
+                }
 
+              }
             }
 
 
@@ -838,11 +1150,15 @@ Scalar_t leaving_rightGlobal = 0;
         {
           for (col = 0; col < FACE_COLS; col++ )
           {
+
+            if (nodeRole[idx_frc(face,row,col)] != NODE_OWNED)
+              continue;
+
             for (mu = 0; mu < NUM_MUSTEPS; mu++)
             {
 
               eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)]
-                += deltaShell[idx_frcm(face,row,col,mu)];
+                += delta[idx_frcm(face,row,col,mu)];
 
               // check for NaN and Inf
               checkNaN(mpi_rank, face, row, col, shell,
@@ -866,14 +1182,53 @@ Scalar_t leaving_rightGlobal = 0;
 
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
-/*--*/             void                                         /*--*/
-/*--*/     AdiabaticChange(  Index_t face,                      /*--*/
-/*--*/                       Index_t row,                       /*--*/
-/*--*/                       Index_t col,                       /*--*/
-/*--*/                       Index_t shell,                     /*--*/
-/*--*/                       Scalar_t dt )                      /*--*/
+/*--*/     static void                                          /*--*/
+/*--*/     gatherNodeTile( Index_t shell,                       /*--*/
+/*--*/                     Index_t firstStream,                 /*--*/
+/*--*/                     Index_t numNodes,                    /*--*/
+/*--*/                     Index_t *gridIdx,                    /*--*/
+/*--*/                     Index_t *ePartsIdx )                 /*--*/
+/*--                                                              --*/
+/*-- Locate the grid and eParts entries of the nodes on           --*/
+/*-- computeLines[firstStream ... firstStream+numNodes-1] of a    --*/
+/*-- shell. Lanes past numNodes repeat the last node so that every --*/
+/*-- lane of a tile holds valid data; they are never written back. --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  Index_t lane, computeIndex, face, row, col;
+
+  for (lane = 0; lane < EP_TILE; lane++) {
+
+    computeIndex = firstStream + ((lane < numNodes) ? lane : numNodes - 1);
+
+    face = computeLines[computeIndex][0];
+    row  = computeLines[computeIndex][1];
+    col  = computeLines[computeIndex][2];
+
+    gridIdx[lane]   = idx_frcs(face,row,col,shell);
+    ePartsIdx[lane] = idx_frcsspem(face,row,col,shell,0,0,0);
+
+  }
+
+}/*-------- END gatherNodeTile() -----------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/             Index_t                                      /*--*/
+/*--*/     AdiabaticChange(  Index_t shell,                     /*--*/
+/*--*/                       Index_t firstStream,               /*--*/
+/*--*/                       Index_t numNodes,                  /*--*/
+/*--*/                       const Scalar_t *dt )               /*--*/
 /*--                                                              --*/
-/*-- Evaluate the adiabatic change using upwinding                --*/
+/*-- Evaluate the adiabatic change using upwinding for a tile of  --*/
+/*-- up to EP_TILE nodes, computeLines[firstStream ...], on shell. --*/
+/*-- Node `lane` advances by dt[lane]; nodes with a step of 0 are  --*/
+/*-- left alone (see nodeEpSteps()).                               --*/
+/*-- Every node keeps its own stable number of subcycles; nodes    --*/
+/*-- that have finished are masked out of the remaining ones.      --*/
+/*-- Returns the largest number of subcycles used in the tile.     --*/
 /*------------------------------------------------------------------*/
 {/*-----------------------------------------------------------------*/
 
@@ -882,40 +1237,70 @@ Scalar_t leaving_rightGlobal = 0;
 // The "dt" passed into this function is the EP subcyled time step.
 // Therefore, we calcualate the large DT (the full EPREM time-step) to
 // compute the MHD derivative constants.
+//
+// All scratch arrays hold EP_TILE nodes side by side, indexed with
+// idx_tile(), so the innermost loops run across the nodes of the tile.
 
-  Node_t node;
+  Node_t *node;
 
-  Index_t N_subcycles                      = 1;
+  Index_t N_subcycles[EP_TILE];
+  Index_t gridIdx[EP_TILE], ePartsIdx[EP_TILE];
+  Index_t maxSubcycles                     = 0;
   Scalar_t safety_factor                   = 0.9;
-  Scalar_t vel_abs_max                     = 0.0;
   Scalar_t half                            = 0.5;
   Scalar_t one                             = 1.0;
-  Index_t s, species, energy, mu, idx;
+  Index_t s, species, energy, mu, idx, lane, i;
+  Index_t computeIndex, face, row, col;
 
   Scalar_t *restrict vel, *restrict f, *restrict f1;
-  Scalar_t *restrict v_avg;
+  Scalar_t *restrict v_avg, *restrict seed, *restrict work;
+  size_t mark;
 
-  Scalar_t dt_full, dt_stable, dt_subcycle;
-  Scalar_t DlnBDt, DlnNDt, DuParDt;
+  Scalar_t dt_full, dt_stable;
+  Scalar_t dt_subcycle[EP_TILE], vel_abs_max[EP_TILE];
+  Scalar_t DlnBDt[EP_TILE], DlnNDt[EP_TILE], DuParDt[EP_TILE];
   Scalar_t a, b, muval;
 
-  // Allocate space for the dist function, effective advection velocity, and fluxes.
+  // Take space for the dist function, effective advection velocity,
+  // inflow boundary values, and the operator work space (fluxes)
+  // from this thread's workspace (see initEnergeticParticlesWorkspace()).
 
-  f    = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
-  f1   = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
-  vel  = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
-  v_avg  = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * (NUM_ESTEPS+1) * NUM_MUSTEPS);
+  mark  = workspaceMark();
+  f     = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * SPEM);
+  f1    = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * SPEM);
+  vel   = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * SPEM);
+  v_avg = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * NUM_SPECIES * (NUM_ESTEPS+1) * NUM_MUSTEPS);
+  seed  = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * NUM_SPECIES * 2);
+  work  = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * (NUM_SPECIES * (NUM_ESTEPS+1) * NUM_MUSTEPS + 3 * SPEM));
 
-  // Get the current node.  This contains the MHD differences
-  // after the node has been moved (e.g. Delta-MHD = MHD^n+1-MHD^n)
+  // Get the nodes of the tile.  These contain the MHD differences
+  // after the nodes have been moved (e.g. Delta-MHD = MHD^n+1-MHD^n)
 
-  node = grid[idx_frcs(face,row,col,shell)];
+  gatherNodeTile(shell, firstStream, numNodes, gridIdx, ePartsIdx);
 
   // Get the full timestep value and use it to compute MHD derivative terms.
-  dt_full = dt*config.numEpSteps;
-  DlnBDt  = node.mhdDlnB/dt_full;
-  DlnNDt  = node.mhdDlnN/dt_full;
-  DuParDt = node.mhdDuPar/dt_full;
+  dt_full = config.tDel;
+
+  for (lane = 0; lane < EP_TILE; lane++) {
+
+    node = &grid[gridIdx[lane]];
+
+    DlnBDt[lane]  = node->mhdDlnB/dt_full;
+    DlnNDt[lane]  = node->mhdDlnN/dt_full;
+    DuParDt[lane] = node->mhdDuPar/dt_full;
+
+    vel_abs_max[lane] = 0.0;
+
+    // The inflow (Dirichlet) values past either end of the energy grid
+    // do not change over the subcycles, so evaluate them once here.
+    for (species = 0; species < NUM_SPECIES; species++) {
+      seed[idx_tile(2*species,lane)] =
+        log(sepSeedFunction(egrid[idx_se(species, 0)], node->rmag));
+      seed[idx_tile(2*species+1,lane)] =
+        log(sepSeedFunction(egrid[idx_se(species, NUM_ESTEPS-1)], node->rmag));
+    }
+
+  }
 
   // For accuracy, we advect ln(distribution), so need to convert here.
   // In same loop, we compute the effective advection velocity (ln(p)/time)
@@ -928,17 +1313,23 @@ Scalar_t leaving_rightGlobal = 0;
 
         idx = idx_spem(species,energy,mu);
 
-        f[idx] = log(eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)]);
-
         muval = mugrid[mu];
 
-        a = -muval * DuParDt;
-        b = muval*muval * (DlnNDt - DlnBDt)
-            + half*(one-muval*muval) * DlnBDt;
+        for (lane = 0; lane < EP_TILE; lane++) {
+
+          i = idx_tile(idx,lane);
+
+          f[i] = log(eParts[ePartsIdx[lane]+idx]);
+
+          a = -muval * DuParDt[lane];
+          b = muval*muval * (DlnNDt[lane] - DlnBDt[lane])
+              + half*(one-muval*muval) * DlnBDt[lane];
 
-        vel[idx] = a/vgrid[energy] + b;
+          vel[i] = a/vgrid[energy] + b;
 
-        if (fabs(vel[idx]) > vel_abs_max) vel_abs_max = fabs(vel[idx]);
+          if (fabs(vel[i]) > vel_abs_max[lane]) vel_abs_max[lane] = fabs(vel[i]);
+
+        }
 
       }
     }
@@ -953,10 +1344,13 @@ Scalar_t leaving_rightGlobal = 0;
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS-1; energy++) {
       for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-        v_avg[idx_spep1m(species,energy+1,mu)] = half * (
-                          vel[idx_spem(species,energy+1,mu)]
-                        + vel[idx_spem(species,energy  ,mu)]);
+          v_avg[idx_tile(idx_spep1m(species,energy+1,mu),lane)] = half * (
+                            vel[idx_tile(idx_spem(species,energy+1,mu),lane)]
+                          + vel[idx_tile(idx_spem(species,energy  ,mu),lane)]);
+
+        }
       }
     }
   }
@@ -965,119 +1359,119 @@ Scalar_t leaving_rightGlobal = 0;
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (mu = 0; mu < NUM_MUSTEPS; mu++) {
-      energy=0;
-      v_avg[idx_spep1m(species,energy,mu)] = v_avg[idx_spep1m(species,energy+1,mu)];
-      energy=NUM_ESTEPS;
-      v_avg[idx_spep1m(species,energy,mu)] = v_avg[idx_spep1m(species,energy-1,mu)];
+      for (lane = 0; lane < EP_TILE; lane++) {
+        energy=0;
+        v_avg[idx_tile(idx_spep1m(species,energy,mu),lane)] =
+          v_avg[idx_tile(idx_spep1m(species,energy+1,mu),lane)];
+        energy=NUM_ESTEPS;
+        v_avg[idx_tile(idx_spep1m(species,energy,mu),lane)] =
+          v_avg[idx_tile(idx_spep1m(species,energy-1,mu),lane)];
+      }
     }
   }
 
   // Find the stable time-step based on the velocity and dlnp.
   // Here, we are relying on the fact that dlnp is NOT dependent on species
   // anymore, so we use only species index 0.
-
-  dt_stable = safety_factor * dlnp/vel_abs_max;
-
+  //
   // Now that we have the stable timestep, we need to be careful
   // about how many subcycles to use.
   // This routine is being called within the
   // EpSubCycle loop, so the dt we need to go is dt_full/config.numEpSteps,
-  // or, simply the "dt" sent into the routine.
+  // or, simply the "dt[lane]" sent into the routine.
+  //
+  // Set the dt_subcycle so that it exactly reaches dt[lane].
+  // Padding lanes, nodes with no step and quiet nodes (see nodeQuiet)
+  // take no subcycles.
 
-  N_subcycles = (Index_t) ceil(dt/dt_stable);
+  for (lane = 0; lane < EP_TILE; lane++) {
 
-  // Keep track of the maximum number of subcycles
-  if (N_subcycles > maxsubcycles_energychange){
-    maxsubcycles_energychange = N_subcycles;
-  }
+    dt_stable = safety_factor * dlnp/vel_abs_max[lane];
 
-  // Set the dt_subcycle so that it exactly reaches dt.
+    N_subcycles[lane] = ( (lane < numNodes) && (dt[lane] > 0.0) &&
+                          (nodeQuiet[gridIdx[lane]] == 0) ) ?
+                        (Index_t) ceil(dt[lane]/dt_stable) : 0;
 
-  dt_subcycle = dt/N_subcycles;
+    dt_subcycle[lane] = (N_subcycles[lane] > 0) ? dt[lane]/N_subcycles[lane] : 0.0;
 
-  // Now compute the sub-cycled upwind advance.
+    if (N_subcycles[lane] > maxSubcycles) maxSubcycles = N_subcycles[lane];
+
+  }
+
+  // Now compute the sub-cycled upwind advance.  A lane only takes the
+  // result of subcycle s if it still has s < N_subcycles[lane] to go.
   if (AdiabaticChangeAlg == 2 || AdiabaticChangeAlg == 3){
 
     Scalar_t *restrict s1;
-    s1 = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES
-                                              * NUM_ESTEPS * NUM_MUSTEPS);
+    s1 = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * SPEM);
 
-    for (s = 0; s < N_subcycles; s++) {
+    for (s = 0; s < maxSubcycles; s++) {
 
       if (AdiabaticChangeAlg == 3){
-        AdiabaticChange_Operator_WENO3(f1,f,v_avg,node);
+        AdiabaticChange_Operator_WENO3(f1,f,v_avg,seed,work);
       } else {
-        AdiabaticChange_Operator_Upwind(f1,f,v_avg,node);
+        AdiabaticChange_Operator_Upwind(f1,f,v_avg,seed,work);
       }
 
-      for (species = 0; species < NUM_SPECIES; species++) {
-        for (energy = 0; energy < NUM_ESTEPS; energy++) {
-          for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (idx = 0; idx < SPEM; idx++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-            idx = idx_spem(species,energy,mu);
+          i = idx_tile(idx,lane);
 
-            s1[idx] = f[idx] - dt_subcycle*f1[idx];
+          s1[i] = f[i] - dt_subcycle[lane]*f1[i];
 
-          }
         }
       }
 
       if (AdiabaticChangeAlg == 3){
-        AdiabaticChange_Operator_WENO3(f1,s1,v_avg,node);
+        AdiabaticChange_Operator_WENO3(f1,s1,v_avg,seed,work);
       } else {
-        AdiabaticChange_Operator_Upwind(f1,s1,v_avg,node);
+        AdiabaticChange_Operator_Upwind(f1,s1,v_avg,seed,work);
       }
 
-      for (species = 0; species < NUM_SPECIES; species++) {
-        for (energy = 0; energy < NUM_ESTEPS; energy++) {
-          for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (idx = 0; idx < SPEM; idx++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-            idx = idx_spem(species,energy,mu);
+          i = idx_tile(idx,lane);
 
-            s1[idx] = (3.0/4.0) * f[idx] + (1.0/4.0) * s1[idx]
-                                         - (1.0/4.0) * dt_subcycle * f1[idx];
+          s1[i] = (3.0/4.0) * f[i] + (1.0/4.0) * s1[i]
+                                   - (1.0/4.0) * dt_subcycle[lane] * f1[i];
 
-          }
         }
       }
 
       if (AdiabaticChangeAlg == 3){
-        AdiabaticChange_Operator_WENO3(f1,s1,v_avg,node);
+        AdiabaticChange_Operator_WENO3(f1,s1,v_avg,seed,work);
       } else {
-        AdiabaticChange_Operator_Upwind(f1,s1,v_avg,node);
+        AdiabaticChange_Operator_Upwind(f1,s1,v_avg,seed,work);
       }
 
-      for (species = 0; species < NUM_SPECIES; species++) {
-        for (energy = 0; energy < NUM_ESTEPS; energy++) {
-          for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (idx = 0; idx < SPEM; idx++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-            idx = idx_spem(species,energy,mu);
+          i = idx_tile(idx,lane);
 
-            f[idx] = (1.0/3.0) * f[idx] + (2.0/3.0) * s1[idx]
-                                        - (2.0/3.0) * dt_subcycle * f1[idx];
+          f[i] = (s < N_subcycles[lane]) ?
+                 (1.0/3.0) * f[i] + (2.0/3.0) * s1[i]
+                                  - (2.0/3.0) * dt_subcycle[lane] * f1[i] : f[i];
 
-          }
         }
       }
     } // subcycles
 
-    free(s1);
-
   } else {
 
-    for (s = 0; s < N_subcycles; s++) {
+    for (s = 0; s < maxSubcycles; s++) {
 
-      AdiabaticChange_Operator_Upwind(f1,f,v_avg,node);
+      AdiabaticChange_Operator_Upwind(f1,f,v_avg,seed,work);
 
-      for (species = 0; species < NUM_SPECIES; species++) {
-        for (energy = 0; energy < NUM_ESTEPS; energy++) {
-          for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (idx = 0; idx < SPEM; idx++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-            idx = idx_spem(species,energy,mu);
+          i = idx_tile(idx,lane);
 
-            f[idx] = f[idx] - dt_subcycle * f1[idx];
+          f[i] = (s < N_subcycles[lane]) ? f[i] - dt_subcycle[lane] * f1[i] : f[i];
 
-          }
         }
       }
 
@@ -1087,72 +1481,150 @@ Scalar_t leaving_rightGlobal = 0;
 
   // Convert back to linear space and check for badness:
 
-  for (species = 0; species < NUM_SPECIES; species++) {
-    for (energy = 0; energy < NUM_ESTEPS; energy++) {
-      for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+  for (lane = 0; lane < numNodes; lane++) {
 
-        idx = idx_frcsspem(face,row,col,shell,species,energy,mu);
+    if ( (dt[lane] == 0.0) || nodeQuiet[gridIdx[lane]] ) continue;
 
-        eParts[idx] = exp(f[idx_spem(species,energy,mu)]);
+    computeIndex = firstStream + lane;
 
-        // check for NaNs and Infs
-        checkNaN(mpi_rank, face, row, col, shell,eParts[idx],
-                 "Adiabatic Change");
-        checkInf(mpi_rank, face, row, col, shell,eParts[idx],
-                 "Adiabatic Change");
+    face = computeLines[computeIndex][0];
+    row  = computeLines[computeIndex][1];
+    col  = computeLines[computeIndex][2];
 
-        // Check if distribution dropped below double minimum.
-        // If so, set it to double minimum.
-        if ( eParts[idx] < DBL_MIN ){
-       //   warn(face, row, col, shell, species, energy, mu,
-       //       "AdiabaticChange: distribution less than DBL_MIN", &eParts[idx]);
-          eParts[idx] = DBL_MIN;
-        }
+    for (idx = 0; idx < SPEM; idx++) {
 
+      i = ePartsIdx[lane] + idx;
+
+      eParts[i] = exp(f[idx_tile(idx,lane)]);
+
+      // check for NaNs and Infs
+      checkNaN(mpi_rank, face, row, col, shell,eParts[i],
+               "Adiabatic Change");
+      checkInf(mpi_rank, face, row, col, shell,eParts[i],
+               "Adiabatic Change");
+
+      // Check if distribution dropped below double minimum.
+      // If so, set it to double minimum.
+      if ( eParts[i] < DBL_MIN ){
+     //   warn(face, row, col, shell, species, energy, mu,
+     //       "AdiabaticChange: distribution less than DBL_MIN", &eParts[i]);
+        eParts[i] = DBL_MIN;
       }
+
     }
   }
 
-  // Free up temporary arrays.
-  free(v_avg);
-  free(vel);
-  free(f1);
-  free(f);
+  // Hand the temporary arrays back to the workspace.
+  workspaceRelease(mark);
+
+  return maxSubcycles;
 
 }
 /*---------- END AdiabaticChange( ) --------------------------------*/
 /*------------------------------------------------------------------*/
 
+/*---------------------------------------------------------------*/
+/*---------------------------------------------------------------*/
+/*--*/    static void                                        /*--*/
+/*--*/    AdiabaticChange_Boundary(Scalar_t *restrict f1,    /*--*/
+/*--*/                             Scalar_t *restrict f,     /*--*/
+/*--*/                             Scalar_t *restrict v_avg, /*--*/
+/*--*/                             Scalar_t *restrict seed)  /*--*/
+/*--*/                                                       /*--*/
+/*--  Energy-boundary values of f1 for a tile of nodes.        --*/
+/*--  For outflow, just use UW as usual.                       --*/
+/*--  For inflow, use Dirichlet of seed population for point   --*/
+/*--  "past the grid".                                         --*/
+/*-------------------------------------------------------------- */
+{
+
+  Index_t species, energy, mu, lane;
+  Scalar_t v;
+
+  for (species = 0; species < NUM_SPECIES; species++) {
+    for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (lane = 0; lane < EP_TILE; lane++) {
+
+        // Left boundary
+
+        energy = 0;
+
+        v = v_avg[idx_tile(idx_spep1m(species,energy+1,mu),lane)];
+
+        if (v <= 0) {
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] = v
+                          *(f[idx_tile(idx_spem(species,energy+1,mu),lane)] -
+                            f[idx_tile(idx_spem(species,energy  ,mu),lane)])/dlnp;
+        }
+        else
+        {
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] = v
+                          *(f[idx_tile(idx_spem(species,energy,mu),lane)] -
+                            seed[idx_tile(2*species,lane)])/dlnp;
+        }
+
+        // Right boundary
+
+        energy = NUM_ESTEPS-1;
+
+        v = v_avg[idx_tile(idx_spep1m(species,energy,mu),lane)];
+
+        if (v >= 0) {
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] = v
+                          *(f[idx_tile(idx_spem(species,energy  ,mu),lane)] -
+                            f[idx_tile(idx_spem(species,energy-1,mu),lane)])/dlnp;
+        }
+        else
+        {
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] = v
+                          *(seed[idx_tile(2*species+1,lane)] -
+                            f[idx_tile(idx_spem(species,energy,mu),lane)])/dlnp;
+        }
+
+      }
+    }
+  }
+
+} /*-------- END AdiabaticChange_Boundary( ) -----------------------*/
+/*------------------------------------------------------------------*/
+
 /*---------------------------------------------------------------*/
 /*---------------------------------------------------------------*/
 /*--*/    void                                               /*--*/
 /*--*/    AdiabaticChange_Operator_Upwind(Scalar_t* f1,      /*--*/
 /*--*/                                    Scalar_t* f,       /*--*/
 /*--*/                                    Scalar_t* v_avg,   /*--*/
-/*--*/                                    Node_t node)       /*--*/
+/*--*/                                    Scalar_t* seed,    /*--*/
+/*--*/                                    Scalar_t* work)    /*--*/
 /*--*/                                                       /*--*/
+/*--  Operates on a tile of EP_TILE nodes (see idx_tile()).    --*/
+/*--  seed holds ln(seed population) just past the low and     --*/
+/*--  high ends of the energy grid for each species.           --*/
 /*-------------------------------------------------------------- */
 {
 
   Scalar_t upwind = 1.0;
 
   Scalar_t *restrict flux;
-  Index_t species, energy, mu;
-  Scalar_t cce;
+  Index_t species, energy, mu, lane;
+  Scalar_t cce, v;
 
-  flux = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * (NUM_ESTEPS+1) * NUM_MUSTEPS);
+  flux = work;
 
   // First, compute "half-mesh" fluxes.
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 1; energy < NUM_ESTEPS; energy++) {
       for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-        cce = copysign(upwind,v_avg[idx_spep1m(species,energy,mu)]);
-        flux[idx_spep1m(species,energy,mu)] = v_avg[idx_spep1m(species,energy,mu)]
-           * 0.5 * ( (1.0 - cce) * f[idx_spem(species,energy  ,mu)]
-                 +   (1.0 + cce) * f[idx_spem(species,energy-1,mu)]);
+          v = v_avg[idx_tile(idx_spep1m(species,energy,mu),lane)];
+          cce = copysign(upwind,v);
+          flux[idx_tile(idx_spep1m(species,energy,mu),lane)] = v
+             * 0.5 * ( (1.0 - cce) * f[idx_tile(idx_spem(species,energy  ,mu),lane)]
+                   +   (1.0 + cce) * f[idx_tile(idx_spem(species,energy-1,mu),lane)]);
 
+        }
       }
     }
   }
@@ -1162,10 +1634,13 @@ Scalar_t leaving_rightGlobal = 0;
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 1; energy < NUM_ESTEPS-1; energy++) {
       for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-        f1[idx_spem(species,energy,mu)]=(flux[idx_spep1m(species,energy+1,mu)] -
-                                         flux[idx_spep1m(species,energy  ,mu)])/dlnp;
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] =
+            (flux[idx_tile(idx_spep1m(species,energy+1,mu),lane)] -
+             flux[idx_tile(idx_spep1m(species,energy  ,mu),lane)])/dlnp;
 
+        }
       }
     }
   }
@@ -1174,44 +1649,7 @@ Scalar_t leaving_rightGlobal = 0;
   // For outflow, just use UW as usual.
   // For inflow, use Dirichlet of seed population for point "past the grid"
 
-  for (species = 0; species < NUM_SPECIES; species++) {
-    for (mu = 0; mu < NUM_MUSTEPS; mu++) {
-
-      // Left boundary
-
-      energy = 0;
-
-      if (v_avg[idx_spep1m(species,energy+1,mu)] <= 0) {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spep1m(species,energy+1,mu)]
-                                        *(f[idx_spem(species,energy+1,mu)] -
-                                          f[idx_spem(species,energy  ,mu)])/dlnp;
-      }
-      else
-      {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spep1m(species,energy+1,mu)]
-                          *(f[idx_spem(species,energy,mu)] -
-                    log(sepSeedFunction(egrid[idx_se(species, energy)], node.rmag)))/dlnp;
-      }
-
-      // Right boundary
-
-      energy = NUM_ESTEPS-1;
-
-      if (v_avg[idx_spep1m(species,energy,mu)] >= 0) {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spep1m(species,energy,mu)]
-                                         *(f[idx_spem(species,energy  ,mu)] -
-                                           f[idx_spem(species,energy-1,mu)])/dlnp;
-      }
-      else
-      {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spep1m(species,energy,mu)]*
-                    (log(sepSeedFunction(egrid[idx_se(species, energy)], node.rmag)) -
-                                           f[idx_spem(species,energy,mu)])/dlnp;
-      }
-    }
-  }
-
-  free(flux);
+  AdiabaticChange_Boundary(f1,f,v_avg,seed);
 
 } /*-------- END AdiabaticChange_Operator_Upwind()------------------*/
 /*------------------------------------------------------------------*/
@@ -1222,9 +1660,11 @@ Scalar_t leaving_rightGlobal = 0;
 /*--*/    AdiabaticChange_Operator_WENO3(Scalar_t* f1,       /*--*/
 /*--*/                                   Scalar_t* f,        /*--*/
 /*--*/                                   Scalar_t* v_avg,    /*--*/
-/*--*/                                   Node_t node )       /*--*/
+/*--*/                                   Scalar_t* seed,     /*--*/
+/*--*/                                   Scalar_t* work )    /*--*/
 /*--*/                                                       /*--*/
 /*--  Does Weno3 and returns recompute vector                  --*/
+/*--  Operates on a tile of EP_TILE nodes (see idx_tile()).    --*/
 /*-------------------------------------------------------------- */
 {/*--------------------------------------------------------------*/
 
@@ -1240,15 +1680,16 @@ Scalar_t leaving_rightGlobal = 0;
   Scalar_t D_P_Tt;
   Scalar_t D_MC_Tt;
   Scalar_t vel_abs_max = 0.0;
-  Scalar_t cce;
+  Scalar_t cce, v;
 
   Scalar_t p0m, p1m, p0p, p1p;
+  Scalar_t d0m, d1m, d0p, d1p;
   Scalar_t B0m, B1m, B0p, B1p;
   Scalar_t w0m, w1m, w0p, w1p;
   Scalar_t wm_sum, wp_sum;
   Scalar_t OM0m, OM1m, OM0p, OM1p;
   Scalar_t um, up;
-  Index_t species, energy, mu;
+  Index_t species, energy, mu, lane, k, kmin, kmax;
 
   D_C_CPt = 0.5;
   D_C_MCt = 0.5;
@@ -1258,10 +1699,10 @@ Scalar_t leaving_rightGlobal = 0;
   D_MC_Tt = 2.0/3.0;
   weno_eps = 10.0*sqrt(DBL_MIN);
 
-  flux  = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * (NUM_ESTEPS+1) * NUM_MUSTEPS);
-  LP    = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * (NUM_ESTEPS) * NUM_MUSTEPS);
-  LN    = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * (NUM_ESTEPS) * NUM_MUSTEPS);
-  alpha = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * (NUM_ESTEPS) * NUM_MUSTEPS);
+  flux  = work;
+  LP    = flux + EP_TILE * NUM_SPECIES * (NUM_ESTEPS+1) * NUM_MUSTEPS;
+  LN    = LP + EP_TILE * SPEM;
+  alpha = LN + EP_TILE * SPEM;
 
 /* ****** Get alpha ****** */
 
@@ -1271,79 +1712,50 @@ Scalar_t leaving_rightGlobal = 0;
    X    O    X    O    X    O    X    O    X    O    X
    0    0    1    1    2    2    3    3    NE-1 NE-1 NE
    (v_avg,flux on X), (alpha,LP/N,f,f1 on O)
+
+   alpha is the largest |v_avg| over half-mesh points energy-2 through
+   energy+3, clipped to the ends of the extended mesh.
 */
 
-/* ***** Get inner points. */
   for (species = 0; species < NUM_SPECIES; species++) {
-    for (energy = 2; energy < NUM_ESTEPS-2; energy++) {
+    for (energy = 0; energy < NUM_ESTEPS; energy++) {
+
+      kmin = (energy < 2) ? -energy : -2;
+      kmax = (NUM_ESTEPS - energy < 3) ? NUM_ESTEPS - energy : 3;
+
       for (mu = 0; mu < NUM_MUSTEPS; mu++) {
-        vel_abs_max =
-            fabs(v_avg[idx_spep1m(species,energy  ,mu)]);
-        if (fabs(v_avg[idx_spep1m(species,energy-1,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy-1,mu)]);
-        if (fabs(v_avg[idx_spep1m(species,energy-2,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy-2,mu)]);
-        if (fabs(v_avg[idx_spep1m(species,energy+1,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+1,mu)]);
-        if (fabs(v_avg[idx_spep1m(species,energy+2,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+2,mu)]);
-        if (fabs(v_avg[idx_spep1m(species,energy+3,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+3,mu)]);
-
-        alpha[idx_spem(species,energy,mu)] = vel_abs_max;
-      }
-    }
-  }
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-  /* ***** Edge cases. */
+          vel_abs_max = fabs(v_avg[idx_tile(idx_spep1m(species,energy,mu),lane)]);
 
-  for (species = 0; species < NUM_SPECIES; species++) {
-    for (mu = 0; mu < NUM_MUSTEPS; mu++) {
-      energy = 0;
-      vel_abs_max =
-          fabs(v_avg[idx_spep1m(species,energy  ,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy+1,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+1,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy+2,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+2,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy+3,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+3,mu)]);
-
-      alpha[idx_spem(species,energy,mu)] = vel_abs_max;
-
-      energy = 1;
-      vel_abs_max =
-          fabs(v_avg[idx_spep1m(species,energy  ,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy-1,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy-1,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy+1,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+1,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy+2,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+2,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy+3,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+3,mu)]);
-
-      alpha[idx_spem(species,energy,mu)] = vel_abs_max;
-
-      energy = NUM_ESTEPS-2;
-      vel_abs_max =
-          fabs(v_avg[idx_spep1m(species,energy  ,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy+1,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+1,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy+2,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+2,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy-1,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy-1,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy-2,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy-2,mu)]);
-
-      alpha[idx_spem(species,energy,mu)] = vel_abs_max;
-
-      energy = NUM_ESTEPS-1;
-      vel_abs_max =
-          fabs(v_avg[idx_spep1m(species,energy  ,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy+1,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy+1,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy-1,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy-1,mu)]);
-      if (fabs(v_avg[idx_spep1m(species,energy-2,mu)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spep1m(species,energy-2,mu)]);
-
-      alpha[idx_spem(species,energy,mu)] = vel_abs_max;
+          for (k = kmin; k <= kmax; k++) {
+            v = fabs(v_avg[idx_tile(idx_spep1m(species,energy+k,mu),lane)]);
+            if (v > vel_abs_max) vel_abs_max = v;
+          }
+
+          alpha[idx_tile(idx_spem(species,energy,mu),lane)] = vel_abs_max;
+
+        }
+      }
     }
   }
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
       for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-        LP[idx_spem(species,energy,mu)] = 0.5 * f[idx_spem(species,energy,mu)] *
-          v_avg[idx_spep1m(species,energy+1,mu)] - alpha[idx_spem(species,energy,mu)];
+          LP[idx_tile(idx_spem(species,energy,mu),lane)] =
+            0.5 * f[idx_tile(idx_spem(species,energy,mu),lane)] *
+            v_avg[idx_tile(idx_spep1m(species,energy+1,mu),lane)]
+            - alpha[idx_tile(idx_spem(species,energy,mu),lane)];
 
-        LN[idx_spem(species,energy,mu)] = 0.5 * f[idx_spem(species,energy,mu)] *
-          v_avg[idx_spep1m(species,energy,mu)] + alpha[idx_spem(species,energy,mu)];
+          LN[idx_tile(idx_spem(species,energy,mu),lane)] =
+            0.5 * f[idx_tile(idx_spem(species,energy,mu),lane)] *
+            v_avg[idx_tile(idx_spep1m(species,energy,mu),lane)]
+            + alpha[idx_tile(idx_spem(species,energy,mu),lane)];
 
+        }
       }
     }
   }
@@ -1351,36 +1763,50 @@ Scalar_t leaving_rightGlobal = 0;
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 2; energy < NUM_ESTEPS-1; energy++) {
       for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
+
+          p0m = (1.0 + D_C_MCt)*LN[idx_tile(idx_spem(species,energy-1,mu),lane)]
+                       - D_C_MCt*LN[idx_tile(idx_spem(species,energy-2,mu),lane)];
+          p1m =          D_C_MCt*LN[idx_tile(idx_spem(species,energy-1,mu),lane)]
+                       + D_C_CPt*LN[idx_tile(idx_spem(species,energy  ,mu),lane)];
+          p0p = (1.0 + D_C_CPt)*LP[idx_tile(idx_spem(species,energy  ,mu),lane)]
+                       - D_C_CPt*LP[idx_tile(idx_spem(species,energy+1,mu),lane)];
+          p1p =          D_C_CPt*LP[idx_tile(idx_spem(species,energy  ,mu),lane)]
+                       + D_C_MCt*LP[idx_tile(idx_spem(species,energy-1,mu),lane)];
+
+          d0m = D_C_MCt*(LN[idx_tile(idx_spem(species,energy-1,mu),lane)]
+                       - LN[idx_tile(idx_spem(species,energy-2,mu),lane)]);
+          d1m = D_C_CPt*(LN[idx_tile(idx_spem(species,energy  ,mu),lane)]
+                       - LN[idx_tile(idx_spem(species,energy-1,mu),lane)]);
+          d0p = D_C_CPt*(LP[idx_tile(idx_spem(species,energy+1,mu),lane)]
+                       - LP[idx_tile(idx_spem(species,energy  ,mu),lane)]);
+          d1p = D_C_MCt*(LP[idx_tile(idx_spem(species,energy  ,mu),lane)]
+                       - LP[idx_tile(idx_spem(species,energy-1,mu),lane)]);
+
+          B0m = 4.0*(d0m*d0m);
+          B1m = 4.0*(d1m*d1m);
+          B0p = 4.0*(d0p*d0p);
+          B1p = 4.0*(d1p*d1p);
+
+          w0m = D_P_Tt /((weno_eps + B0m)*(weno_eps + B0m));
+          w1m = D_MC_Tt/((weno_eps + B1m)*(weno_eps + B1m));
+          w0p = D_M_Tt /((weno_eps + B0p)*(weno_eps + B0p));
+          w1p = D_CP_Tt/((weno_eps + B1p)*(weno_eps + B1p));
+
+          wm_sum = w0m + w1m;
+          wp_sum = w0p + w1p;
+
+          OM0m = w0m/wm_sum;
+          OM1m = w1m/wm_sum;
+          OM0p = w0p/wp_sum;
+          OM1p = w1p/wp_sum;
+
+          um = OM0m*p0m + OM1m*p1m;
+          up = OM0p*p0p + OM1p*p1p;
+
+          flux[idx_tile(idx_spep1m(species,energy,mu),lane)] = up + um;
 
-        p0m = (1.0 + D_C_MCt)*LN[idx_spem(species,energy-1,mu)] - D_C_MCt*LN[idx_spem(species,energy-2,mu)];
-        p1m =         D_C_MCt *LN[idx_spem(species,energy-1,mu)] + D_C_CPt*LN[idx_spem(species,energy  ,mu)];
-        p0p = (1.0 + D_C_CPt)*LP[idx_spem(species,energy  ,mu)] - D_C_CPt*LP[idx_spem(species,energy+1,mu)];
-        p1p =         D_C_CPt *LP[idx_spem(species,energy  ,mu)] + D_C_MCt*LP[idx_spem(species,energy-1,mu)];
-
-        B0m = 4.0*pow((D_C_MCt*(LN[idx_spem(species,energy-1,mu)] - LN[idx_spem(species,energy-2,mu)])),2);
-        B1m = 4.0*pow((D_C_CPt*(LN[idx_spem(species,energy  ,mu)] - LN[idx_spem(species,energy-1,mu)])),2);
-        B0p = 4.0*pow((D_C_CPt*(LP[idx_spem(species,energy+1,mu)] - LP[idx_spem(species,energy  ,mu)])),2);
-        B1p = 4.0*pow((D_C_MCt*(LP[idx_spem(species,energy  ,mu)] - LP[idx_spem(species,energy-1,mu)])),2);
-
-
-        w0m = D_P_Tt /pow((weno_eps + B0m),2);
-        w1m = D_MC_Tt/pow((weno_eps + B1m),2);
-        w0p = D_M_Tt /pow((weno_eps + B0p),2);
-        w1p = D_CP_Tt/pow((weno_eps + B1p),2);
-
-        wm_sum = w0m + w1m;
-        wp_sum = w0p + w1p;
-
-        OM0m = w0m/wm_sum;
-        OM1m = w1m/wm_sum;
-        OM0p = w0p/wp_sum;
-        OM1p = w1p/wp_sum;
-
-        um = OM0m*p0m + OM1m*p1m;
-        up = OM0p*p0p + OM1p*p1p;
-
-        flux[idx_spep1m(species,energy,mu)] = up + um;
-
+        }
       }
     }
   }
@@ -1389,31 +1815,38 @@ Scalar_t leaving_rightGlobal = 0;
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (lane = 0; lane < EP_TILE; lane++) {
 
-      energy = 1;
+        energy = 1;
 
-      cce = copysign(upwind,v_avg[idx_spep1m(species,energy,mu)]);
-      flux[idx_spep1m(species,energy,mu)] = v_avg[idx_spep1m(species,energy,mu)]
-             * 0.5 * ( (1.0 - cce) * f[idx_spem(species,energy  ,mu)]
-                   +   (1.0 + cce) * f[idx_spem(species,energy-1,mu)]);
+        v = v_avg[idx_tile(idx_spep1m(species,energy,mu),lane)];
+        cce = copysign(upwind,v);
+        flux[idx_tile(idx_spep1m(species,energy,mu),lane)] = v
+               * 0.5 * ( (1.0 - cce) * f[idx_tile(idx_spem(species,energy  ,mu),lane)]
+                     +   (1.0 + cce) * f[idx_tile(idx_spem(species,energy-1,mu),lane)]);
 
-      energy = NUM_ESTEPS-1;
+        energy = NUM_ESTEPS-1;
 
-      cce = copysign(upwind,v_avg[idx_spep1m(species,energy,mu)]);
-      flux[idx_spep1m(species,energy,mu)] = v_avg[idx_spep1m(species,energy,mu)]
-             * 0.5 * ( (1.0 - cce) * f[idx_spem(species,energy  ,mu)]
-                   +   (1.0 + cce) * f[idx_spem(species,energy-1,mu)]);
+        v = v_avg[idx_tile(idx_spep1m(species,energy,mu),lane)];
+        cce = copysign(upwind,v);
+        flux[idx_tile(idx_spep1m(species,energy,mu),lane)] = v
+               * 0.5 * ( (1.0 - cce) * f[idx_tile(idx_spem(species,energy  ,mu),lane)]
+                     +   (1.0 + cce) * f[idx_tile(idx_spem(species,energy-1,mu),lane)]);
 
+      }
     }
   }
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 1; energy < NUM_ESTEPS-1; energy++) {
       for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-        f1[idx_spem(species,energy,mu)]=(flux[idx_spep1m(species,energy+1,mu)] -
-                                         flux[idx_spep1m(species,energy  ,mu)])/dlnp;
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] =
+            (flux[idx_tile(idx_spep1m(species,energy+1,mu),lane)] -
+             flux[idx_tile(idx_spep1m(species,energy  ,mu),lane)])/dlnp;
 
+        }
       }
     }
   }
@@ -1422,47 +1855,7 @@ Scalar_t leaving_rightGlobal = 0;
   // For outflow, just use UW as usual.
   // For inflow, use Dirichlet of seed population for point "past the grid"
 
-  for (species = 0; species < NUM_SPECIES; species++) {
-    for (mu = 0; mu < NUM_MUSTEPS; mu++) {
-
-      // Left boundary
-
-      energy = 0;
-
-      if (v_avg[idx_spep1m(species,energy+1,mu)] <= 0) {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spep1m(species,energy+1,mu)]
-                                        *(f[idx_spem(species,energy+1,mu)] -
-                                          f[idx_spem(species,energy  ,mu)])/dlnp;
-      }
-      else
-      {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spep1m(species,energy+1,mu)]
-                          *(f[idx_spem(species,energy,mu)] -
-                    log(sepSeedFunction(egrid[idx_se(species, energy)], node.rmag)))/dlnp;
-      }
-
-      // Right boundary
-
-      energy = NUM_ESTEPS-1;
-
-      if (v_avg[idx_spep1m(species,energy,mu)] >= 0) {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spep1m(species,energy,mu)]
-                                         *(f[idx_spem(species,energy  ,mu)] -
-                                           f[idx_spem(species,energy-1,mu)])/dlnp;
-      }
-      else
-      {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spep1m(species,energy,mu)]*
-                    (log(sepSeedFunction(egrid[idx_se(species, energy)], node.rmag)) -
-                                           f[idx_spem(species,energy,mu)])/dlnp;
-      }
-    }
-  }
-
-  free(flux);
-  free(LP);
-  free(LN);
-  free(alpha);
+  AdiabaticChange_Boundary(f1,f,v_avg,seed);
 
 } /*-------- END AdiabaticChange_Operator_WENO3( ) -----------------*/
 /*------------------------------------------------------------------*/
@@ -1969,16 +2362,19 @@ Scalar_t leaving_rightGlobal = 0;
 
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
-/*------------------------------------------------------------------*/
-/*--*/     void                                                 /*--*/
-/*--*/     AdiabaticFocusing( Index_t face,                     /*--*/
-/*--*/                        Index_t row,                      /*--*/
-/*--*/                        Index_t col,                      /*--*/
-/*--*/                        Index_t shell,                    /*--*/
-/*--*/                        Scalar_t dt )                     /*--*/
-/*--                                                              --*/
-/*-- Calculate adiabatic focusing along a stream                  --*/
+/*--*/     Index_t                                              /*--*/
+/*--*/     AdiabaticFocusing( Index_t shell,                    /*--*/
+/*--*/                        Index_t firstStream,              /*--*/
+/*--*/                        Index_t numNodes,                 /*--*/
+/*--*/                        const Scalar_t *dt )              /*--*/
 /*--                                                              --*/
+/*-- Calculate adiabatic focusing along a stream for a tile of up --*/
+/*-- to EP_TILE nodes, computeLines[firstStream ...], on shell.    --*/
+/*-- Node `lane` advances by dt[lane]; nodes with a step of 0 are  --*/
+/*-- left alone (see nodeEpSteps()).                               --*/
+/*-- Every node keeps its own stable number of subcycles; nodes    --*/
+/*-- that have finished are masked out of the remaining ones.      --*/
+/*-- Returns the largest number of subcycles used in the tile.     --*/
 /*------------------------------------------------------------------*/
 {/*-----------------------------------------------------------------*/
 
@@ -1987,55 +2383,74 @@ Scalar_t leaving_rightGlobal = 0;
 // The "dt" passed into this function is the EP subcyled time step.
 // Therefore, we calcualate the large DT (the full EPREM time-step) to
 // compute the MHD derivative constants.
+//
+// All scratch arrays hold EP_TILE nodes side by side, indexed with
+// idx_tile(), so the innermost loops run across the nodes of the tile.
 
-  Node_t node;
+  Node_t *node;
 
-  Index_t N_subcycles                      = 1;
+  Index_t N_subcycles[EP_TILE];
+  Index_t gridIdx[EP_TILE], ePartsIdx[EP_TILE];
+  Index_t maxSubcycles                     = 0;
   Scalar_t safety_factor                   = 0.9;
-  Scalar_t vel_abs_max                     = 0.0;
   Scalar_t half                            = 0.5;
   Scalar_t one                             = 1.0;
   Scalar_t two                             = 2.0;
   Scalar_t three                           = 3.0;
 
-  Index_t s, species, energy, mu, idx;
+  Index_t s, species, energy, mu, idx, lane, i;
+  Index_t computeIndex, face, row, col;
 
   Scalar_t *restrict vel, *restrict f, *restrict f1;
-  Scalar_t *restrict v_avg;
+  Scalar_t *restrict v_avg, *restrict work;
+  size_t mark;
 
-  Scalar_t dt_full, dt_stable, dt_subcycle;
-  Scalar_t DlnBDt, DlnNDt, DuParDt, dlnBds;
+  Scalar_t dt_full, dt_stable;
+  Scalar_t dt_subcycle[EP_TILE], vel_abs_max[EP_TILE];
+  Scalar_t DlnBDt[EP_TILE], DlnNDt[EP_TILE], DuParDt[EP_TILE], dlnBds[EP_TILE];
   Scalar_t a, b, muval;
 
-  // Allocate space for the dist function, effective advection velocity, and fluxes.
+  // Take space for the dist function, effective advection velocity,
+  // and the operator work space (fluxes) from this thread's workspace.
 
-  f    = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
-  f1   = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
-  vel  = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
-  v_avg  = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * (NUM_MUSTEPS+1));
+  mark  = workspaceMark();
+  f     = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * SPEM);
+  f1    = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * SPEM);
+  vel   = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * SPEM);
+  v_avg = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * NUM_SPECIES * NUM_ESTEPS * (NUM_MUSTEPS+1));
+  work  = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * (NUM_SPECIES * NUM_ESTEPS * (NUM_MUSTEPS+1) + 3 * SPEM));
 
-  // Get the current node.  This contains the MHD differences
-  // after the node has been moved (e.g. Delta-MHD = MHD^n+1-MHD^n)
+  // Get the nodes of the tile.  These contain the MHD differences
+  // after the nodes have been moved (e.g. Delta-MHD = MHD^n+1-MHD^n)
 
-  node = grid[idx_frcs(face,row,col,shell)];
+  gatherNodeTile(shell, firstStream, numNodes, gridIdx, ePartsIdx);
 
   // Get the full timestep value and use it to compute MHD derivative terms.
-  dt_full = dt*config.numEpSteps;
-  DlnBDt  = node.mhdDlnB/dt_full;
-  DlnNDt  = node.mhdDlnN/dt_full;
-  DuParDt = node.mhdDuPar/dt_full;
-
-  // Set spatial derivative of b-hat*Grad[ln(B)]:
-  // NOTE! These values (ds,Bmag+/-) are set
-  //       in update_stream_from_shell() + updateStreamValues()!
-  // The use of DBL_MIN should be unnessesary as ds should never be zero except during
-  // node seeding (in which case this routine should not be being called!).
-  // Leaving it in for now...
-  // ALSO, this is a central difference..   maybe it should be upwinded in the direction of B?
-  if ((node.mhdBmagPlus == 0.0) || (node.mhdBmagMinus == 0.0))
-    dlnBds = 0.0;
-  else
-    dlnBds = (log(node.mhdBmagPlus) - log(node.mhdBmagMinus)) / (two * node.ds + DBL_MIN);
+  dt_full = config.tDel;
+
+  for (lane = 0; lane < EP_TILE; lane++) {
+
+    node = &grid[gridIdx[lane]];
+
+    DlnBDt[lane]  = node->mhdDlnB/dt_full;
+    DlnNDt[lane]  = node->mhdDlnN/dt_full;
+    DuParDt[lane] = node->mhdDuPar/dt_full;
+
+    vel_abs_max[lane] = 0.0;
+
+    // Set spatial derivative of b-hat*Grad[ln(B)]:
+    // NOTE! These values (ds,Bmag+/-) are set
+    //       in update_stream_from_shell() + updateStreamValues()!
+    // The use of DBL_MIN should be unnessesary as ds should never be zero except during
+    // node seeding (in which case this routine should not be being called!).
+    // Leaving it in for now...
+    // ALSO, this is a central difference..   maybe it should be upwinded in the direction of B?
+    if ((node->mhdBmagPlus == 0.0) || (node->mhdBmagMinus == 0.0))
+      dlnBds[lane] = 0.0;
+    else
+      dlnBds[lane] = (log(node->mhdBmagPlus) - log(node->mhdBmagMinus)) / (two * node->ds + DBL_MIN);
+
+  }
 
   // Compute maximum |mu-velocity| to calculte stable timestep.
   // We also make a copy of the distribution function into f
@@ -2047,17 +2462,23 @@ Scalar_t leaving_rightGlobal = 0;
 
         idx = idx_spem(species,energy,mu);
 
-        f[idx] = eParts[idx_frcsspem(face,row,col,shell,species,energy,mu)];
-
         muval = mugrid[mu];
 
-        a = -vgrid[energy] * dlnBds - (two / vgrid[energy]) * DuParDt;
+        for (lane = 0; lane < EP_TILE; lane++) {
+
+          i = idx_tile(idx,lane);
+
+          f[i] = eParts[ePartsIdx[lane]+idx];
 
-        b = two * DlnNDt - three * DlnBDt;
+          a = -vgrid[energy] * dlnBds[lane] - (two / vgrid[energy]) * DuParDt[lane];
 
-        vel[idx] = half*(one-muval*muval)*(a + muval*b);
+          b = two * DlnNDt[lane] - three * DlnBDt[lane];
 
-        if (fabs(vel[idx]) > vel_abs_max) vel_abs_max = fabs(vel[idx]);
+          vel[i] = half*(one-muval*muval)*(a + muval*b);
+
+          if (fabs(vel[i]) > vel_abs_max[lane]) vel_abs_max[lane] = fabs(vel[i]);
+
+        }
 
       }
     }
@@ -2072,10 +2493,13 @@ Scalar_t leaving_rightGlobal = 0;
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
       for (mu = 0; mu < NUM_MUSTEPS-1; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-        v_avg[idx_spemp1(species,energy,mu+1)] = half * (
-                          vel[idx_spem(species,energy,mu+1)]
-                        + vel[idx_spem(species,energy,mu  )]);
+          v_avg[idx_tile(idx_spemp1(species,energy,mu+1),lane)] = half * (
+                            vel[idx_tile(idx_spem(species,energy,mu+1),lane)]
+                          + vel[idx_tile(idx_spem(species,energy,mu  ),lane)]);
+
+        }
       }
     }
   }
@@ -2084,119 +2508,115 @@ Scalar_t leaving_rightGlobal = 0;
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
-      mu = 0;
-      v_avg[idx_spemp1(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu+1)];
-      mu = NUM_MUSTEPS;
-      v_avg[idx_spemp1(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu-1)];
+      for (lane = 0; lane < EP_TILE; lane++) {
+        mu = 0;
+        v_avg[idx_tile(idx_spemp1(species,energy,mu),lane)] =
+          v_avg[idx_tile(idx_spemp1(species,energy,mu+1),lane)];
+        mu = NUM_MUSTEPS;
+        v_avg[idx_tile(idx_spemp1(species,energy,mu),lane)] =
+          v_avg[idx_tile(idx_spemp1(species,energy,mu-1),lane)];
+      }
     }
   }
 
-  // Find the stable time-step based on the velocity and dlnp.
-  // Here, we are relying on the fact that dlnp is NOT dependent on species
-  // anymore, so we use only species index 0.
-
-  dt_stable = safety_factor * dmu/vel_abs_max;
-
+  // Find the stable time-step based on the velocity and dmu.
+  //
   // Now that we have the stable timestep, we need to be careful
   // about how many subcycles to use.
   // This routine is being called within the
   // EpSubCycle loop, so the dt we need to go is dt_full/config.numEpSteps,
-  // or, simply the "dt" sent into the routine.
+  // or, simply the "dt[lane]" sent into the routine.
+  //
+  // Set the dt_subcycle so that it exactly reaches dt[lane].
+  // Padding lanes and nodes with no step take no subcycles.
 
-  N_subcycles = (Index_t) ceil(dt/dt_stable);
+  for (lane = 0; lane < EP_TILE; lane++) {
 
-  // Keep track of the maximum number of subcycles
-  if (N_subcycles > maxsubcycles_focusing){
-    maxsubcycles_focusing = N_subcycles;
-  }
+    dt_stable = safety_factor * dmu/vel_abs_max[lane];
 
-  // Set the dt_subcycle so that it exactly reaches dt.
+    N_subcycles[lane] = ( (lane < numNodes) && (dt[lane] > 0.0) ) ?
+                        (Index_t) ceil(dt[lane]/dt_stable) : 0;
 
-  dt_subcycle = dt/N_subcycles;
+    dt_subcycle[lane] = (N_subcycles[lane] > 0) ? dt[lane]/N_subcycles[lane] : 0.0;
 
-  // Now compute the sub-cycled upwind advance.
+    if (N_subcycles[lane] > maxSubcycles) maxSubcycles = N_subcycles[lane];
+
+  }
+
+  // Now compute the sub-cycled upwind advance.  A lane only takes the
+  // result of subcycle s if it still has s < N_subcycles[lane] to go.
   if (AdiabaticFocusAlg == 2 || AdiabaticFocusAlg == 3){
 
     Scalar_t *restrict s1;
-    s1 = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES
-                                              * NUM_ESTEPS * NUM_MUSTEPS);
+    s1 = (Scalar_t *) workspaceAlloc(sizeof(Scalar_t) * EP_TILE * SPEM);
 
-    for (s = 0; s < N_subcycles; s++) {
+    for (s = 0; s < maxSubcycles; s++) {
 
       if (AdiabaticFocusAlg == 3){
-        AdiabaticFocusing_Operator_WENO3(f1,f,v_avg);
+        AdiabaticFocusing_Operator_WENO3(f1,f,v_avg,work);
       } else {
-        AdiabaticFocusing_Operator_Upwind(f1,f,v_avg);
+        AdiabaticFocusing_Operator_Upwind(f1,f,v_avg,work);
       }
 
-      for (species = 0; species < NUM_SPECIES; species++) {
-        for (energy = 0; energy < NUM_ESTEPS; energy++) {
-          for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (idx = 0; idx < SPEM; idx++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-            idx = idx_spem(species,energy,mu);
+          i = idx_tile(idx,lane);
 
-            s1[idx] = f[idx] - dt_subcycle*f1[idx];
+          s1[i] = f[i] - dt_subcycle[lane]*f1[i];
 
-          }
         }
       }
 
       if (AdiabaticFocusAlg == 3){
-        AdiabaticFocusing_Operator_WENO3(f1,s1,v_avg);
+        AdiabaticFocusing_Operator_WENO3(f1,s1,v_avg,work);
       } else {
-        AdiabaticFocusing_Operator_Upwind(f1,s1,v_avg);
+        AdiabaticFocusing_Operator_Upwind(f1,s1,v_avg,work);
       }
 
-      for (species = 0; species < NUM_SPECIES; species++) {
-        for (energy = 0; energy < NUM_ESTEPS; energy++) {
-          for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (idx = 0; idx < SPEM; idx++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-            idx = idx_spem(species,energy,mu);
+          i = idx_tile(idx,lane);
 
-            s1[idx] = (3.0/4.0) * f[idx] + (1.0/4.0) * s1[idx]
-                                         - (1.0/4.0) * dt_subcycle * f1[idx];
+          s1[i] = (3.0/4.0) * f[i] + (1.0/4.0) * s1[i]
+                                   - (1.0/4.0) * dt_subcycle[lane] * f1[i];
 
-          }
         }
       }
 
       if (AdiabaticFocusAlg == 3){
-        AdiabaticFocusing_Operator_WENO3(f1,s1,v_avg);
+        AdiabaticFocusing_Operator_WENO3(f1,s1,v_avg,work);
       } else {
-        AdiabaticFocusing_Operator_Upwind(f1,s1,v_avg);
+        AdiabaticFocusing_Operator_Upwind(f1,s1,v_avg,work);
       }
 
-      for (species = 0; species < NUM_SPECIES; species++) {
-        for (energy = 0; energy < NUM_ESTEPS; energy++) {
-          for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (idx = 0; idx < SPEM; idx++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-            idx = idx_spem(species,energy,mu);
+          i = idx_tile(idx,lane);
 
-            f[idx] = (1.0/3.0) * f[idx] + (2.0/3.0) * s1[idx]
-                                        - (2.0/3.0) * dt_subcycle * f1[idx];
+          f[i] = (s < N_subcycles[lane]) ?
+                 (1.0/3.0) * f[i] + (2.0/3.0) * s1[i]
+                                  - (2.0/3.0) * dt_subcycle[lane] * f1[i] : f[i];
 
-          }
         }
       }
     } // subcycles
 
-    free(s1);
-
   } else {
 
-    for (s = 0; s < N_subcycles; s++) {
+    for (s = 0; s < maxSubcycles; s++) {
 
-      AdiabaticFocusing_Operator_Upwind(f1,f,v_avg);
+      AdiabaticFocusing_Operator_Upwind(f1,f,v_avg,work);
 
-      for (species = 0; species < NUM_SPECIES; species++) {
-        for (energy = 0; energy < NUM_ESTEPS; energy++) {
-          for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (idx = 0; idx < SPEM; idx++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-            idx = idx_spem(species,energy,mu);
+          i = idx_tile(idx,lane);
 
-            f[idx] = f[idx] - dt_subcycle * f1[idx];
+          f[i] = (s < N_subcycles[lane]) ? f[i] - dt_subcycle[lane] * f1[i] : f[i];
 
-          }
         }
       }
 
@@ -2205,39 +2625,107 @@ Scalar_t leaving_rightGlobal = 0;
 
   // Copy back new distribution and check for badness:
 
+  for (lane = 0; lane < numNodes; lane++) {
+
+    if (dt[lane] == 0.0) continue;
+
+    computeIndex = firstStream + lane;
+
+    face = computeLines[computeIndex][0];
+    row  = computeLines[computeIndex][1];
+    col  = computeLines[computeIndex][2];
+
+    for (idx = 0; idx < SPEM; idx++) {
+
+      i = ePartsIdx[lane] + idx;
+
+      eParts[i] = f[idx_tile(idx,lane)];
+
+      // check for NaNs and Infs
+      checkNaN(mpi_rank, face, row, col, shell,eParts[i],
+               "Adiabatic Focusing");
+      checkInf(mpi_rank, face, row, col, shell,eParts[i],
+               "Adiabatic Focusing");
+
+      // Check if distribution dropped below double minimum.
+      // If so, set it to double minimum.
+      // Note that this may make this scheme not conservative
+      // but only by a tiny amount so should be OK.
+      if ( eParts[i] < DBL_MIN ){
+        eParts[i] = DBL_MIN;
+      }
+
+    }
+  }
+
+  // Hand the temporary arrays back to the workspace.
+  workspaceRelease(mark);
+
+  return maxSubcycles;
+
+}/*-------- END AdiabaticFocusing() --------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/    static void                                           /*--*/
+/*--*/    AdiabaticFocusing_Boundary(Scalar_t *restrict f1,     /*--*/
+/*--*/                               Scalar_t *restrict f,      /*--*/
+/*--*/                               Scalar_t *restrict v_avg)  /*--*/
+/*--*/                                                          /*--*/
+/*--  Pitch-angle boundary values of f1 for a tile of nodes.      --*/
+/*--  Solid wall                                                  --*/
+/*--  For inflow, allow stuff to enter boundary cell, but not     --*/
+/*--  leave it. For outflow, allow stuff to leave boundary,       --*/
+/*--  nothing enters.                                             --*/
+/*----------------------------------------------------------------- */
+{
+
+  Index_t species, energy, mu, lane;
+  Scalar_t v;
+
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
-      for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+      for (lane = 0; lane < EP_TILE; lane++) {
 
-        idx = idx_frcsspem(face,row,col,shell,species,energy,mu);
+        // Left boundary
 
-        eParts[idx] = f[idx_spem(species,energy,mu)];
+        mu = 0;
 
-        // check for NaNs and Infs
-        checkNaN(mpi_rank, face, row, col, shell,eParts[idx],
-                 "Adiabatic Focusing");
-        checkInf(mpi_rank, face, row, col, shell,eParts[idx],
-                 "Adiabatic Focusing");
+        v = v_avg[idx_tile(idx_spemp1(species,energy,mu+1),lane)];
 
-        // Check if distribution dropped below double minimum.
-        // If so, set it to double minimum.
-        // Note that this may make this scheme not conservative
-        // but only by a tiny amount so should be OK.
-        if ( eParts[idx] < DBL_MIN ){
-          eParts[idx] = DBL_MIN;
+        if (v <= 0) {
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] =
+            v*f[idx_tile(idx_spem(species,energy,mu+1),lane)]/dmu;
+        }
+        else
+        {
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] =
+            v*f[idx_tile(idx_spem(species,energy,mu),lane)]/dmu;
+        }
+
+        // Right boundary
+
+        mu = NUM_MUSTEPS-1;
+
+        v = v_avg[idx_tile(idx_spemp1(species,energy,mu),lane)];
+
+        if (v >= 0) {
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] =
+            v*(-f[idx_tile(idx_spem(species,energy,mu-1),lane)])/dmu;
+        }
+        else
+        {
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] =
+            v*(-f[idx_tile(idx_spem(species,energy,mu),lane)])/dmu;
         }
 
       }
     }
   }
 
-  // Free up temporary arrays.
-  free(v_avg);
-  free(vel);
-  free(f1);
-  free(f);
-
-}/*-------- END AdiabaticFocusing() --------------------------------*/
+}
+/*-------- END AdiabaticFocusing_Boundary()-------------------------*/
 /*------------------------------------------------------------------*/
 
 /*------------------------------------------------------------------*/
@@ -2245,30 +2733,35 @@ Scalar_t leaving_rightGlobal = 0;
 /*--*/    void                                                  /*--*/
 /*--*/    AdiabaticFocusing_Operator_Upwind(Scalar_t* f1,       /*--*/
 /*--*/                                      Scalar_t* f,        /*--*/
-/*--*/                                      Scalar_t* v_avg)    /*--*/
+/*--*/                                      Scalar_t* v_avg,    /*--*/
+/*--*/                                      Scalar_t* work)     /*--*/
 /*--*/                                                          /*--*/
+/*--  Operates on a tile of EP_TILE nodes (see idx_tile()).       --*/
 /*----------------------------------------------------------------- */
 {
 
   Scalar_t upwind = 1.0;
 
   Scalar_t *restrict flux;
-  Index_t species, energy, mu;
-  Scalar_t cce;
+  Index_t species, energy, mu, lane;
+  Scalar_t cce, v;
 
-  flux = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * (NUM_MUSTEPS+1));
+  flux = work;
 
   // First, compute "half-mesh" inner fluxes.
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
       for (mu = 1; mu < NUM_MUSTEPS; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-      cce = copysign(upwind,v_avg[idx_spemp1(species,energy,mu)]);
-      flux[idx_spemp1(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu)]
-             * 0.5 * ( (1.0 - cce) * f[idx_spem(species,energy,mu  )]
-                    +   (1.0 + cce) * f[idx_spem(species,energy,mu-1)]);
+          v = v_avg[idx_tile(idx_spemp1(species,energy,mu),lane)];
+          cce = copysign(upwind,v);
+          flux[idx_tile(idx_spemp1(species,energy,mu),lane)] = v
+             * 0.5 * ( (1.0 - cce) * f[idx_tile(idx_spem(species,energy,mu  ),lane)]
+                   +   (1.0 + cce) * f[idx_tile(idx_spem(species,energy,mu-1),lane)]);
 
+        }
       }
     }
   }
@@ -2278,10 +2771,13 @@ Scalar_t leaving_rightGlobal = 0;
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
       for (mu = 1; mu < NUM_MUSTEPS-1; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-        f1[idx_spem(species,energy,mu)]=(flux[idx_spemp1(species,energy,mu+1)] -
-                                         flux[idx_spemp1(species,energy,mu  )])/dmu;
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] =
+            (flux[idx_tile(idx_spemp1(species,energy,mu+1),lane)] -
+             flux[idx_tile(idx_spemp1(species,energy,mu  ),lane)])/dmu;
 
+        }
       }
     }
   }
@@ -2291,40 +2787,7 @@ Scalar_t leaving_rightGlobal = 0;
   // For inflow, allow stuff to enter boundary cell, but not leave it.
   // For outflow, allow stuff to leave boundary, nothing enters.
 
-  for (species = 0; species < NUM_SPECIES; species++) {
-    for (energy = 0; energy < NUM_ESTEPS; energy++) {
-
-      // Left boundary
-
-      mu = 0;
-
-      if (v_avg[idx_spemp1(species,energy,mu+1)] <= 0) {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu+1)]
-                                             *f[idx_spem(species,energy,mu+1)]/dmu;
-      }
-      else
-      {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu+1)]
-                                             *f[idx_spem(species,energy,mu)]/dmu;
-      }
-
-      // Right boundary
-
-      mu = NUM_MUSTEPS-1;
-
-      if (v_avg[idx_spemp1(species,energy,mu)] >= 0) {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu)]
-                                           *(-f[idx_spem(species,energy,mu-1)])/dmu;
-      }
-      else
-      {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu)]
-                                           *(-f[idx_spem(species,energy,mu)])/dmu;
-      }
-    }
-  }
-
-  free(flux);
+  AdiabaticFocusing_Boundary(f1,f,v_avg);
 
 }
 /*-------- END AdiabaticFocusing_Operator_Upwind()------------------*/
@@ -2335,9 +2798,11 @@ Scalar_t leaving_rightGlobal = 0;
 /*--*/    void                                                  /*--*/
 /*--*/    AdiabaticFocusing_Operator_WENO3(Scalar_t* f1,        /*--*/
 /*--*/                                     Scalar_t* f,         /*--*/
-/*--*/                                     Scalar_t* v_avg)     /*--*/
+/*--*/                                     Scalar_t* v_avg,     /*--*/
+/*--*/                                     Scalar_t* work)      /*--*/
 /*--*/                                                          /*--*/
 /*--  Does Weno3 and returns recompute vector                     --*/
+/*--  Operates on a tile of EP_TILE nodes (see idx_tile()).       --*/
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 {
@@ -2354,15 +2819,16 @@ Scalar_t leaving_rightGlobal = 0;
   Scalar_t D_P_Tt;
   Scalar_t D_MC_Tt;
   Scalar_t vel_abs_max = 0.0;
-  Scalar_t cce;
+  Scalar_t cce, v;
 
   Scalar_t p0m, p1m, p0p, p1p;
+  Scalar_t d0m, d1m, d0p, d1p;
   Scalar_t B0m, B1m, B0p, B1p;
   Scalar_t w0m, w1m, w0p, w1p;
   Scalar_t wm_sum, wp_sum;
   Scalar_t OM0m, OM1m, OM0p, OM1p;
   Scalar_t um, up;
-  Index_t species, energy, mu;
+  Index_t species, energy, mu, lane, k, kmin, kmax;
 
   D_C_CPt = 1/2.0;
   D_C_MCt = 1/2.0;
@@ -2372,10 +2838,10 @@ Scalar_t leaving_rightGlobal = 0;
   D_MC_Tt = 2/3.0;
   weno_eps = 10.0*sqrt(DBL_MIN);
 
-  flux  = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * (NUM_MUSTEPS+1));
-  LP    = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
-  LN    = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
-  alpha = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
+  flux  = work;
+  LP    = flux + EP_TILE * NUM_SPECIES * NUM_ESTEPS * (NUM_MUSTEPS+1);
+  LN    = LP + EP_TILE * SPEM;
+  alpha = LN + EP_TILE * SPEM;
 
 /* ****** Get alpha ****** */
 
@@ -2385,79 +2851,50 @@ Scalar_t leaving_rightGlobal = 0;
    X    O    X    O    X    O    X    O    X    O    X
    0    0    1    1    2    2    3    3    NE-1 NE-1 NE
    (v_avg,flux on X), (alpha,LP/N,f,f1 on O)
+
+   alpha is the largest |v_avg| over half-mesh points mu-2 through
+   mu+3, clipped to the ends of the extended mesh.
 */
 
-/* ***** Get inner points. */
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
-      for (mu = 2; mu < NUM_MUSTEPS-2; mu++) {
-        vel_abs_max =
-            fabs(v_avg[idx_spemp1(species,energy,mu  )]);
-        if (fabs(v_avg[idx_spemp1(species,energy,mu-1)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu-1)]);
-        if (fabs(v_avg[idx_spemp1(species,energy,mu-2)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu-2)]);
-        if (fabs(v_avg[idx_spemp1(species,energy,mu+1)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+1)]);
-        if (fabs(v_avg[idx_spemp1(species,energy,mu+2)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+2)]);
-        if (fabs(v_avg[idx_spemp1(species,energy,mu+3)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+3)]);
-
-        alpha[idx_spem(species,energy,mu)] = vel_abs_max;
-      }
-    }
-  }
+      for (mu = 0; mu < NUM_MUSTEPS; mu++) {
 
-  /* ***** Edge cases. */
+        kmin = (mu < 2) ? -mu : -2;
+        kmax = (NUM_MUSTEPS - mu < 3) ? NUM_MUSTEPS - mu : 3;
 
-  for (species = 0; species < NUM_SPECIES; species++) {
-    for (energy = 0; energy < NUM_ESTEPS; energy++) {
-      mu = 0;
-      vel_abs_max =
-          fabs(v_avg[idx_spemp1(species,energy,mu  )]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu+1)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+1)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu+2)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+2)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu+3)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+3)]);
-
-      alpha[idx_spem(species,energy,mu)] = vel_abs_max;
-
-      mu = 1;
-      vel_abs_max =
-          fabs(v_avg[idx_spemp1(species,energy,mu  )]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu-1)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu-1)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu+1)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+1)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu+2)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+2)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu+3)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+3)]);
-
-      alpha[idx_spem(species,energy,mu)] = vel_abs_max;
-
-      mu = NUM_MUSTEPS-2;
-      vel_abs_max =
-          fabs(v_avg[idx_spemp1(species,energy,mu)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu+1)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+1)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu+2)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+2)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu-1)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu-1)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu-2)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu-2)]);
-
-      alpha[idx_spem(species,energy,mu)] = vel_abs_max;
-
-      mu = NUM_MUSTEPS-1;
-      vel_abs_max =
-          fabs(v_avg[idx_spemp1(species,energy,mu  )]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu+1)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu+1)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu-1)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu-1)]);
-      if (fabs(v_avg[idx_spemp1(species,energy,mu-2)]) > vel_abs_max) vel_abs_max = fabs(v_avg[idx_spemp1(species,energy,mu-2)]);
-
-      alpha[idx_spem(species,energy,mu)] = vel_abs_max;
+        for (lane = 0; lane < EP_TILE; lane++) {
+
+          vel_abs_max = fabs(v_avg[idx_tile(idx_spemp1(species,energy,mu),lane)]);
+
+          for (k = kmin; k <= kmax; k++) {
+            v = fabs(v_avg[idx_tile(idx_spemp1(species,energy,mu+k),lane)]);
+            if (v > vel_abs_max) vel_abs_max = v;
+          }
+
+          alpha[idx_tile(idx_spem(species,energy,mu),lane)] = vel_abs_max;
+
+        }
+      }
     }
   }
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
       for (mu = 0; mu < NUM_MUSTEPS; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-        LP[idx_spem(species,energy,mu)] = 0.5 * f[idx_spem(species,energy,mu)] *
-          v_avg[idx_spemp1(species,energy,mu+1)] - alpha[idx_spem(species,energy,mu)];
+          LP[idx_tile(idx_spem(species,energy,mu),lane)] =
+            0.5 * f[idx_tile(idx_spem(species,energy,mu),lane)] *
+            v_avg[idx_tile(idx_spemp1(species,energy,mu+1),lane)]
+            - alpha[idx_tile(idx_spem(species,energy,mu),lane)];
 
-        LN[idx_spem(species,energy,mu)] = 0.5 * f[idx_spem(species,energy,mu)] *
-          v_avg[idx_spemp1(species,energy,mu)] + alpha[idx_spem(species,energy,mu)];
+          LN[idx_tile(idx_spem(species,energy,mu),lane)] =
+            0.5 * f[idx_tile(idx_spem(species,energy,mu),lane)] *
+            v_avg[idx_tile(idx_spemp1(species,energy,mu),lane)]
+            + alpha[idx_tile(idx_spem(species,energy,mu),lane)];
 
+        }
       }
     }
   }
@@ -2465,36 +2902,50 @@ Scalar_t leaving_rightGlobal = 0;
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
       for (mu = 2; mu < NUM_MUSTEPS-1; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
+
+          p0m = (1.0 + D_C_MCt)*LN[idx_tile(idx_spem(species,energy,mu-1),lane)]
+                       - D_C_MCt*LN[idx_tile(idx_spem(species,energy,mu-2),lane)];
+          p1m =          D_C_MCt*LN[idx_tile(idx_spem(species,energy,mu-1),lane)]
+                       + D_C_CPt*LN[idx_tile(idx_spem(species,energy,mu  ),lane)];
+          p0p = (1.0 + D_C_CPt)*LP[idx_tile(idx_spem(species,energy,mu  ),lane)]
+                       - D_C_CPt*LP[idx_tile(idx_spem(species,energy,mu+1),lane)];
+          p1p =          D_C_CPt*LP[idx_tile(idx_spem(species,energy,mu  ),lane)]
+                       + D_C_MCt*LP[idx_tile(idx_spem(species,energy,mu-1),lane)];
+
+          d0m = D_C_MCt*(LN[idx_tile(idx_spem(species,energy,mu-1),lane)]
+                       - LN[idx_tile(idx_spem(species,energy,mu-2),lane)]);
+          d1m = D_C_CPt*(LN[idx_tile(idx_spem(species,energy,mu  ),lane)]
+                       - LN[idx_tile(idx_spem(species,energy,mu-1),lane)]);
+          d0p = D_C_CPt*(LP[idx_tile(idx_spem(species,energy,mu+1),lane)]
+                       - LP[idx_tile(idx_spem(species,energy,mu  ),lane)]);
+          d1p = D_C_MCt*(LP[idx_tile(idx_spem(species,energy,mu  ),lane)]
+                       - LP[idx_tile(idx_spem(species,energy,mu-1),lane)]);
+
+          B0m = 4.0*(d0m*d0m);
+          B1m = 4.0*(d1m*d1m);
+          B0p = 4.0*(d0p*d0p);
+          B1p = 4.0*(d1p*d1p);
+
+          w0m = D_P_Tt /((weno_eps + B0m)*(weno_eps + B0m));
+          w1m = D_MC_Tt/((weno_eps + B1m)*(weno_eps + B1m));
+          w0p = D_M_Tt /((weno_eps + B0p)*(weno_eps + B0p));
+          w1p = D_CP_Tt/((weno_eps + B1p)*(weno_eps + B1p));
+
+          wm_sum = w0m + w1m;
+          wp_sum = w0p + w1p;
+
+          OM0m = w0m/wm_sum;
+          OM1m = w1m/wm_sum;
+          OM0p = w0p/wp_sum;
+          OM1p = w1p/wp_sum;
+
+          um = OM0m*p0m + OM1m*p1m;
+          up = OM0p*p0p + OM1p*p1p;
+
+          flux[idx_tile(idx_spemp1(species,energy,mu),lane)] = up + um;
 
-        p0m = (1.0 + D_C_MCt)*LN[idx_spem(species,energy,mu-1)] - D_C_MCt*LN[idx_spem(species,energy,mu-2)];
-        p1m =         D_C_MCt *LN[idx_spem(species,energy,mu-1)] + D_C_CPt*LN[idx_spem(species,energy,mu  )];
-        p0p = (1.0 + D_C_CPt)*LP[idx_spem(species,energy,mu  )] - D_C_CPt*LP[idx_spem(species,energy,mu+1)];
-        p1p =         D_C_CPt *LP[idx_spem(species,energy,mu  )] + D_C_MCt*LP[idx_spem(species,energy,mu-1)];
-
-        B0m = 4.0*pow((D_C_MCt*(LN[idx_spem(species,energy,mu-1)] - LN[idx_spem(species,energy,mu-2)])),2);
-        B1m = 4.0*pow((D_C_CPt*(LN[idx_spem(species,energy,mu  )] - LN[idx_spem(species,energy,mu-1)])),2);
-        B0p = 4.0*pow((D_C_CPt*(LP[idx_spem(species,energy,mu+1)] - LP[idx_spem(species,energy,mu  )])),2);
-        B1p = 4.0*pow((D_C_MCt*(LP[idx_spem(species,energy,mu  )] - LP[idx_spem(species,energy,mu-1)])),2);
-
-
-        w0m = D_P_Tt /pow((weno_eps + B0m),2);
-        w1m = D_MC_Tt/pow((weno_eps + B1m),2);
-        w0p = D_M_Tt /pow((weno_eps + B0p),2);
-        w1p = D_CP_Tt/pow((weno_eps + B1p),2);
-
-        wm_sum = w0m + w1m;
-        wp_sum = w0p + w1p;
-
-        OM0m = w0m/wm_sum;
-        OM1m = w1m/wm_sum;
-        OM0p = w0p/wp_sum;
-        OM1p = w1p/wp_sum;
-
-        um = OM0m*p0m + OM1m*p1m;
-        up = OM0p*p0p + OM1p*p1p;
-
-        flux[idx_spemp1(species,energy,mu)] = up + um;
-
+        }
       }
     }
   }
@@ -2503,31 +2954,38 @@ Scalar_t leaving_rightGlobal = 0;
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
+      for (lane = 0; lane < EP_TILE; lane++) {
 
-      mu = 1;
+        mu = 1;
 
-      cce = copysign(upwind,v_avg[idx_spemp1(species,energy,mu)]);
-      flux[idx_spemp1(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu)]
-             * 0.5 * ( (1.0 - cce) * f[idx_spem(species,energy,mu  )]
-                   +   (1.0 + cce) * f[idx_spem(species,energy,mu-1)]);
+        v = v_avg[idx_tile(idx_spemp1(species,energy,mu),lane)];
+        cce = copysign(upwind,v);
+        flux[idx_tile(idx_spemp1(species,energy,mu),lane)] = v
+               * 0.5 * ( (1.0 - cce) * f[idx_tile(idx_spem(species,energy,mu  ),lane)]
+                     +   (1.0 + cce) * f[idx_tile(idx_spem(species,energy,mu-1),lane)]);
 
-      mu = NUM_MUSTEPS-1;
+        mu = NUM_MUSTEPS-1;
 
-      cce = copysign(upwind,v_avg[idx_spemp1(species,energy,mu)]);
-      flux[idx_spemp1(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu)]
-             * 0.5 * ( (1.0 - cce) * f[idx_spem(species,energy,mu  )]
-                   +   (1.0 + cce) * f[idx_spem(species,energy,mu-1)]);
+        v = v_avg[idx_tile(idx_spemp1(species,energy,mu),lane)];
+        cce = copysign(upwind,v);
+        flux[idx_tile(idx_spemp1(species,energy,mu),lane)] = v
+               * 0.5 * ( (1.0 - cce) * f[idx_tile(idx_spem(species,energy,mu  ),lane)]
+                     +   (1.0 + cce) * f[idx_tile(idx_spem(species,energy,mu-1),lane)]);
 
+      }
     }
   }
 
   for (species = 0; species < NUM_SPECIES; species++) {
     for (energy = 0; energy < NUM_ESTEPS; energy++) {
       for (mu = 1; mu < NUM_MUSTEPS-1; mu++) {
+        for (lane = 0; lane < EP_TILE; lane++) {
 
-        f1[idx_spem(species,energy,mu)]=(flux[idx_spemp1(species,energy,mu+1)] -
-                                         flux[idx_spemp1(species,energy,mu  )])/dmu;
+          f1[idx_tile(idx_spem(species,energy,mu),lane)] =
+            (flux[idx_tile(idx_spemp1(species,energy,mu+1),lane)] -
+             flux[idx_tile(idx_spemp1(species,energy,mu  ),lane)])/dmu;
 
+        }
       }
     }
   }
@@ -2537,43 +2995,7 @@ Scalar_t leaving_rightGlobal = 0;
   // For inflow, allow stuff to enter boundary cell, but not leave it.
   // For outflow, allow stuff to leave boundary, nothing enters.
 
-  for (species = 0; species < NUM_SPECIES; species++) {
-    for (energy = 0; energy < NUM_ESTEPS; energy++) {
-
-      // Left boundary
-
-      mu = 0;
-
-      if (v_avg[idx_spemp1(species,energy,mu+1)] <= 0) {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu+1)]
-                                          *f[idx_spem(species,energy,mu+1)]/dmu;
-      }
-      else
-      {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu+1)]
-                                          *f[idx_spem(species,energy,mu)]/dmu;
-      }
-
-      // Right boundary
-
-      mu = NUM_MUSTEPS-1;
-
-      if (v_avg[idx_spemp1(species,energy,mu)] >= 0) {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu)]
-                                          *(-f[idx_spem(species,energy,mu-1)])/dmu;
-      }
-      else
-      {
-        f1[idx_spem(species,energy,mu)] = v_avg[idx_spemp1(species,energy,mu)]
-                                          *(-f[idx_spem(species,energy,mu)])/dmu;
-      }
-    }
-  }
-
-  free(flux);
-  free(LP);
-  free(LN);
-  free(alpha);
+  AdiabaticFocusing_Boundary(f1,f,v_avg);
 
 } /*-------- END AdiabaticFocusing_Operator_WENO3( ) -----------------*/
 /*------------------------------------------------------------------*/
@@ -2588,18 +3010,16 @@ Scalar_t leaving_rightGlobal = 0;
 /*------------------------------------------------------------------*/
 {/*-----------------------------------------------------------------*/
 
-  Index_t shell, down, up, workIndex;
+  Index_t shell, down, up;
   Index_t shellP;
   Vec_t r0, r1;
   Scalar_t dsh;
   Scalar_t dshmin;
 
-  workIndex = mpi_rank + N_PROCS * iterIndex;
-
   dshmin = config.dsh_min;
   
   // check if this process received work
-  if (workIndex < NUM_STREAMS)
+  if (iterIndex < RANK_NUM_STREAMS(mpi_rank))
   {
 
     // initialize variables and arrays
@@ -2675,38 +3095,62 @@ Scalar_t leaving_rightGlobal = 0;
 
   Index_t   shell, workIndex, face, row, col;
   Index_t   nsteps, step, species, energy, mu, slist;
+  Index_t   numLevels, cycle, substep, lev, n, last, nIso;
   Scalar_t  NUM_MUSTEPS_I;
   Scalar_t  dtMin, dtProp,dtProp_i,vgrid_current,vgrid_current_i;
-  Scalar_t  del_fac, iso, tau, rig;
+  Scalar_t  dtCell, dtCell_i, weight;
+  Scalar_t  exp_iso, del_fac_plus, del_fac_minus, inflow;
+  Scalar_t  del_fac, iso, tau, rig, courant;
 
   Scalar_t  *restrict f_old,          *restrict f_new;
-  Scalar_t  *restrict iso_vec;
+  Scalar_t  *restrict iso_vec,        *restrict flux_sum;
+  Scalar_t  *restrict f_iso;
   Scalar_t  *restrict sep_seed_vec,   *restrict ds_i_multiplier_vec;
   Scalar_t  *restrict exp_mdt_tau_vec,*restrict del_fac_vec;
+  Index_t   *restrict level,          *restrict cellOrder;
+  Index_t   *restrict faceOrder;
+  Index_t   *restrict cellStart,      *restrict faceStart;
+  size_t    mark;
 
   const double one  = 1.0;
 
   NUM_MUSTEPS_I = one/NUM_MUSTEPS;
 
-  workIndex = mpi_rank + N_PROCS * iterIndex;
-
-  if (workIndex < NUM_STREAMS)
+  if (iterIndex < RANK_NUM_STREAMS(mpi_rank))
   {
 
-    face = computeLines[workIndex][0];
-    row  = computeLines[workIndex][1];
-    col  = computeLines[workIndex][2];
+    workIndex = WORK_INDEX(mpi_rank, iterIndex);
+
+    face = computeLines[GROUP_STREAM(workIndex)][0];
+    row  = computeLines[GROUP_STREAM(workIndex)][1];
+    col  = computeLines[GROUP_STREAM(workIndex)][2];
 //
-// ****** Allocate temporary arrays ******
+// ****** Take temporary arrays from the workspace ******
 //
-    f_old = malloc(streamlistSize*NUM_MUSTEPS*sizeof(Scalar_t));
-    f_new = malloc(streamlistSize*NUM_MUSTEPS*sizeof(Scalar_t));
-
-    sep_seed_vec         = malloc(3*sizeof(Scalar_t));
-    ds_i_multiplier_vec  = malloc(streamlistSize*sizeof(Scalar_t));
-    exp_mdt_tau_vec      = malloc(streamlistSize*sizeof(Scalar_t));
-    iso_vec              = malloc(streamlistSize*sizeof(Scalar_t));
-    del_fac_vec          = malloc(NUM_MUSTEPS*sizeof(Scalar_t));
+    mark  = workspaceMark();
+    f_old = workspaceAlloc(streamlistSize*NUM_MUSTEPS*sizeof(Scalar_t));
+    f_new = workspaceAlloc(streamlistSize*NUM_MUSTEPS*sizeof(Scalar_t));
+
+    sep_seed_vec         = workspaceAlloc(3*sizeof(Scalar_t));
+    ds_i_multiplier_vec  = workspaceAlloc(streamlistSize*sizeof(Scalar_t));
+    exp_mdt_tau_vec      = workspaceAlloc(streamlistSize*sizeof(Scalar_t));
+    iso_vec              = workspaceAlloc(streamlistSize*sizeof(Scalar_t));
+    f_iso                = workspaceAlloc(streamlistSize*sizeof(Scalar_t));
+    del_fac_vec          = workspaceAlloc(NUM_MUSTEPS*sizeof(Scalar_t));
+
+    flux_sum  = workspaceAlloc(streamlistSize*NUM_MUSTEPS*sizeof(Scalar_t));
+    level     = workspaceAlloc(streamlistSize*sizeof(Index_t));
+    cellOrder = workspaceAlloc(streamlistSize*sizeof(Index_t));
+    faceOrder = workspaceAlloc(streamlistSize*sizeof(Index_t));
+    cellStart = workspaceAlloc((config.streamStepLevels + 2)*sizeof(Index_t));
+    faceStart = workspaceAlloc((config.streamStepLevels + 2)*sizeof(Index_t));
+
+    last = streamlistSize - 1;
+
+    if (config.isotropicTauRatio > 0.0)
+      exp_iso = exp(-one/config.isotropicTauRatio);
+    else
+      exp_iso = 0.0;
 //
 // ****** Pre-load independent calculations invloving mu.
 //
@@ -2722,32 +3166,68 @@ Scalar_t leaving_rightGlobal = 0;
         vgrid_current_i = one/vgrid[energy];
         rig             =  rigidity[energy];
 //
-// ****** Compute stable time-step for explicit Euler sub-cycles.
+// ****** Compute stable time-step for explicit Euler sub-cycles, or
+// ****** the time-step for the implicit ones, which are stable at any
+// ****** step but lose accuracy at large Courant numbers.
 //
-        dtMin    = 0.4*dsMin*vgrid_current_i;
+        if (config.useImplicitStreaming > 0)
+          dtMin  = config.implicitStreamCfl*dsMin*vgrid_current_i;
+        else
+          dtMin  = 0.4*dsMin*vgrid_current_i;
         nsteps   = (Index_t) floor(dt/dtMin + one);
+//
+// ****** With local time-stepping, a cell whose width is 2^k times
+// ****** the shortest segment takes sub-cycles 2^k times as long, up
+// ****** to 2^numLevels. The number of the shortest sub-cycles is
+// ****** rounded up to whole cycles of the longest.
+//
+        numLevels = 0;
+        if ( (config.streamStepLevels > 0) && (config.useImplicitStreaming == 0) )
+        {
+          while ( (numLevels < config.streamStepLevels) && ((2 << numLevels) <= nsteps) )
+            numLevels++;
+        }
+        cycle    = 1 << numLevels;
+        nsteps   = cycle*((nsteps + cycle - 1)/cycle);
         dtProp   = dt/(one*nsteps);
         dtProp_i = one/dtProp;
 //
+// ****** Keep the cells of the inner boundary seed on the shortest
+// ****** sub-cycle, since the seed is set at every one.
+//
+        for (slist = 0; slist < streamlistSize;  slist++)
+        {
+          level[slist] = 0;
+          if (slist >= 3)
+          {
+            while ( (level[slist] < numLevels) &&
+                    (ds[slist] >= (2 << level[slist])*dsMin) )
+              level[slist]++;
+          }
+        }
+//
 // ****** Pre-load sub-cycle-step independent values.
 //
         for (slist = 0; slist < streamlistSize;  slist++)
         {
           shell = shellList[slist];
 
+          dtCell   = dtProp*(1 << level[slist]);
+          dtCell_i = dtProp_i/(1 << level[slist]);
+
 // ****** Modifiy multiplier based on time-scale of mean-free-path.
           tau = vgrid_current_i*rig*pow(streamGrid[shell].rmag*config.rScale,
                                         config.mfpRadialPower)*config.lamo;
 //          tau = vgrid_current_i*rig*config.lamo;
 //          tau = vgrid_current_i*rig*(config.mhdBsAu/streamGrid[shell].mhdBmag)*config.lamo;
-          if (dtProp > tau){
-             ds_i_multiplier_vec[slist] = ds_i[slist]*tau*dtProp_i;
+          if (dtCell > tau){
+             ds_i_multiplier_vec[slist] = ds_i[slist]*tau*dtCell_i;
           }else{
              ds_i_multiplier_vec[slist] = ds_i[slist]*one;
           }
 
 // ****** Pre-compute expensive operations used in isotropize.
-          exp_mdt_tau_vec[slist] = exp(-dtProp/tau);
+          exp_mdt_tau_vec[slist] = exp(-dtCell/tau);
         }
 
 // ****** Save initial seed population [for use with BCs].
@@ -2762,6 +3242,32 @@ Scalar_t leaving_rightGlobal = 0;
           del_fac_vec[mu] = vgrid_current*dtProp*mugrid[mu];
         }
 //
+// ****** With isotropicTauRatio, the inner cells that scatter within a
+// ****** fraction of the sub-cycle (those with tau < isotropicTauRatio
+// ****** * dtProp) are isotropic after every sub-cycle, up to
+// ****** exp(-dtProp/tau). Those cells, up to the first one that does
+// ****** not, hold only the isotropic part f_iso, and the advection
+// ****** step averaged over mu becomes a three-point diffusion of it.
+// ****** The outermost cell always keeps its mu levels.
+//
+        nIso = 0;
+        if ( (config.isotropicTauRatio > 0.0) && (numLevels == 0) &&
+             (config.useImplicitStreaming == 0) )
+        {
+          while ( (nIso < last) && (exp_mdt_tau_vec[nIso] < exp_iso) )
+            nIso++;
+        }
+
+        del_fac_plus  = 0.0;
+        del_fac_minus = 0.0;
+        for (mu = 0; mu < NUM_MUSTEPS; mu++)
+        {
+          if ( mugrid[mu] >= 0.0 )
+            del_fac_plus  = del_fac_plus  + NUM_MUSTEPS_I*del_fac_vec[mu];
+          else
+            del_fac_minus = del_fac_minus - NUM_MUSTEPS_I*del_fac_vec[mu];
+        }
+//
 // ****** Load stream data into stride-1 arrays (for speed).
 //
         for (mu = 0; mu < NUM_MUSTEPS; mu++)
@@ -2772,6 +3278,152 @@ Scalar_t leaving_rightGlobal = 0;
               ePartsStream[idx_sspem(shellList[slist],species,energy,mu)];
           }
         }
+
+        for (slist = 0; slist < nIso; slist++)
+        {
+          f_iso[slist] = 0.0;
+          for (mu = 0; mu < NUM_MUSTEPS; mu++)
+          {
+            f_iso[slist] = f_iso[slist] + f_old[streamlistSize*mu + slist];
+          }
+          f_iso[slist] = NUM_MUSTEPS_I*f_iso[slist];
+        }
+//
+// *********************************************************************
+// ****** Local time-stepping: integrate each cell with the sub-cycle
+// ****** of its level. Every face takes the sub-cycle of the finer of
+// ****** its cells and adds the upwind value times its length to the
+// ****** flux sum of the downwind cell, which a cell uses up when it
+// ****** steps. Both cells of a face thus see the same flux over any
+// ****** cycle, and with one level this is the Euler sub-cycle below.
+// *********************************************************************
+//
+        if (numLevels > 0)
+        {
+//
+// ****** Sort the cells and faces by level.
+//
+          for (lev = 0; lev <= numLevels + 1; lev++)
+          {
+            cellStart[lev] = 0;
+            faceStart[lev] = 0;
+          }
+
+          for (slist = 0; slist < streamlistSize; slist++)
+          {
+            cellStart[level[slist] + 1]++;
+            if (slist < last)
+              faceStart[FACE_LEVEL(slist) + 1]++;
+          }
+
+          for (lev = 0; lev <= numLevels; lev++)
+          {
+            cellStart[lev + 1] += cellStart[lev];
+            faceStart[lev + 1] += faceStart[lev];
+          }
+
+          for (slist = 0; slist < streamlistSize; slist++)
+          {
+            cellOrder[cellStart[level[slist]]++] = slist;
+            if (slist < last)
+              faceOrder[faceStart[FACE_LEVEL(slist)]++] = slist;
+          }
+
+          for (lev = numLevels; lev > 0; lev--)
+          {
+            cellStart[lev] = cellStart[lev - 1];
+            faceStart[lev] = faceStart[lev - 1];
+          }
+          cellStart[0] = 0;
+          faceStart[0] = 0;
+
+          for (slist = 0; slist < streamlistSize*NUM_MUSTEPS; slist++)
+            flux_sum[slist] = 0.0;
+
+          for ( step = 0; step < nsteps; step++ )
+          {
+            substep = step % cycle;
+//
+// ****** Set the boundary condition.
+//
+            if ( (config.useEPBoundary > 0) && (config.useBoundaryFunction > 0) )
+            {
+              for (mu = 0; mu < NUM_MUSTEPS; mu++ )
+              {
+                for (slist = 0 ; slist < 3;  slist++ )
+                {
+                  f_old[streamlistSize*mu + slist] = sep_seed_vec[slist];
+                }
+              }
+            }
+//
+// ****** Add up the flux through the faces whose sub-cycle starts now.
+//
+            for (lev = 0; (lev <= numLevels) && (substep % (1 << lev) == 0); lev++)
+            {
+              weight = 1 << lev;
+
+              for (n = faceStart[lev]; n < faceStart[lev + 1]; n++)
+              {
+                slist = faceOrder[n];
+
+                for ( mu = 0; mu < NUM_MUSTEPS; mu++ )
+                {
+                  if ( mugrid[mu] >= 0.0 )
+                    flux_sum[streamlistSize*mu + slist + 1] +=
+                      weight*f_old[streamlistSize*mu + slist];
+                  else
+                    flux_sum[streamlistSize*mu + slist] +=
+                      weight*f_old[streamlistSize*mu + slist + 1];
+                }
+              }
+            }
+//
+// ****** Step the cells whose sub-cycle ends now: the upwinded
+// ****** advection step, then isotropize across mu levels.
+//
+            for (lev = 0; (lev <= numLevels) && ((substep + 1) % (1 << lev) == 0); lev++)
+            {
+              weight = 1 << lev;
+
+              for (n = cellStart[lev]; n < cellStart[lev + 1]; n++)
+              {
+                slist = cellOrder[n];
+                iso_vec[slist] = 0.0;
+
+                for ( mu = 0; mu < NUM_MUSTEPS; mu++ )
+                {
+                  courant = ds_i_multiplier_vec[slist] * del_fac_vec[mu];
+
+                  if ( (mugrid[mu] >= 0.0) && (slist > 0) )
+                    f_new[streamlistSize*mu + slist] =
+                             f_old[streamlistSize*mu + slist]
+                           + courant * ( flux_sum[streamlistSize*mu + slist]
+                                       - weight*f_old[streamlistSize*mu + slist] );
+                  else if ( (mugrid[mu] < 0.0) && (slist < last) )
+                    f_new[streamlistSize*mu + slist] =
+                             f_old[streamlistSize*mu + slist]
+                           - courant * ( flux_sum[streamlistSize*mu + slist]
+                                       - weight*f_old[streamlistSize*mu + slist] );
+                  else
+                    f_new[streamlistSize*mu + slist] = f_old[streamlistSize*mu + slist];
+
+                  flux_sum[streamlistSize*mu + slist] = 0.0;
+                  iso_vec[slist] = iso_vec[slist] + f_new[streamlistSize*mu + slist];
+                }
+
+                iso = NUM_MUSTEPS_I*iso_vec[slist];
+
+                for ( mu = 0; mu < NUM_MUSTEPS; mu++ )
+                {
+                  f_old[streamlistSize*mu + slist] = iso +
+                   (f_new[streamlistSize*mu + slist] - iso) * exp_mdt_tau_vec[slist];
+                }
+              }
+            }
+          } /*-- END OF LOCAL SUB-CYCLE STEPS --*/
+        }
+        else
 //
 // *********************************************************************
 // ****** Start integration of Euler sub-cycle.
@@ -2791,19 +3443,72 @@ Scalar_t leaving_rightGlobal = 0;
                 f_old[streamlistSize*mu + slist] = sep_seed_vec[slist];
               }
             }
+            for (slist = 0 ; (slist < 3) && (slist < nIso);  slist++ )
+            {
+              f_iso[slist] = sep_seed_vec[slist];
+            }
+          }
+//
+// ****** The outermost isotropic cell is upwind of the first cell
+// ****** that keeps its mu levels.
+//
+          if (nIso > 0)
+          {
+            for (mu = 0; mu < NUM_MUSTEPS; mu++ )
+            {
+              f_old[streamlistSize*mu + nIso - 1] = f_iso[nIso - 1];
+            }
           }
 //
-// ****** Apply the upwinded advection step.
+// ****** Apply the upwinded advection step, implicitly: each point
+// ****** depends on its new upwind neighbor, so one sweep from the
+// ****** upwind end solves the (bidiagonal) system.
 //
+          if (config.useImplicitStreaming > 0)
+          {
+            for ( mu = 0; mu < NUM_MUSTEPS; mu++ )
+            {
+              del_fac = del_fac_vec[mu];
+
+              if ( mugrid[mu] >= 0.0 ){
+                f_new[streamlistSize*mu] = f_old[streamlistSize*mu];
+
+                for ( slist = 1; slist < streamlistSize; slist++ )
+                {
+                  courant = ds_i_multiplier_vec[slist] * del_fac;
+                  f_new[streamlistSize*mu + slist] =
+                           ( f_old[streamlistSize*mu + slist]
+                           + courant * f_new[streamlistSize*mu + slist - 1] )
+                         / ( one + courant );
+                }
+              }
+              else
+              {
+                f_new[streamlistSize*mu + (streamlistSize-1)] =
+                f_old[streamlistSize*mu + (streamlistSize-1)];
+
+                for ( slist = streamlistSize - 2; slist >= 0; slist-- )
+                {
+                  courant = -ds_i_multiplier_vec[slist] * del_fac;
+                  f_new[streamlistSize*mu + slist] =
+                           ( f_old[streamlistSize*mu + slist]
+                           + courant * f_new[streamlistSize*mu + slist + 1] )
+                         / ( one + courant );
+                }
+              }
+            }
+          }
+          else
           for ( mu = 0; mu < NUM_MUSTEPS; mu++ )
           {
             del_fac = del_fac_vec[mu];
 
             if ( mugrid[mu] >= 0.0 ){
 // ****** Unroll slist=0 loop iteration to allow vectorization.
-              f_new[streamlistSize*mu] = f_old[streamlistSize*mu];
+              if (nIso == 0)
+                f_new[streamlistSize*mu] = f_old[streamlistSize*mu];
 
-              for ( slist = 1; slist < streamlistSize; slist++ )
+              for ( slist = (nIso > 0) ? nIso : 1; slist < streamlistSize; slist++ )
               {
                 f_new[streamlistSize*mu + slist] =
                          f_old[streamlistSize*mu + slist]
@@ -2818,7 +3523,7 @@ Scalar_t leaving_rightGlobal = 0;
               f_new[streamlistSize*mu + (streamlistSize-1)] =
               f_old[streamlistSize*mu + (streamlistSize-1)];
 
-              for ( slist = 0; slist < (streamlistSize-1); slist++ )
+              for ( slist = nIso; slist < (streamlistSize-1); slist++ )
               {
                 f_new[streamlistSize*mu + slist] =
                          f_old[streamlistSize*mu + slist]
@@ -2829,16 +3534,43 @@ Scalar_t leaving_rightGlobal = 0;
             }
           }
 //
+// ****** Diffuse the isotropic cells: the advection step averaged over
+// ****** mu, with the inward flux from the first cell with mu levels.
+//
+          if (nIso > 0)
+          {
+            inflow = 0.0;
+            for ( mu = 0; mu < NUM_MUSTEPS; mu++ )
+            {
+              if ( mugrid[mu] < 0.0 )
+                inflow = inflow - NUM_MUSTEPS_I*del_fac_vec[mu]
+                                * f_old[streamlistSize*mu + nIso];
+            }
+
+            for ( slist = 0 ; slist < nIso;  slist++ )
+            {
+              iso_vec[slist] = f_iso[slist] + ds_i_multiplier_vec[slist]
+                * ( ( (slist > 0) ? del_fac_plus*(f_iso[slist - 1] - f_iso[slist]) : 0.0 )
+                  + ( (slist + 1 < nIso) ? del_fac_minus*f_iso[slist + 1] : inflow )
+                  - del_fac_minus*f_iso[slist] );
+            }
+
+            for ( slist = 0 ; slist < nIso;  slist++ )
+            {
+              f_iso[slist] = iso_vec[slist];
+            }
+          }
+//
 // ****** Isotropize across mu levels.
 //
-          for ( slist = 0 ; slist < streamlistSize;  slist++ )
+          for ( slist = nIso ; slist < streamlistSize;  slist++ )
           {
             iso_vec[slist] = 0.0;
           }
 
           for ( mu = 0; mu < NUM_MUSTEPS; mu++ )
           {
-            for ( slist = 0 ; slist < streamlistSize;  slist++ )
+            for ( slist = nIso ; slist < streamlistSize;  slist++ )
             {
               iso_vec[slist] = iso_vec[slist] + f_new[streamlistSize*mu + slist];
             }
@@ -2846,7 +3578,7 @@ Scalar_t leaving_rightGlobal = 0;
 
           for ( mu = 0; mu < NUM_MUSTEPS; mu++ )
           {
-            for ( slist = 0 ; slist < streamlistSize;  slist++ )
+            for ( slist = nIso ; slist < streamlistSize;  slist++ )
             {
               iso = NUM_MUSTEPS_I*iso_vec[slist];
 
@@ -2858,6 +3590,14 @@ Scalar_t leaving_rightGlobal = 0;
         } /*-- END OF SUB-CYCLE STEPS --*/
 // *********************************************************************
 
+        for (mu = 0; mu < NUM_MUSTEPS; mu++)
+        {
+          for (slist = 0; slist < nIso; slist++)
+          {
+            f_old[streamlistSize*mu + slist] = f_iso[slist];
+          }
+        }
+
 //
 // ****** Load stream data back into eprem structure.
 // ****** This uses f_old since it has already been reset.
@@ -2901,15 +3641,9 @@ Scalar_t leaving_rightGlobal = 0;
       } /*-- ENERGY --*/
     } /*-- SPECIES --*/
 //
-// ****** Free temporary array memory.
+// ****** Hand the temporary arrays back to the workspace.
 //
-    free(f_old);
-    free(f_new);
-    free(sep_seed_vec);
-    free(ds_i_multiplier_vec);
-    free(exp_mdt_tau_vec);
-    free(del_fac_vec);
-    free(iso_vec);
+    workspaceRelease(mark);
 
   }
 
@@ -28,6 +28,14 @@
 extern "C" {
 #endif
 
+/*-- The adiabatic focusing and change kernels advance a     --*/
+/*-- tile of EP_TILE nodes on a shell together. Their scratch --*/
+/*-- arrays store the nodes of a tile side by side, so loops  --*/
+/*-- over the node (lane) index are innermost and vectorize.  --*/
+#define EP_TILE 8
+
+#define idx_tile(i,l) ((l)+(i)*EP_TILE)
+
 /*-- Evaluate current particle distributions for all energy --*/
 /*-- ranges, for all shells and every shell node in each.   --*/
 /*-- NB-The INNER_SHELL does not need to be included in the --*/
@@ -42,6 +50,8 @@ extern Index_t maxsubcycles_energychangeGlobal;
 extern Index_t maxsubcycles_focusingGlobal;
 extern Scalar_t min_tau;
 extern Scalar_t min_tau_global;
+extern Scalar_t nodes_energychange;
+extern Scalar_t quietnodes_energychange;
 
 extern Scalar_t leaving_left;
 extern Scalar_t leaving_right;
@@ -50,6 +60,10 @@ extern Scalar_t leaving_rightGlobal;
 
 void updateEnergeticParticles( void );
 
+/*-- Set up the per-thread EP solver workspaces. Call once,  --*/
+/*-- after allocateGlobalVariables().                         --*/
+void initEnergeticParticlesWorkspace( void );
+
 
 /*---------------------------------------------------------------*/
 /*---------------------------------------------------------------*/
@@ -108,7 +122,8 @@ void updateEnergeticParticles( void );
 /*--*/    AdiabaticChange_Operator_Upwind(Scalar_t *f1,         /*--*/
 /*--*/                                    Scalar_t *f,          /*--*/
 /*--*/                                    Scalar_t *v_avg,      /*--*/
-/*--*/                                    Node_t node);         /*--*/
+/*--*/                                    Scalar_t *seed,       /*--*/
+/*--*/                                    Scalar_t *work);      /*--*/
 /*--*/                                                          /*--*/
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
@@ -119,18 +134,20 @@ void updateEnergeticParticles( void );
 /*--*/    AdiabaticChange_Operator_WENO3(Scalar_t *f1,          /*--*/
 /*--*/                                   Scalar_t *f,           /*--*/
 /*--*/                                   Scalar_t *v_avg,       /*--*/
-/*--*/                                   Node_t node);          /*--*/
+/*--*/                                   Scalar_t *seed,        /*--*/
+/*--*/                                   Scalar_t *work);       /*--*/
 /*--*/                                                          /*--*/
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 
 /*------------------------------------------------------------------*/
-/*--*/     void                                                 /*--*/
-/*--*/     AdiabaticChange( Index_t face,                       /*--*/
-/*--*/                      Index_t row,                        /*--*/
-/*--*/                      Index_t col,                        /*--*/
-/*--*/                      Index_t shell,                      /*--*/
-/*--*/                      Scalar_t dt );                      /*--*/
+/*--*/     Index_t                                              /*--*/
+/*--*/     AdiabaticChange( Index_t shell,                      /*--*/
+/*--*/                      Index_t firstStream,                /*--*/
+/*--*/                      Index_t numNodes,                   /*--*/
+/*--*/                      const Scalar_t *dt );               /*--*/
+/*--                                                              --*/
+/*-- Evaluate the adiabatic change for a tile of nodes            --*/
 /*------------------------------------------------------------------*/
 
 /*------------------------------------------------------------------*/
@@ -162,14 +179,14 @@ void updateEnergeticParticles( void );
 
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
-/*--*/     void                                                 /*--*/
-/*--*/     AdiabaticFocusing( Index_t face,                     /*--*/
-/*--*/                        Index_t row,                      /*--*/
-/*--*/                        Index_t col,                      /*--*/
-/*--*/                        Index_t shell,                    /*--*/
-/*--*/                        Scalar_t dt );                    /*--*/
+/*--*/     Index_t                                              /*--*/
+/*--*/     AdiabaticFocusing( Index_t shell,                    /*--*/
+/*--*/                        Index_t firstStream,              /*--*/
+/*--*/                        Index_t numNodes,                 /*--*/
+/*--*/                        const Scalar_t *dt );             /*--*/
 /*--                                                              --*/
-/*-- Calculate adiabatic focusing along a stream                  --*/
+/*-- Calculate adiabatic focusing along a stream for a tile of    --*/
+/*-- nodes                                                        --*/
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 
@@ -178,7 +195,8 @@ void updateEnergeticParticles( void );
 /*--*/    void                                                  /*--*/
 /*--*/    AdiabaticFocusing_Operator_Upwind(Scalar_t *f1,       /*--*/
 /*--*/                                      Scalar_t *f,        /*--*/
-/*--*/                                      Scalar_t *v_avg);   /*--*/
+/*--*/                                      Scalar_t *v_avg,    /*--*/
+/*--*/                                      Scalar_t *work);    /*--*/
 /*--*/                                                          /*--*/
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
@@ -188,7 +206,8 @@ void updateEnergeticParticles( void );
 /*--*/    void                                                  /*--*/
 /*--*/    AdiabaticFocusing_Operator_WENO3(Scalar_t *f1,        /*--*/
 /*--*/                                     Scalar_t *f,         /*--*/
-/*--*/                                     Scalar_t *v_avg);    /*--*/
+/*--*/                                     Scalar_t *v_avg,     /*--*/
+/*--*/                                     Scalar_t *work);     /*--*/
 /*--*/                                                          /*--*/
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
@@ -57,14 +57,12 @@
 /*-----------------------------------------------------------------------------*/
 {/*----------------------------------------------------------------------------*/
 
-  Index_t workIndex, shell, species, energy, mu;
+  Index_t shell, species, energy, mu;
 
   Scalar_t distFunction;
 
 
-  workIndex = mpi_rank + N_PROCS * iterIndex;
-
-  if (workIndex < NUM_STREAMS)
+  if (iterIndex < RANK_NUM_STREAMS(mpi_rank))
   {
 
     for (shell = 0; shell < TOTAL_NUM_SHELLS; shell++) {
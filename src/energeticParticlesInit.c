@@ -83,10 +83,11 @@
     mugrid[mu] = half*(mup+mum);
   }
 
-  /*-- 4d loop for every node in every shell. --*/
+  /*-- 4d loop for every node in every shell stored on this rank. --*/
   for (face  = 0;              face  < NUM_FACES;  face++  ) {
     for (row   = 0;              row   < FACE_ROWS;  row++   ) {
       for (col   = 0;              col   < FACE_COLS;  col++   ) {
+        if (!LOCAL_NODE(face,row,col)) continue;
         for (shell = INNER_SHELL ;   shell < LOCAL_NUM_SHELLS; shell++ ) {
           for (species = 0;       species < NUM_SPECIES;  species++  ){
             for (energy  = 0;       energy  < NUM_ESTEPS;   energy++   ){
@@ -114,10 +115,11 @@
 
   /* initializes all node points to the VS distribution */
 
-  /*-- 4d loop for every node in every shell. --*/
+  /*-- 4d loop for every node in every shell stored on this rank. --*/
   for (face  = 0;              face  < NUM_FACES;  face++  ) {
     for (row   = 0;              row   < FACE_ROWS;  row++   ) {
       for (col   = 0;              col   < FACE_COLS;  col++   ) {
+        if (!LOCAL_NODE(face,row,col)) continue;
         for (shell = INNER_SHELL ;   shell < LOCAL_NUM_SHELLS; shell++ ) {
 
           /*-- 3d loop for every species/energy/mu --*/
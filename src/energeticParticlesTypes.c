@@ -61,7 +61,7 @@ Scalar_t *restrict rigidity; /*-- rigidity pc/q in GV    --*/
 
   /*-- mu steps [central mu]  --*/
   mugrid = (Scalar_t*)malloc(NUM_MUSTEPS*sizeof(Scalar_t));
-  dlPerMin = (Scalar_t*)malloc(LOCAL_NUM_SHELLS*sizeof(Scalar_t));
+  dlPerMin = (Scalar_t*)malloc(MAX_LOCAL_NUM_SHELLS*sizeof(Scalar_t));
 
 }
 /*----------------------------------------------------------*/
@@ -83,6 +83,7 @@
 #include "float.h"
 #include "simCore.h"
 #include "timers.h"
+#include "workspace.h"
 
 /* Initialize all global timers. */
 double timer_diffusestream=0;
@@ -106,6 +107,7 @@ int main(int argc, char *argv[]) {
 
   int epInit, rciter;
   double timer_tmp;
+  double nodeCounts[2], nodeCountsGlobal[2];
 
   // Initialize MPI
   initMPI(argc, argv);
@@ -116,18 +118,24 @@ int main(int argc, char *argv[]) {
   simStarted = 0;
 
   // Record the starting MPI time and real time.
-  if (mpi_rank == 0) time ( &start_time );
+  if (mpi_rank_world == 0) time ( &start_time );
   timer_start = MPI_Wtime();
 
   // Read and set runtime parameters
   initGlobalParameters(argv[1]);
 
+  // Split the ranks into face groups
+  initMPIFaceGroups();
+
   // Initialize MPI Offsets for Gatherv and Scatterv
   initMPIOffsets();
 
   // Memory allocation for the main global variables
   allocateGlobalVariables();
 
+  // Scratch workspaces for the energetic particle solver
+  initEnergeticParticlesWorkspace();
+
   // Initialize MPI Types
   // This also allocates the 1D scale grids (mu, energy, etc).
   initMPITypes();
@@ -161,20 +169,26 @@ int main(int argc, char *argv[]) {
   // and set node positions through backward integration.
   gridStructInit();
 
+  // Find the shell nodes this face group exchanges with the others
+  initFaceGroupHalo();
+
   // Create the names for the output files
   buildOutputNames();
 
   // Initialize unified netCDF output
   if (config.unifiedOutput > 0) initObserverDataNetCDF();
 
+  // The outputs below are written by world rank 0; the other face groups
+  // send it their streams (see dataDumpIO()).
+
   // Initialize point observer netCDF output
-  if (config.numObservers > 0) initPointObserverDataNetCDF();
+  if ((config.numObservers > 0) && (face_group == 0)) initPointObserverDataNetCDF();
 
   // Initialize netCDF file for domain output
-  if (config.epremDomain > 0) initDomainDumpNetCDF();
+  if ((config.epremDomain > 0) && (face_group == 0)) initDomainDumpNetCDF();
 
   // Initialize netCDF file for unstructured domain output
-  if (config.unstructuredDomain > 0) initUnstructuredDomainDumpNetCDF();
+  if ((config.unstructuredDomain > 0) && (face_group == 0)) initUnstructuredDomainDumpNetCDF();
 
   // Write the simulation params out to the screen and file
   RunParamsOut();
@@ -187,7 +201,7 @@ int main(int argc, char *argv[]) {
   // ------------------  MAIN SIMULATION LOOP  ---------------------------------
   // ---------------------------------------------------------------------------
   // ---------------------------------------------------------------------------
-  if(mpi_rank==0){
+  if(mpi_rank_world == 0){
     printf(" \n");
     printf("*************************************************\n");
     printf("****SEEDING NODES********************************\n");
@@ -212,7 +226,7 @@ int main(int argc, char *argv[]) {
         // Since seed function is r-dependent, this needs to be done
         // after pushing all nodes out to their initial positions.
         initEnergeticParticles();
-        if (mpi_rank == 0){
+        if (mpi_rank_world == 0){
           printf(" \n");
           printf("*************************************************\n");
           printf("****STARTING SIMULATION**************************\n");
@@ -229,7 +243,7 @@ int main(int argc, char *argv[]) {
     {
       if (simStarted == 1){
         simStarted = 2;
-        if (mpi_rank == 0){
+        if (mpi_rank_world == 0){
           printf(" \n");
           printf("*************************************************\n");
           printf("****STARTING ENERGETIC PARTICLE CALCULATIONS*****\n");
@@ -250,7 +264,7 @@ int main(int argc, char *argv[]) {
     // -------------------------------------------------------------------------
     // -------------------------------------------------------------------------
 
-    if (mpi_rank == 0){
+    if (mpi_rank_world == 0){
       printf("Step: %06d  TIME: %14.8e  [JD %9.5f]  DTIME: %14.8e  [JD %7.5f]\n",
              rciter, t_global, t_global*DAY, config.tDel, config.tDel*DAY);
     }
@@ -341,16 +355,21 @@ int main(int argc, char *argv[]) {
       // here.
       if (epInit == 0){
         epInit = 1;
-        if (mpi_rank == 0) printf("  --> NOTE:  Reinitializing seed population.\n");
+        if (mpi_rank_world == 0) printf("  --> NOTE:  Reinitializing seed population.\n");
         initEnergeticParticles();
       }
 
       updateEnergeticParticles();
 
+      // Move shells between ranks to even out the measured EP work.
+      if ((config.shellRebalanceInterval > 0) &&
+          ((rciter % config.shellRebalanceInterval) == 0))
+        rebalanceShells();
+
       // For the seed test, re-init seed population.
       if (config.seedFunctionTest > 0){
         initEnergeticParticles();
-        if (mpi_rank == 0) printf("  --> NOTE:  Reinitializing seed population.\n");
+        if (mpi_rank_world == 0) printf("  --> NOTE:  Reinitializing seed population.\n");
       }
 
       timer_eptotal = timer_eptotal + (MPI_Wtime() - timer_tmp);
@@ -380,10 +399,19 @@ int main(int argc, char *argv[]) {
                &min_tau_global,
                1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
 
-    if (mpi_rank == 0){
+    nodeCounts[0] = nodes_energychange;
+    nodeCounts[1] = quietnodes_energychange;
+    MPI_Reduce(nodeCounts,
+               nodeCountsGlobal,
+               2, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (mpi_rank_world == 0){
       printf("  --> Maximum subcycles for Adiabatic Change:   %d \n", maxsubcycles_energychangeGlobal);
       printf("  --> Maximum subcycles for Adiabatic Focusing: %d \n", maxsubcycles_focusingGlobal);
       printf("  --> Minimum MFP timescale (tau): %14.8e    DTIME/TAU: %14.2f\n", min_tau_global, config.tDel/min_tau_global);
+      if ((config.quietNodeTolerance > 0.0) && (nodeCountsGlobal[0] > 0.0))
+        printf("  --> Quiet nodes skipped in Adiabatic Change: %6.2f%%\n",
+               100.0*nodeCountsGlobal[1]/nodeCountsGlobal[0]);
     }
     // Reset these values:
     maxsubcycles_energychangeGlobal = 0;
@@ -392,11 +420,13 @@ int main(int argc, char *argv[]) {
     maxsubcycles_focusing = 0;
     min_tau = DBL_MAX;
     min_tau_global = DBL_MAX;
+    nodes_energychange = 0;
+    quietnodes_energychange = 0;
 
     }
 
     timer_tmp = MPI_Wtime();
-    if (mpi_rank == 0) printf("  --> Compute time for step: %18.4f seconds.\n",timer_tmp-timer_step);
+    if (mpi_rank_world == 0) printf("  --> Compute time for step: %18.4f seconds.\n",timer_tmp-timer_step);
 
   } while(t_global <= config.simStopTimeDay);
 
@@ -407,6 +437,8 @@ int main(int argc, char *argv[]) {
   // ---------------------------------------------------------------------------
 
   DumpRunTimes();
+  workspaceReport();
+  freeWorkspace();
   config_destroy(&cfg);
   cleanupMPIWindows();
   MPI_Finalize();
@@ -31,7 +31,7 @@ extern "C" {
 
 
 #define ROOT_MSG(format, ...)          \
-    if (mpi_rank == 0)                 \
+    if (mpi_rank_world == 0)           \
     {                                  \
         printf((format), ##__VA_ARGS__); \
     }
@@ -23,6 +23,7 @@
 
 #include "global.h"
 #include "configuration.h"
+#include "energeticParticlesTypes.h"
 #include "flow.h"
 #include "simCore.h"
 #include "geometry.h"
@@ -42,8 +43,16 @@
 /*-----------------------------------------------------------------------*/
 {
 
-  Index_t face, row, col, shell, idealShockNode, idx;
+  Index_t face, row, col, shell, idealShockNode, idx, energy;
   SphVec_t radpos;
+  Scalar_t vMin, shift;
+
+  // The adiabatic change moves particles in ln(p) by at most
+  // |DuPar|/v + max(|DlnN - DlnB|, |DlnB|/2) over the time step (see
+  // AdiabaticChange()), which is largest for the slowest particles.
+  vMin = vgrid[0];
+  for (energy = 1; energy < NUM_ESTEPS; energy++)
+    if (vgrid[energy] < vMin) vMin = vgrid[energy];
 
   for (face  = 0; face < NUM_FACES; face++ )
   {
@@ -51,6 +60,10 @@
     {
       for (col   = 0; col < FACE_COLS; col++ )
       {
+
+        // only the nodes stored on this rank (see NODE_SLOT)
+        if (!LOCAL_NODE(face,row,col)) continue;
+
         for (shell = INNER_ACTIVE_SHELL; shell < LOCAL_NUM_SHELLS; shell++ )
         {
 
@@ -72,8 +85,11 @@
           // at, the current position and desired time (tGlobal+dt in main
           // loop). NOTE: This does NOT set values on the `grid[idx]` struct,
           // only in the global `mhdNode` struct, which subsequent routines use
-          // to update MHD quantities.
+          // to update MHD quantities. The search for the MHD cells starts
+          // from the ones the node was found in last time.
+          mhdUseCellHint(idx);
           mhdGetNode(radpos, grid[idx]);
+          mhdUseCellHint(-1);
 
           // Check to see if node is in ideal shock domain
           idealShockNode = 0;
@@ -146,6 +162,18 @@
             grid[idx].mhdDlnN  = log(grid[idx].mhdDensity/grid[idx].mhdDensityOld);
 
           }
+
+          // Tag the node as quiet if that shift is below the tolerance,
+          // in energy steps.
+          if (config.quietNodeTolerance > 0.0) {
+
+            shift = fabs(grid[idx].mhdDuPar)/vMin
+                  + fmax(fabs(grid[idx].mhdDlnN - grid[idx].mhdDlnB),
+                         0.5*fabs(grid[idx].mhdDlnB));
+
+            nodeQuiet[idx] = (shift < config.quietNodeTolerance*dlnp);
+
+          }
         }
       }
     }
@@ -17,12 +17,31 @@
 #include <stdlib.h>
 #include "global.h"
 #include "configuration.h"
+#include "mpiInit.h"
+#include "simCore.h"
 
 Scalar_t *restrict eParts;
 Scalar_t *restrict ePartsStream;
 Node_t *restrict grid;
 Node_t *restrict streamGrid;
 
+Scalar_t *restrict ePartsStreamAll;
+Node_t *restrict streamGridAll;
+
+Scalar_t *restrict ePartsStreamPipe;
+Node_t *restrict streamGridPipe;
+
+Index_t *restrict nodeRole;
+Index_t *restrict nodeSlot;
+Index_t *restrict nodeQuiet;
+
+Scalar_t *restrict shellCost;
+
+Index_t *restrict streamSchedule;
+Index_t *restrict scheduleStart;
+Index_t *restrict rankNumStreams;
+Scalar_t *restrict streamCost;
+
 Index_t *restrict shellList;
 Index_t *restrict shellRef;
 
@@ -42,32 +61,28 @@ Scalar_t s_hel;
 
 Index_t simStarted;
 
-Index_t FACE_ROWS, FACE_COLS, LOCAL_NUM_SHELLS;
+Index_t FACE_ROWS, FACE_COLS, LOCAL_NUM_SHELLS, MAX_LOCAL_NUM_SHELLS;
 Index_t NUM_SPECIES, NUM_ESTEPS, NUM_MUSTEPS;
 Index_t TOTAL_NUM_SHELLS, NUM_OBS;
 Index_t N_PROCS;
+Index_t N_THREADS;
+Index_t NUM_FACE_GROUPS = 1;
+Index_t FIRST_GROUP_STREAM;
+Index_t GROUP_NUM_STREAMS;
 Index_t TOTAL_ACTIVE_STREAM_SIZE;
+Index_t MAX_RANK_NUM_STREAMS;
+Index_t STREAM_SCHEDULE_LENGTH;
+Index_t SHELL_OFFSET;
+Index_t NUM_LOCAL_NODES;
 
 Index_t RC;
-Index_t CM;
-Index_t RCM;
-Index_t CS;
-Index_t RCS;
 Index_t EM;
 Index_t SPE;
 Index_t SPEM;
-Index_t CSPEM;
-Index_t RCSPEM;
 Index_t SSPEM;
-Index_t CSSPEM;
-Index_t RCSSPEM;
-Index_t CO;
-Index_t RCO;
 Index_t MO;
 Index_t EMO;
 Index_t SPEMO;
-Index_t CSPEMO;
-Index_t RCSPEMO;
 Index_t FRC;
 
 Index_t AdiabaticFocusAlg;
@@ -85,38 +100,72 @@ Index_t AdiabaticChangeAlg;
 
   // defining all the values used in the mappings in global.h
   RC = FACE_ROWS * FACE_COLS;
-  CM = FACE_COLS * NUM_MUSTEPS;
-  RCM = FACE_ROWS * FACE_COLS * NUM_MUSTEPS;
-  CS = FACE_COLS * LOCAL_NUM_SHELLS;
-  RCS = FACE_ROWS * FACE_COLS * LOCAL_NUM_SHELLS;
   EM = NUM_ESTEPS * NUM_MUSTEPS;
   SPE = NUM_SPECIES * NUM_ESTEPS;
   SPEM = NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS;
-  CSPEM = FACE_COLS * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS;
-  RCSPEM = FACE_ROWS * FACE_COLS * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS;
-  SSPEM = LOCAL_NUM_SHELLS * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS;
-  CSSPEM = FACE_COLS * LOCAL_NUM_SHELLS * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS;
-  RCSSPEM = FACE_ROWS * FACE_COLS * LOCAL_NUM_SHELLS * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS;
-  CO = FACE_COLS * NUM_OBS;
-  RCO = FACE_ROWS * FACE_COLS * NUM_OBS;
   MO = NUM_MUSTEPS * NUM_OBS;
   EMO = NUM_ESTEPS * NUM_MUSTEPS * NUM_OBS;
   SPEMO = NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS * NUM_OBS;
-  CSPEMO = FACE_COLS * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS * NUM_OBS;
-  RCSPEMO = FACE_ROWS * FACE_COLS * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS * NUM_OBS;
   FRC = NUM_FACES * FACE_ROWS * FACE_COLS;
 
+  setLocalShellStrides();
+
+  // the nodes this rank stores (sets nodeRole, nodeSlot and NUM_LOCAL_NODES)
+  initFaceGroupNodes();
+
   TOTAL_ACTIVE_STREAM_SIZE = config.numNodesPerStream;
 
+  // the shell ring starts out unrotated
+  SHELL_OFFSET = 0;
+
   // malloc time!
-  eParts = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)NUM_FACES*(int)FACE_ROWS*(int)FACE_COLS*(int)LOCAL_NUM_SHELLS*(int)NUM_SPECIES*(int)NUM_ESTEPS*(int)NUM_MUSTEPS);
+  // The shell arrays have room for MAX_LOCAL_NUM_SHELLS, so that a
+  // rank can take on shells when they are rebalanced, but only for the
+  // NUM_LOCAL_NODES nodes of a shell that its face group stores.
+  eParts = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)NUM_LOCAL_NODES*(int)MAX_LOCAL_NUM_SHELLS*(int)NUM_SPECIES*(int)NUM_ESTEPS*(int)NUM_MUSTEPS);
 
   ePartsStream = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)TOTAL_ACTIVE_STREAM_SIZE*(int)NUM_SPECIES*(int)NUM_ESTEPS*(int)NUM_MUSTEPS);
 
-  grid = (Node_t *) malloc(sizeof(Node_t)*(int)NUM_FACES*(int)FACE_ROWS*(int)FACE_COLS*(int)LOCAL_NUM_SHELLS);
+  grid = (Node_t *) malloc(sizeof(Node_t)*(int)NUM_LOCAL_NODES*(int)MAX_LOCAL_NUM_SHELLS);
 
   streamGrid = (Node_t *) malloc(sizeof(Node_t)*(int)TOTAL_ACTIVE_STREAM_SIZE);
 
+  ePartsStreamPipe = (Scalar_t *) malloc(sizeof(Scalar_t)*STREAM_PIPE_DEPTH*(int)TOTAL_ACTIVE_STREAM_SIZE*(int)NUM_SPECIES*(int)NUM_ESTEPS*(int)NUM_MUSTEPS);
+
+  streamGridPipe = (Node_t *) malloc(sizeof(Node_t)*STREAM_PIPE_DEPTH*(int)TOTAL_ACTIVE_STREAM_SIZE);
+
+  streamSchedule = (Index_t *) malloc(sizeof(Index_t)*(int)GROUP_NUM_STREAMS);
+  scheduleStart  = (Index_t *) malloc(sizeof(Index_t)*(int)N_PROCS);
+  rankNumStreams = (Index_t *) malloc(sizeof(Index_t)*(int)N_PROCS);
+  streamCost     = (Scalar_t *) calloc((int)GROUP_NUM_STREAMS, sizeof(Scalar_t));
+
+  roundRobinStreams();
+
+  // Room for the most streams a schedule may give a rank.
+  MAX_RANK_NUM_STREAMS = STREAM_SCHEDULE_LENGTH;
+
+  if (config.useStreamScheduling > 0) {
+
+    MAX_RANK_NUM_STREAMS = MAX_STREAM_SHARE * STREAM_SCHEDULE_LENGTH;
+
+    if (MAX_RANK_NUM_STREAMS > GROUP_NUM_STREAMS)
+      MAX_RANK_NUM_STREAMS = GROUP_NUM_STREAMS;
+
+  }
+
+  if (config.useStreamTranspose > 0) {
+
+    ePartsStreamAll = (Scalar_t *) malloc(sizeof(Scalar_t)*(size_t)MAX_RANK_NUM_STREAMS*(int)TOTAL_ACTIVE_STREAM_SIZE*(int)NUM_SPECIES*(int)NUM_ESTEPS*(int)NUM_MUSTEPS);
+
+    streamGridAll = (Node_t *) malloc(sizeof(Node_t)*(size_t)MAX_RANK_NUM_STREAMS*(int)TOTAL_ACTIVE_STREAM_SIZE);
+
+  }
+
+  nodeQuiet = (Index_t *) calloc((size_t)NUM_LOCAL_NODES*MAX_LOCAL_NUM_SHELLS,
+                                 sizeof(Index_t));
+
+  shellCost = (Scalar_t *) calloc((int)MAX_LOCAL_NUM_SHELLS, sizeof(Scalar_t));
+
   shellList = (Index_t *) malloc(sizeof(Index_t)*(int)TOTAL_NUM_SHELLS);
 
   shellRef = (Index_t *) malloc(sizeof(Index_t)*(int)TOTAL_NUM_SHELLS);
@@ -125,9 +174,61 @@ Index_t AdiabaticChangeAlg;
 
   ds_i = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)TOTAL_NUM_SHELLS);
 
-  projections = (Node_t *) malloc(sizeof(Node_t)*(int)NUM_FACES*FACE_ROWS*FACE_COLS*(int)NUM_OBS);
+  projections = (Node_t *) malloc(sizeof(Node_t)*(int)GROUP_NUM_STREAMS*(int)NUM_OBS);
+
+  ePartsProj = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)GROUP_NUM_STREAMS*(int)NUM_SPECIES*(int)NUM_ESTEPS*(int)NUM_MUSTEPS*(int)NUM_OBS);
+
+}
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+
+
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+/*---*/   void                                         /*---*/
+/*---*/   setLocalShellStrides(void)                   /*---*/
+/*---                                                    ---*/
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+{
+
+  SSPEM = LOCAL_NUM_SHELLS * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS;
+
+}
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+
+
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+/*---*/   void                                         /*---*/
+/*---*/   roundRobinStreams(void)                      /*---*/
+/*---                                                    ---*/
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+{
+
+  Index_t proc, iterIndex, first;
+
+  first = 0;
+
+  STREAM_SCHEDULE_LENGTH = 0;
+
+  for (proc = 0; proc < N_PROCS; proc++) {
+
+    rankNumStreams[proc] = (GROUP_NUM_STREAMS > proc) ?
+                           (GROUP_NUM_STREAMS - proc + N_PROCS - 1) / N_PROCS : 0;
+    scheduleStart[proc]  = first;
+
+    for (iterIndex = 0; iterIndex < rankNumStreams[proc]; iterIndex++)
+      streamSchedule[first + iterIndex] = proc + N_PROCS * iterIndex;
+
+    if (rankNumStreams[proc] > STREAM_SCHEDULE_LENGTH)
+      STREAM_SCHEDULE_LENGTH = rankNumStreams[proc];
+
+    first += rankNumStreams[proc];
 
-  ePartsProj = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)NUM_FACES*(int)FACE_ROWS*(int)FACE_COLS*(int)NUM_SPECIES*(int)NUM_ESTEPS*(int)NUM_MUSTEPS*(int)NUM_OBS);
+  }
 
 }
 /*----------------------------------------------------------*/
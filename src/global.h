@@ -20,25 +20,13 @@
 
 // All permutations defined
 extern Index_t RC;
-extern Index_t CM;
-extern Index_t RCM;
-extern Index_t CS;
-extern Index_t RCS;
 extern Index_t EM;
 extern Index_t SPE;
 extern Index_t SPEM;
-extern Index_t CSPEM;
-extern Index_t RCSPEM;
 extern Index_t SSPEM;
-extern Index_t CSSPEM;
-extern Index_t RCSSPEM;
-extern Index_t CO;
-extern Index_t RCO;
 extern Index_t MO;
 extern Index_t EMO;
 extern Index_t SPEMO;
-extern Index_t CSPEMO;
-extern Index_t RCSPEMO;
 extern Index_t FRC;
 
 // mappings from multidimensions to the 1D arrays
@@ -46,19 +34,33 @@ extern Index_t FRC;
 
 #define idx_frc(f,r,c) ((c)+(r)*FACE_COLS+(f)*RC)
 
-#define idx_frcm(f,r,c,m) ((m)+(c)*NUM_MUSTEPS+(r)*CM+(f)*RCM)
+// A rank stores only the nodes of its face group's owned and halo rows
+// (see initFaceGroupNodes()): node (f,r,c) lives in storage slot
+// NODE_SLOT(f,r,c), which is -1 for a node that is not stored. The
+// indices below that take (f,r,c) are only valid for LOCAL_NODE(f,r,c).
+#define NODE_SLOT(f,r,c) ((nodeSlot[idx_frc((f),(r),(c))]))
 
-#define idx_frcs(f,r,c,s) ((s)+(c)*LOCAL_NUM_SHELLS+(r)*CS+(f)*RCS)
+#define LOCAL_NODE(f,r,c) ((NODE_SLOT((f),(r),(c)) >= 0))
+
+#define idx_frcm(f,r,c,m) ((m)+NODE_SLOT((f),(r),(c))*NUM_MUSTEPS)
+
+// Shells are stored as a ring along each stream: logical shell s lives in
+// physical slot (s+SHELL_OFFSET) mod LOCAL_NUM_SHELLS, so rippling the shells
+// out only rotates SHELL_OFFSET (see rippleShellsOut()). s must be in
+// [0,LOCAL_NUM_SHELLS).
+#define RING_SHELL(s) (((s)+SHELL_OFFSET) < LOCAL_NUM_SHELLS ? ((s)+SHELL_OFFSET) : ((s)+SHELL_OFFSET-LOCAL_NUM_SHELLS))
+
+#define idx_frcs(f,r,c,s) (RING_SHELL(s)+NODE_SLOT((f),(r),(c))*LOCAL_NUM_SHELLS)
 
 #define idx_se(sp,e) ((e)+(sp)*NUM_ESTEPS)
 
-#define idx_frcspem(f,r,c,sp,e,m) ((m)+(e)*NUM_MUSTEPS+(sp)*EM+(c)*SPEM+(r)*CSPEM+(f)*RCSPEM)
+#define idx_frcspem(f,r,c,sp,e,m) ((m)+(e)*NUM_MUSTEPS+(sp)*EM+NODE_SLOT((f),(r),(c))*SPEM)
 
-#define idx_frcsspm(f,r,c,s,sp,m) ((m)+(sp)*NUM_MUSTEPS+(s)*NUM_MUSTEPS*NUM_SPECIES+(c)*NUM_MUSTEPS*NUM_SPECIES*LOCAL_NUM_SHELLS+(r)*NUM_MUSTEPS*NUM_SPECIES*CS+(f)*NUM_MUSTEPS*NUM_SPECIES*RCS)
+#define idx_frcsspm(f,r,c,s,sp,m) ((m)+(sp)*NUM_MUSTEPS+RING_SHELL(s)*NUM_MUSTEPS*NUM_SPECIES+NODE_SLOT((f),(r),(c))*NUM_MUSTEPS*NUM_SPECIES*LOCAL_NUM_SHELLS)
 
-#define idx_frcssp(f,r,c,s,sp) ((sp)+(s)*NUM_SPECIES+(c)*NUM_SPECIES*LOCAL_NUM_SHELLS+(r)*NUM_SPECIES*CS+(f)*NUM_SPECIES*RCS)
+#define idx_frcssp(f,r,c,s,sp) ((sp)+RING_SHELL(s)*NUM_SPECIES+NODE_SLOT((f),(r),(c))*NUM_SPECIES*LOCAL_NUM_SHELLS)
 
-#define idx_frcsspem(f,r,c,s,sp,e,m) ((m)+(e)*NUM_MUSTEPS+(sp)*EM+(s)*SPEM+(c)*SSPEM+(r)*CSSPEM+(f)*RCSSPEM)
+#define idx_frcsspem(f,r,c,s,sp,e,m) ((m)+(e)*NUM_MUSTEPS+(sp)*EM+RING_SHELL(s)*SPEM+NODE_SLOT((f),(r),(c))*SSPEM)
 
 #define idx_sspem(s,sp,e,m) ((m)+(e)*NUM_MUSTEPS+(sp)*EM+(s)*SPEM)
 
@@ -72,9 +74,11 @@ extern Index_t FRC;
 
 #define idx_spemp1(sp,e,m) ((m)+(e)*(NUM_MUSTEPS+1)+(sp)*(NUM_MUSTEPS+1)*NUM_ESTEPS)
 
-#define idx_frco(f,r,c,o) ((o)+(c)*NUM_OBS+(r)*CO+(f)*RCO)
+// The point observer projections are kept for the streams of this
+// rank's face group only.
+#define idx_frco(f,r,c,o) ((o)+(idx_frc((f),(r),(c))-FIRST_GROUP_STREAM)*NUM_OBS)
 
-#define idx_frcspemo(f,r,c,sp,e,m,o) ((o)+(m)*NUM_OBS+(e)*MO+(sp)*EMO+(c)*SPEMO+(r)*CSPEMO+(f)*RCSPEMO)
+#define idx_frcspemo(f,r,c,sp,e,m,o) ((o)+(m)*NUM_OBS+(e)*MO+(sp)*EMO+(idx_frc((f),(r),(c))-FIRST_GROUP_STREAM)*SPEMO)
 
 #define idx_sem(s,e,m) ((m)+(e)*NUM_MUSTEPS+(s)*EM)
 
@@ -85,6 +89,43 @@ extern Scalar_t *restrict ePartsStream;
 extern Node_t *restrict grid;
 extern Node_t *restrict streamGrid;
 
+/*-- Every stream a rank works on, back to back (see useStreamTranspose). --*/
+extern Scalar_t *restrict ePartsStreamAll;
+extern Node_t *restrict streamGridAll;
+
+/*-- Stream buffers of the gather/compute/scatter pipeline. Stream    --*/
+/*-- iterIndex lives in slot STREAM_PIPE_SLOT(iterIndex), so the      --*/
+/*-- gather of the next stream and the scatter of the previous one    --*/
+/*-- never touch the stream being computed.                           --*/
+#define STREAM_PIPE_DEPTH 3
+#define STREAM_PIPE_SLOT(i) ((i) % STREAM_PIPE_DEPTH)
+extern Scalar_t *restrict ePartsStreamPipe;
+extern Node_t *restrict streamGridPipe;
+
+extern Index_t *restrict nodeRole;
+
+/*-- Storage slot of each node of a shell, by idx_frc (see NODE_SLOT), --*/
+/*-- and the number of nodes of a shell stored on this rank.           --*/
+extern Index_t *restrict nodeSlot;
+extern Index_t NUM_LOCAL_NODES;
+
+/*-- Set by updateMhd() on each grid node (idx_frcs) whose MHD changed --*/
+/*-- too little over the time step to move its particles in energy    --*/
+/*-- (see quietNodeTolerance); AdiabaticChange() leaves them alone.   --*/
+extern Index_t *restrict nodeQuiet;
+
+/*-- The stream schedule (see WORK_INDEX()) and the seconds of stream --*/
+/*-- work measured on each stream of the face group since it was last --*/
+/*-- scheduled.                                                       --*/
+extern Index_t *restrict streamSchedule;
+extern Index_t *restrict scheduleStart;
+extern Index_t *restrict rankNumStreams;
+extern Scalar_t *restrict streamCost;
+
+/*-- Seconds of shell-local EP work spent on each local shell since  --*/
+/*-- the shells were last balanced (see rebalanceShells()).          --*/
+extern Scalar_t *restrict shellCost;
+
 extern Index_t *restrict shellList;
 extern Index_t *restrict shellRef;
 
@@ -107,13 +148,21 @@ extern Index_t simStarted;
 extern Index_t FACE_ROWS;
 extern Index_t FACE_COLS;
 extern Index_t LOCAL_NUM_SHELLS;
+extern Index_t MAX_LOCAL_NUM_SHELLS;
 extern Index_t NUM_SPECIES;
 extern Index_t NUM_ESTEPS;
 extern Index_t NUM_MUSTEPS;
 extern Index_t TOTAL_NUM_SHELLS;
 extern Index_t NUM_OBS;
 extern Index_t N_PROCS;
+extern Index_t N_THREADS;
+extern Index_t NUM_FACE_GROUPS;
+extern Index_t FIRST_GROUP_STREAM;
+extern Index_t GROUP_NUM_STREAMS;
 extern Index_t TOTAL_ACTIVE_STREAM_SIZE;
+extern Index_t MAX_RANK_NUM_STREAMS;
+extern Index_t STREAM_SCHEDULE_LENGTH;
+extern Index_t SHELL_OFFSET;
 
 extern Index_t AdiabaticFocusAlg;
 extern Index_t AdiabaticChangeAlg;
@@ -131,6 +180,32 @@ extern Index_t AdiabaticChangeAlg;
 /*-- Corresponding nodes on different shells are on the same streamline. --*/
 #define NUM_STREAMS ((NUM_FACES*FACE_SIZE))
 
+/*-- Face group g owns the (face,row) rows FACE_GROUP_ROW(g) up to  --*/
+/*-- FACE_GROUP_ROW(g+1)-1, counted face by face. Their streams are  --*/
+/*-- computeLines[FIRST_GROUP_STREAM .. +GROUP_NUM_STREAMS-1].       --*/
+#define FACE_GROUP_ROW(g) ((((g)*NUM_FACES*FACE_ROWS)/NUM_FACE_GROUPS))
+
+/*-- Rank p of a face group works on RANK_NUM_STREAMS(p) streams of  --*/
+/*-- the face group, WORK_INDEX(p,0), WORK_INDEX(p,1), ... in turn.   --*/
+/*-- The schedule is round-robin (p, p+N_PROCS, ...) except inside    --*/
+/*-- the EP update with useStreamScheduling (see scheduleStreams()).  --*/
+/*-- STREAM_SCHEDULE_LENGTH is the largest RANK_NUM_STREAMS(p), and   --*/
+/*-- no rank ever gets more than MAX_RANK_NUM_STREAMS streams.        --*/
+#define RANK_NUM_STREAMS(p) ((rankNumStreams[(p)]))
+#define WORK_INDEX(p,iterIndex) ((streamSchedule[scheduleStart[(p)] + (iterIndex)]))
+#define GROUP_STREAM(workIndex) ((FIRST_GROUP_STREAM + (workIndex)))
+
+/*-- With useStreamScheduling, a rank works on at most this many     --*/
+/*-- times its round-robin share of the streams.                     --*/
+#define MAX_STREAM_SHARE 2
+
+/*-- Role of a shell node, by idx_frc, in this rank's face group     --*/
+/*-- (see initFaceGroupNodes): owned, a halo node linked with an    --*/
+/*-- owned node, or neither. Only owned and halo nodes are stored.  --*/
+#define NODE_REMOTE 0
+#define NODE_HALO   1
+#define NODE_OWNED  2
+
 /*-- signal that inner/outer shell cells have no in/out stream neighbor. --*/
 #define NO_STREAM_NEIGHBOR ((N_PROCS+1))
 
@@ -150,4 +225,24 @@ extern Index_t AdiabaticChangeAlg;
 /*----------------------------------------------------------*/
 /*----------------------------------------------------------*/
 
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+/*---*/   void                                         /*---*/
+/*---*/   setLocalShellStrides(void);                  /*---*/
+/*---                                                    ---*/
+/*--- Set the index strides that depend on             ---*/
+/*--- LOCAL_NUM_SHELLS, after it changes.              ---*/
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+/*---*/   void                                         /*---*/
+/*---*/   roundRobinStreams(void);                     /*---*/
+/*---                                                    ---*/
+/*--- Give rank p the streams p, p+N_PROCS, ... of its  ---*/
+/*--- face group.                                       ---*/
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+
 #endif
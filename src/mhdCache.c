@@ -0,0 +1,252 @@
+/*-----------------------------------------------
+-- EMMREM: mhdCache.c
+--
+-- Packed, memory-mapped cache of an MHD time sequence.
+--
+-- A cache file holds the meshes, the time list and every time slice
+-- of an MHD sequence in one file (see mhdCache.h for the layout). It
+-- is written once by readMHD.c and then mapped read-only by every
+-- rank, so the slices are read straight out of the page cache the
+-- ranks of a node share.
+--
+-- ______________CHANGE HISTORY______________
+-- ______________END CHANGE HISTORY______________
+------------------------------------------------*/
+
+/* The Earth-Moon-Mars Radiation Environment Module (EMMREM) software is */
+/* free software; you can redistribute and/or modify the EMMREM sotware */
+/* or any part of the EMMREM software under the terms of the GNU General */
+/* Public License (GPL) as published by the Free Software Foundation; */
+/* either version 2 of the License, or (at your option) any later */
+/* version. Software that uses any portion of the EMMREM software must */
+/* also be released under the GNU GPL license (version 2 of the GNU GPL */
+/* license or a later version). A copy of this GNU General Public License */
+/* may be obtained by writing to the Free Software Foundation, Inc., 59 */
+/* Temple Place, Suite 330, Boston MA 02111-1307 USA or by viewing the */
+/* license online at http://www.gnu.org/copyleft/gpl.html. */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "global.h"
+#include "error.h"
+#include "mhdCache.h"
+
+static char   *cacheBase  = NULL;
+static size_t  cacheBytes = 0;
+
+#define CACHE_ALIGNED(bytes) \
+  ((((int64_t)(bytes)) + MHD_CACHE_ALIGN - 1) / MHD_CACHE_ALIGN * MHD_CACHE_ALIGN)
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         mhdCacheLayout(MhdCacheHeader_t *header) /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  int field, axis;
+  int64_t offset, points;
+
+  memcpy(header->magic, MHD_CACHE_MAGIC, sizeof(header->magic));
+  header->version = MHD_CACHE_VERSION;
+
+  offset = CACHE_ALIGNED(sizeof(MhdCacheHeader_t));
+
+  for (field = 0; field < MHD_CACHE_FIELDS; field++) {
+    for (axis = 0; axis < MHD_CACHE_AXES; axis++) {
+      header->meshOffset[field][axis] = offset;
+      offset += CACHE_ALIGNED(sizeof(float) * header->dims[field][axis]);
+    }
+  }
+
+  header->timeOffset = offset;
+  offset += CACHE_ALIGNED(sizeof(double) * header->numFiles);
+
+  header->sliceOffset = offset;
+  header->sliceBytes  = 0;
+
+  for (field = 0; field < MHD_CACHE_FIELDS; field++) {
+
+    points = (int64_t)header->dims[field][0] * header->dims[field][1] * header->dims[field][2];
+
+    header->fieldOffset[field] = header->sliceBytes;
+    header->sliceBytes += CACHE_ALIGNED(sizeof(float) * points);
+
+  }
+
+  header->fileBytes = header->sliceOffset + header->sliceBytes * header->numFiles;
+
+}
+/*------------------ END  mhdCacheLayout( ) -----------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         Index_t                                  /*---*/
+/*---*/         mhdCacheMap(const char *path)            /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  int fd;
+  struct stat info;
+  MhdCacheHeader_t *header;
+
+  fd = open(path, O_RDONLY);
+
+  if (fd < 0) {
+    if (errno == ENOENT) return 0;
+    snprintf(err_msg, ERROR_MSG_SIZE, "mhdCacheMap: unable to open %s\n", path);
+    panic(err_msg);
+  }
+
+  if ( (fstat(fd, &info) != 0) || (info.st_size < (off_t) sizeof(MhdCacheHeader_t)) ) {
+    snprintf(err_msg, ERROR_MSG_SIZE, "mhdCacheMap: %s is not an MHD cache\n", path);
+    panic(err_msg);
+  }
+
+  cacheBytes = (size_t) info.st_size;
+  cacheBase  = (char *) mmap(NULL, cacheBytes, PROT_READ, MAP_SHARED, fd, 0);
+
+  close(fd);
+
+  if (cacheBase == MAP_FAILED) {
+    cacheBase = NULL;
+    snprintf(err_msg, ERROR_MSG_SIZE, "mhdCacheMap: unable to map %s\n", path);
+    panic(err_msg);
+  }
+
+  header = (MhdCacheHeader_t *) cacheBase;
+
+  if ( (strncmp(header->magic, MHD_CACHE_MAGIC, sizeof(header->magic)) != 0) ||
+       (header->version != MHD_CACHE_VERSION) ||
+       (header->fileBytes != (int64_t) cacheBytes) ) {
+    snprintf(err_msg, ERROR_MSG_SIZE,
+             "mhdCacheMap: %s is not an MHD cache of this version, or is incomplete\n", path);
+    panic(err_msg);
+  }
+
+  return 1;
+
+}
+/*------------------ END  mhdCacheMap( ) --------------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         const MhdCacheHeader_t *                 /*---*/
+/*---*/         mhdCacheHeader(void)                     /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  return (const MhdCacheHeader_t *) cacheBase;
+
+}
+/*------------------ END  mhdCacheHeader( ) -----------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         float *                                  /*---*/
+/*---*/         mhdCacheMesh(int field, int axis)        /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  return (float *) (cacheBase + mhdCacheHeader()->meshOffset[field][axis]);
+
+}
+/*------------------ END  mhdCacheMesh( ) -------------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         double *                                 /*---*/
+/*---*/         mhdCacheTimes(void)                      /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  return (double *) (cacheBase + mhdCacheHeader()->timeOffset);
+
+}
+/*------------------ END  mhdCacheTimes( ) ------------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         float *                                  /*---*/
+/*---*/         mhdCacheSlice(Index_t fileIndex,         /*---*/
+/*---*/                       int field)                 /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  const MhdCacheHeader_t *header = mhdCacheHeader();
+
+  return (float *) (cacheBase + header->sliceOffset
+                    + header->sliceBytes * fileIndex
+                    + header->fieldOffset[field]);
+
+}
+/*------------------ END  mhdCacheSlice( ) ------------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         mhdCacheWillNeed(Index_t fileIndex)      /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  const MhdCacheHeader_t *header = mhdCacheHeader();
+
+  if ( (fileIndex < 0) || (fileIndex >= header->numFiles) ) return;
+
+  madvise(cacheBase + header->sliceOffset + header->sliceBytes * fileIndex,
+          (size_t) header->sliceBytes, MADV_WILLNEED);
+
+}
+/*------------------ END  mhdCacheWillNeed( ) ---------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         mhdCacheUnmap(void)                      /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  if (cacheBase != NULL) munmap(cacheBase, cacheBytes);
+
+  cacheBase  = NULL;
+  cacheBytes = 0;
+
+}
+/*------------------ END  mhdCacheUnmap( ) ------------------*/
+/*-----------------------------------------------------------*/
@@ -0,0 +1,126 @@
+/*-----------------------------------------------
+-- EMMREM: mhdCache.h
+--
+-- Packed, memory-mapped cache of an MHD time sequence.
+--
+-- ______________CHANGE HISTORY______________
+-- ______________END CHANGE HISTORY______________
+------------------------------------------------*/
+
+/* The Earth-Moon-Mars Radiation Environment Module (EMMREM) software is */
+/* free software; you can redistribute and/or modify the EMMREM sotware */
+/* or any part of the EMMREM software under the terms of the GNU General */
+/* Public License (GPL) as published by the Free Software Foundation; */
+/* either version 2 of the License, or (at your option) any later */
+/* version. Software that uses any portion of the EMMREM software must */
+/* also be released under the GNU GPL license (version 2 of the GNU GPL */
+/* license or a later version). A copy of this GNU General Public License */
+/* may be obtained by writing to the Free Software Foundation, Inc., 59 */
+/* Temple Place, Suite 330, Boston MA 02111-1307 USA or by viewing the */
+/* license online at http://www.gnu.org/copyleft/gpl.html. */
+
+#ifndef MHDCACHE_H
+#define MHDCACHE_H
+
+#include <stdint.h>
+
+#include "baseTypes.h"
+
+// The seven fields, in the order of their files: bp, bt, br, vp, vt,
+// vr and rho. Each has a mesh along three axes: phi, theta and r.
+#define MHD_CACHE_FIELDS 7
+#define MHD_CACHE_AXES   3
+
+// Tag and version at the start of every cache file. The tag and its
+// terminating nul fill MhdCacheHeader_t.magic exactly.
+#define MHD_CACHE_MAGIC   "EPMHDC1"
+#define MHD_CACHE_VERSION 1
+
+// Every block of the file (meshes, times, and each field of each time
+// slice) starts on a boundary of this many bytes, so that the mapped
+// arrays are page aligned.
+#define MHD_CACHE_ALIGN 4096
+
+// The file starts with this header; all offsets are in bytes from the
+// start of the file. A time slice holds the seven fields one after
+// another, and the slices follow each other from sliceOffset on.
+typedef struct {
+  char    magic[sizeof(MHD_CACHE_MAGIC)];
+  int32_t version;
+  int32_t numFiles;
+  int32_t dims[MHD_CACHE_FIELDS][MHD_CACHE_AXES];
+  int64_t meshOffset[MHD_CACHE_FIELDS][MHD_CACHE_AXES];
+  int64_t timeOffset;
+  int64_t fieldOffset[MHD_CACHE_FIELDS];
+  int64_t sliceOffset;
+  int64_t sliceBytes;
+  int64_t fileBytes;
+} MhdCacheHeader_t;
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         mhdCacheLayout(MhdCacheHeader_t *header);/*---*/
+/*---                                                      ---*/
+/*--- Fill in the tag and the offsets of a header whose    ---*/
+/*--- numFiles and dims are set.                           ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         Index_t                                  /*---*/
+/*---*/         mhdCacheMap(const char *path);           /*---*/
+/*---                                                      ---*/
+/*--- Map a cache file read-only. Returns 0 if there is no ---*/
+/*--- such file, and panics if it is not a valid cache.    ---*/
+/*--- All ranks of a node share the pages of the mapping.  ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         const MhdCacheHeader_t *                 /*---*/
+/*---*/         mhdCacheHeader(void);                    /*---*/
+/*---                                                      ---*/
+/*--- Header of the mapped cache (NULL if none is mapped). ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         float *                                  /*---*/
+/*---*/         mhdCacheMesh(int field, int axis);       /*---*/
+/*---*/                                                  /*---*/
+/*---*/         double *                                 /*---*/
+/*---*/         mhdCacheTimes(void);                     /*---*/
+/*---*/                                                  /*---*/
+/*---*/         float *                                  /*---*/
+/*---*/         mhdCacheSlice(Index_t fileIndex,         /*---*/
+/*---*/                       int field);                /*---*/
+/*---                                                      ---*/
+/*--- Arrays in the mapped cache: the mesh of a field      ---*/
+/*--- along an axis, the times of the slices as listed in  ---*/
+/*--- mhdTime.txt, and one field of one time slice. They   ---*/
+/*--- are read-only.                                       ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         mhdCacheWillNeed(Index_t fileIndex);     /*---*/
+/*---                                                      ---*/
+/*--- Ask the kernel to start paging in a time slice.      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         mhdCacheUnmap(void);                     /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+#endif
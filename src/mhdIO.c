@@ -200,6 +200,96 @@ mhdReadDatafromFile(char *fname, float *buf[])                     /*--*/
 /*----------------- END mhdReadDatafromfile() ----------------------------------*/
 /*------------------------------------------------------------------------------*/
 
+/*----------------------------------------------------------------------*/
+/*----------------------------------------------------------------------*/
+/*----------------------------------------------------------------------*/
+/*--*/ void                                                         /*--*/
+                                                                    /*--*/
+mhdReadSlabfromFile(char *fname, float *buf, int slab, int numSlabs,
+                    int radialCount)                                /*--*/
+/*--                                                                  --*/
+/*--This function reads slab number slab of numSlabs of MHD 3D data,  --*/
+/*--cut along the slowest dimension, into its place in buf. Only the  --*/
+/*--first radialCount points along the fastest (radial) dimension are --*/
+/*--read, and buf holds rows of that length.                          --*/
+/*--Switch HDF4 or HDF5 based on hdf5_input flag                      --*/
+/*----------------------------------------------------------------------*/
+{ /*--------------------------------------------------------------------*/
+    if (hdf5_input == 1)
+    { // Read from HDF5 file
+
+        hid_t file_id, dataset_id, file_space, mem_space; // Data Handles
+        hsize_t dim_sizes[3], start[3], count[3];
+        int status;
+
+        file_id = H5Fopen(fname, H5F_ACC_RDONLY, H5P_DEFAULT); // Open the file
+        dataset_id = H5Dopen2(file_id, "Data", H5P_DEFAULT);   // Open the dataset: "data"
+        file_space = H5Dget_space(dataset_id);
+        H5Sget_simple_extent_dims(file_space, dim_sizes, NULL);
+
+        start[0] = (hsize_t)slab * dim_sizes[0] / numSlabs;
+        start[1] = 0;
+        start[2] = 0;
+        count[0] = (hsize_t)(slab + 1) * dim_sizes[0] / numSlabs - start[0];
+        count[1] = dim_sizes[1];
+        count[2] = (hsize_t)radialCount;
+
+        if (count[0] > 0)
+        {
+            H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+            mem_space = H5Screate_simple(3, count, NULL);
+            status = H5Dread(dataset_id, H5T_NATIVE_FLOAT, mem_space, file_space, H5P_DEFAULT,
+                             (VOIDP)&buf[start[0] * count[1] * count[2]]);
+            ERR(status);
+            H5Sclose(mem_space);
+        }
+
+        H5Sclose(file_space);
+        // Close the dataset
+        status = H5Dclose(dataset_id);
+        ERR(status);
+        // Close the file.
+        status = H5Fclose(file_id);
+        ERR(status);
+    }
+    else
+    { // Read from HDF4 file
+#ifdef HAVE_HDF4
+        int32_t sd_id, sds_id;
+        int32_t rank, data_type, n_attrs;
+        int32_t dim_sizes[H4_MAX_VAR_DIMS];
+        int32_t start[3], edges[3];
+        intn status;
+        char name[H4_MAX_NC_NAME];
+
+        sd_id = SDstart(fname, DFACC_READ);                                       // Open the file
+        sds_id = SDselect(sd_id, 3);                                             // Open the dataset: 3 is the default datasetnumber
+        status = SDgetinfo(sds_id, name, &rank, dim_sizes, &data_type, &n_attrs); // Get the dimensions
+
+        start[0] = (int32_t)(((long)slab * dim_sizes[0]) / numSlabs);
+        start[1] = 0;
+        start[2] = 0;
+        edges[0] = (int32_t)(((long)(slab + 1) * dim_sizes[0]) / numSlabs) - start[0];
+        edges[1] = dim_sizes[1];
+        edges[2] = radialCount;
+
+        if (edges[0] > 0)
+        {
+            status = SDreaddata(sds_id, start, NULL, edges,
+                                (VOIDP)&buf[(long)start[0] * edges[1] * edges[2]]); // Read in data
+            ERR(status);
+        }
+
+        status = SDendaccess(sds_id); // Close the dataset
+        ERR(status);
+        status = SDend(sd_id); // Close the file
+        ERR(status);
+#endif
+    }
+}
+/*----------------- END mhdReadSlabfromFile() ----------------------------------*/
+/*------------------------------------------------------------------------------*/
+
 /*----------------------------------------------------------------------*/
 /*----------------------------------------------------------------------*/
 /*----------------------------------------------------------------------*/
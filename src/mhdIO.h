@@ -26,5 +26,6 @@
 void mhdReadMeshDimensions( char *fname , char *dsetname, int dsetnumber, int32_t *DimMax );
 void mhdReadMesh( char *fname , char *dsetname, int dsetnumber, float *Dim[] );
 void mhdReadDatafromFile(char *fname, float *buf[] );
+void mhdReadSlabfromFile(char *fname, float *buf, int slab, int numSlabs, int radialCount );
 void mhdDatafile_type();
 #endif
@@ -11,6 +11,8 @@
 /* license online at http://www.gnu.org/copyleft/gpl.html. */
 
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "global.h"
 #include "configuration.h"
@@ -25,6 +27,55 @@
 mhdNode_t mhdNode;
 Index_t unwindPhiOffset;
 
+// Lookup table of one distinct MHD mesh: the mesh is cut into
+// numBuckets equal buckets from mesh[0] to its last point, no wider
+// than its narrowest cell, and bucket[b] is the last mesh point below
+// the start of bucket b. A lookup then starts at most a step or two
+// from the cell it is after. A mesh that does not increase strictly
+// has no buckets and is searched by bisection.
+typedef struct {
+  float    *mesh;
+  int       field;      // first field with this mesh
+  int       fields;     // bit (1 << field) of every field with it
+  int       axis;
+  Scalar_t  start;
+  Scalar_t  invWidth;
+  int       numBuckets;
+  int      *bucket;
+} MhdMeshIndex_t;
+
+// No more buckets than this many per mesh point.
+#define MHD_BUCKETS_PER_POINT 8
+
+static MhdMeshIndex_t mhdMeshIndex[21];
+static int mhdNumMeshIndex = 0;
+static int mhdMeshIndexOf[7][3];
+
+// The cell each grid node was last found in, per distinct mesh, and
+// the node whose cells mhdFindCells() starts from (-1 for none).
+static int *mhdCellHint = NULL;
+static Index_t mhdCellHintNode = -1;
+
+// For resampling onto the rho mesh (mhdInterleave): the cell of each
+// field's mesh that every rho mesh point falls in, along each axis, and
+// the rho mesh size they were found for.
+static int *mhdPackLower[7][3];
+static Scalar_t *mhdPackWeight[7][3];
+static int mhdPackSize[3] = {0, 0, 0};
+
+// The velocity mhdGetNode() interpolated for each grid node in the
+// coupled domain, with the position and the sample epoch it was taken
+// at. The first Runge-Kutta stage of mhdMoveNodes() samples the same
+// position with the same slices, and takes it from here.
+typedef struct {
+  SphVec_t position;
+  SphVec_t mhdV;
+  Index_t  epoch;
+} MhdVelocitySample_t;
+
+static MhdVelocitySample_t *mhdVelocitySample = NULL;
+static Index_t mhdSampleEpoch = 1;
+
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 /*--*/ void                                                          /*--*/
@@ -50,6 +101,12 @@ Index_t unwindPhiOffset;
                             mhdVp_1, mhdVt_1, mhdVr_1,
                             mhdD_1,  s_cor);
 
+    if (mhdCellHintNode >= 0) {
+      mhdVelocitySample[mhdCellHintNode].position = position;
+      mhdVelocitySample[mhdCellHintNode].mhdV = mhdNode.mhdV;
+      mhdVelocitySample[mhdCellHintNode].epoch = mhdSampleEpoch;
+    }
+
   } else {
 
     mhdWind(node);
@@ -60,6 +117,60 @@ Index_t unwindPhiOffset;
 /*------------------------------------------------------------------*/
 
 
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/ void                                                          /*--*/
+/*--*/ mhdGetNodeVelocity(SphVec_t position, Node_t node)            /*--*/
+//     As mhdGetNode(), but only sets mhdNode.mhdV, for moving the
+//     nodes. The other fields of mhdNode are left as they were.
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  MhdVelocitySample_t *sample;
+
+  if ((mhdGridStatus == MHD_COUPLED) && (position.r <= (config.mhdRadialMax * RSAU)))
+  {
+
+    // the same position with the same slices gives the same velocity
+    if (mhdCellHintNode >= 0) {
+      sample = &mhdVelocitySample[mhdCellHintNode];
+      if ((sample->epoch == mhdSampleEpoch) &&
+          (sample->position.r == position.r) &&
+          (sample->position.theta == position.theta) &&
+          (sample->position.phi == position.phi)) {
+        mhdNode.mhdV = sample->mhdV;
+        return;
+      }
+    }
+
+    mhdTriLinearVelocity(position, mhdVp_0, mhdVt_0, mhdVr_0,
+                                   mhdVp_1, mhdVt_1, mhdVr_1, s_cor);
+
+  } else {
+
+    mhdWindVelocity(node);
+
+  }
+
+}/*----------- END mhdGetNodeVelocity() ----------------------------*/
+/*------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/ void                                                          /*--*/
+/*--*/ mhdInvalidateSamples(void)                                    /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  mhdSampleEpoch++;
+
+}/*----------- END mhdInvalidateSamples() --------------------------*/
+/*------------------------------------------------------------------*/
+
+
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 /*--*/ int          /*---------------------------------------------------*/
@@ -163,6 +274,248 @@ Index_t unwindPhiOffset;
 /*----------- END mhdTriLinearBinarySearch() -------------------------------*/
 
 
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/  void                                                              /*--*/
+/*--*/  mhdBuildMeshIndex( void )                                         /*--*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+{
+
+  int field, axis, u, i, b, n;
+  float *mesh;
+  Scalar_t width, minWidth, edge;
+  MhdMeshIndex_t *index;
+
+  for (u = 0; u < mhdNumMeshIndex; u++)
+    free(mhdMeshIndex[u].bucket);
+
+  free(mhdCellHint);
+  free(mhdVelocitySample);
+
+  mhdNumMeshIndex = 0;
+  mhdCellHintNode = -1;
+
+  for (field = 0; field < 7; field++) {
+    for (axis = 0; axis < 3; axis++) {
+
+      mesh = *mhdMesh[field][axis];
+      n = *mhdMeshSize[field][axis];
+
+      // reuse the table of an equal mesh along the same axis
+      for (u = 0; u < mhdNumMeshIndex; u++) {
+        index = &mhdMeshIndex[u];
+        if ( (index->axis == axis) &&
+             (*mhdMeshSize[index->field][axis] == n) &&
+             ( (index->mesh == mesh) ||
+               (memcmp(index->mesh, mesh, sizeof(float) * n) == 0) ) )
+          break;
+      }
+
+      mhdMeshIndexOf[field][axis] = u;
+
+      if (u < mhdNumMeshIndex) {
+        mhdMeshIndex[u].fields |= 1 << field;
+        continue;
+      }
+
+      index = &mhdMeshIndex[mhdNumMeshIndex++];
+
+      index->mesh       = mesh;
+      index->field      = field;
+      index->fields     = 1 << field;
+      index->axis       = axis;
+      index->start      = mesh[0];
+      index->invWidth   = 0.0;
+      index->numBuckets = 0;
+      index->bucket     = NULL;
+
+      minWidth = LARGEFLOAT;
+      for (i = 0; i < n - 1; i++) {
+        width = (Scalar_t)mesh[i + 1] - mesh[i];
+        if (width < minWidth)
+          minWidth = width;
+      }
+
+      if ((n < 2) || !(minWidth > 0.0))
+        continue;
+
+      width = ((Scalar_t)mesh[n - 1] - mesh[0]) / minWidth;
+      index->numBuckets = (width < (Scalar_t)MHD_BUCKETS_PER_POINT * n) ?
+                          (int)ceil(width) : MHD_BUCKETS_PER_POINT * n;
+      if (index->numBuckets < 1)
+        index->numBuckets = 1;
+
+      index->invWidth = index->numBuckets / ((Scalar_t)mesh[n - 1] - mesh[0]);
+      index->bucket = (int *)malloc(sizeof(int) * index->numBuckets);
+
+      i = 0;
+      for (b = 0; b < index->numBuckets; b++) {
+        edge = index->start + b / index->invWidth;
+        while ((i < n - 1) && (mesh[i + 1] < edge))
+          i++;
+        index->bucket[b] = i;
+      }
+
+    }
+  }
+
+  // One cached cell per distinct mesh for every slot of the grid.
+  mhdCellHint = (int *)calloc((size_t)NUM_LOCAL_NODES * MAX_LOCAL_NUM_SHELLS
+                              * mhdNumMeshIndex, sizeof(int));
+
+  // Epoch 0 is never current, so no sample is taken before it is set.
+  mhdVelocitySample = (MhdVelocitySample_t *)calloc((size_t)NUM_LOCAL_NODES
+                                                    * MAX_LOCAL_NUM_SHELLS,
+                                                    sizeof(MhdVelocitySample_t));
+
+}
+/*----------- END mhdBuildMeshIndex() ----------------------------------------*/
+
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/  void                                                              /*--*/
+/*--*/  mhdUseCellHint( Index_t idx )                                     /*--*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+{
+
+  mhdCellHintNode = ((idx >= 0) && (mhdCellHint != NULL)) ? idx : -1;
+
+}
+/*----------- END mhdUseCellHint() -------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/  static int                                                        /*--*/
+/*--*/  mhdCellHolds( float *A, Scalar_t key, int i, int last )           /*--*/
+/*--                                                                        --*/
+/*--  Whether i is the cell that the bisection finds for key.              --*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+{
+
+  return ((i == mhdDimMin[0]) || (A[i] < key)) &&
+         ((i == last - 1) || !(A[i + 1] < key));
+
+}
+/*----------- END mhdCellHolds() ---------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/  void                                                              /*--*/
+/*--*/  mhdFindCells( SphVec_t r, MhdCell_t cell[7], int fields )         /*--*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+{
+
+  int field, axis, u, b, i, last;
+  int lower[21];
+  int *hint;
+  Scalar_t key, x, d[21];
+  float *A;
+  MhdMeshIndex_t *index;
+
+  hint = (mhdCellHintNode >= 0) ? &mhdCellHint[mhdCellHintNode * mhdNumMeshIndex] : NULL;
+
+  for (u = 0; u < mhdNumMeshIndex; u++) {
+
+    index = &mhdMeshIndex[u];
+
+    if ((index->fields & fields) == 0)
+      continue;
+
+    A = index->mesh;
+
+    key = (index->axis == MHD_R) ? r.r : ((index->axis == MHD_THETA) ? r.theta : r.phi);
+
+    // the same upper bound as the searches of mhdTriLinearBinarySearch()
+    last = *mhdMeshSize[index->field][index->axis] - 1;
+
+    i = -1;
+
+    // Nodes move a fraction of a cell per step: try the node's last
+    // cell and the cells on either side of it first.
+    if (hint != NULL) {
+
+      i = hint[u];
+      if (i > last - 1)
+        i = last - 1;
+      if (i < mhdDimMin[0])
+        i = mhdDimMin[0];
+
+      if (mhdCellHolds(A, key, i, last))
+        ;
+      else if ((i > mhdDimMin[0]) && mhdCellHolds(A, key, i - 1, last))
+        i--;
+      else if ((i < last - 1) && mhdCellHolds(A, key, i + 1, last))
+        i++;
+      else
+        i = -1;
+
+    }
+
+    if (i >= 0) {
+
+      // the cached cell, or one next to it, holds the key
+
+    } else if (index->numBuckets == 0) {
+
+      mhdTriLinearBinarySearch(A, key, &i, &b, mhdDimMin[0], last);
+
+    } else {
+
+      if (!(key > index->start)) {
+        b = 0;
+      } else {
+        x = (key - index->start) * index->invWidth;
+        b = (x < index->numBuckets) ? (int)x : index->numBuckets - 1;
+      }
+
+      i = index->bucket[b];
+      if (i > last - 1)
+        i = last - 1;
+
+      // settle on the last point below key, as the bisection does
+      while ((i > mhdDimMin[0]) && !(A[i] < key))
+        i--;
+      while ((i < last - 1) && (A[i + 1] < key))
+        i++;
+
+    }
+
+    if (hint != NULL)
+      hint[u] = i;
+
+    lower[u] = i;
+
+    if (A[i] > key)
+      d[u] = 0.0;
+    else if (A[i + 1] < key)
+      d[u] = 1.0;
+    else
+      d[u] = (key - A[i]) / (A[i + 1] - A[i]);
+
+  }
+
+  for (field = 0; field < 7; field++) {
+    if ((fields & (1 << field)) == 0)
+      continue;
+    for (axis = 0; axis < 3; axis++) {
+      u = mhdMeshIndexOf[field][axis];
+      cell[field].i0[axis] = lower[u];
+      cell[field].i1[axis] = lower[u] + 1;
+      cell[field].d[axis]  = d[u];
+    }
+  }
+
+}
+/*----------- END mhdFindCells() ---------------------------------------------*/
+
+
 /*---------------------------------------------------------------------*/
 /*---------------------------------------------------------------------*/
 /*--*/ Scalar_t     /*-------------------------------------------------*/
@@ -192,6 +545,192 @@ Index_t unwindPhiOffset;
 /*----------- END mhdInterpolate() ---------------------------------*/
 
 
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+/*--*/ static void      /*---------------------------------------------*/
+/*--*/ mhdFindPackCells(void)                                       /*-*/
+/*--   Find, along each axis, the cells of the other fields' meshes   -*/
+/*--   that the points of the rho mesh fall in, if the rho mesh has   -*/
+/*--   changed size since the last time                               -*/
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+{
+
+  int field, axis, k, n, upper;
+  float *rhoMesh;
+
+  if ((mhdPackSize[0] == *mhdMeshSize[MHD_RHO][0]) &&
+      (mhdPackSize[1] == *mhdMeshSize[MHD_RHO][1]) &&
+      (mhdPackSize[2] == *mhdMeshSize[MHD_RHO][2]))
+    return;
+
+  for (axis = 0; axis < 3; axis++) {
+
+    n = *mhdMeshSize[MHD_RHO][axis];
+    rhoMesh = *mhdMesh[MHD_RHO][axis];
+
+    for (field = 0; field < MHD_RHO; field++) {
+
+      if (mhdPackSize[axis] > 0) {
+        free(mhdPackLower[field][axis]);
+        free(mhdPackWeight[field][axis]);
+      }
+
+      mhdPackLower[field][axis] = (int *)malloc(sizeof(int) * n);
+      mhdPackWeight[field][axis] = (Scalar_t *)malloc(sizeof(Scalar_t) * n);
+
+      for (k = 0; k < n; k++)
+        mhdPackWeight[field][axis][k] =
+          mhdTriLinearBinarySearch(*mhdMesh[field][axis], rhoMesh[k],
+                                   &mhdPackLower[field][axis][k], &upper,
+                                   mhdDimMin[0], *mhdMeshSize[field][axis] - 1);
+
+    }
+
+    mhdPackSize[axis] = n;
+
+  }
+
+}
+/*----------- END mhdFindPackCells() -------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+/*--*/ void             /*---------------------------------------------*/
+/*--*/ mhdPackSlice(int level, float *V[7], int plane0, int plane1) /*-*/
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+{
+
+  int field, p, t, r, rDim, tDim;
+  int *rLower, *tLower, *pLower;
+  Scalar_t *rWeight, *tWeight, *pWeight;
+  MhdRecord_t *record;
+
+  mhdFindPackCells();
+
+  rDim = *mhdMeshSize[MHD_RHO][MHD_R];
+  tDim = *mhdMeshSize[MHD_RHO][MHD_THETA];
+
+  for (p = plane0; p < plane1; p++) {
+    for (t = 0; t < tDim; t++) {
+
+      record = &mhdPacked[rDim * t + rDim * tDim * p];
+
+      for (field = 0; field < MHD_RHO; field++) {
+
+        rLower = mhdPackLower[field][MHD_R];
+        tLower = mhdPackLower[field][MHD_THETA];
+        pLower = mhdPackLower[field][MHD_PHI];
+        rWeight = mhdPackWeight[field][MHD_R];
+        tWeight = mhdPackWeight[field][MHD_THETA];
+        pWeight = mhdPackWeight[field][MHD_PHI];
+
+        for (r = 0; r < rDim; r++)
+          record[r].v[level][field] = mhdInterpolate(V[field],
+                                                     rLower[r], rLower[r] + 1,
+                                                     tLower[t], tLower[t] + 1,
+                                                     pLower[p], pLower[p] + 1,
+                                                     rWeight[r], tWeight[t], pWeight[p],
+                                                     *mhdMeshSize[field][MHD_R],
+                                                     *mhdMeshSize[field][MHD_THETA]);
+
+      }
+
+      // rho is on its own mesh
+      for (r = 0; r < rDim; r++)
+        record[r].v[level][MHD_RHO] = V[MHD_RHO][r + rDim * t + rDim * tDim * p];
+
+    }
+  }
+
+}
+/*----------- END mhdPackSlice() -----------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+/*--*/ static void      /*---------------------------------------------*/
+/*--*/ mhdInterpolatePacked(MhdCell_t *c, Scalar_t s,              /*-*/
+/*--*/                      Scalar_t value[7])                      /*-*/
+/*--   Trilinearly interpolates all seven fields of both time slices  -*/
+/*--   from the records of mhdPacked, reading each corner once, and   -*/
+/*--   interpolates between the slices in time                        -*/
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+{
+
+  int corner, field, rDim, tDim;
+  Scalar_t w, rw[2], tw[2], pw[2], v0[7], v1[7];
+  MhdRecord_t *record;
+
+  rDim = *mhdMeshSize[MHD_RHO][MHD_R];
+  tDim = *mhdMeshSize[MHD_RHO][MHD_THETA];
+
+  rw[0] = 1.0 - c->d[MHD_R];
+  rw[1] = c->d[MHD_R];
+  tw[0] = 1.0 - c->d[MHD_THETA];
+  tw[1] = c->d[MHD_THETA];
+  pw[0] = 1.0 - c->d[MHD_PHI];
+  pw[1] = c->d[MHD_PHI];
+
+  for (field = 0; field < 7; field++) {
+    v0[field] = 0.0;
+    v1[field] = 0.0;
+  }
+
+  // r runs fastest, so the two records along r are next to each other
+  for (corner = 0; corner < 8; corner++) {
+
+    record = &mhdPacked[((corner & 1) ? c->i1[MHD_R] : c->i0[MHD_R])
+                        + rDim * ((corner & 2) ? c->i1[MHD_THETA] : c->i0[MHD_THETA])
+                        + rDim * tDim * ((corner & 4) ? c->i1[MHD_PHI] : c->i0[MHD_PHI])];
+
+    w = rw[corner & 1] * tw[(corner >> 1) & 1] * pw[corner >> 2];
+
+    for (field = 0; field < 7; field++) {
+      v0[field] += w * record->v[0][field];
+      v1[field] += w * record->v[1][field];
+    }
+
+  }
+
+  for (field = 0; field < 7; field++)
+    value[field] = (1.0 - s) * v0[field] + s * v1[field];
+
+}
+/*----------- END mhdInterpolatePacked() ---------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+/*--*/ static Scalar_t  /*---------------------------------------------*/
+/*--*/ mhdInterpolateCell(float V0[], float V1[], MhdCell_t *c,     /*-*/
+/*--*/                    Scalar_t s, int rDimMax, int tDimMax)     /*-*/
+/*--   Trilinearly interpolates both time slices in one cell and      -*/
+/*--   interpolates between them in time                              -*/
+/*---------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
+{
+
+  return (1.0 - s) * mhdInterpolate(V0,
+                                    c->i0[MHD_R], c->i1[MHD_R],
+                                    c->i0[MHD_THETA], c->i1[MHD_THETA],
+                                    c->i0[MHD_PHI], c->i1[MHD_PHI],
+                                    c->d[MHD_R], c->d[MHD_THETA], c->d[MHD_PHI],
+                                    rDimMax, tDimMax) +
+                 s * mhdInterpolate(V1,
+                                    c->i0[MHD_R], c->i1[MHD_R],
+                                    c->i0[MHD_THETA], c->i1[MHD_THETA],
+                                    c->i0[MHD_PHI], c->i1[MHD_PHI],
+                                    c->d[MHD_R], c->d[MHD_THETA], c->d[MHD_PHI],
+                                    rDimMax, tDimMax);
+
+}
+/*----------- END mhdInterpolateCell() -----------------------------*/
+
+
 /*----------------------------------------------------------------------------*/
 /*----------------------------------------------------------------------------*/
 /*--*/  SphVec_t                                                          /*--*/
@@ -203,9 +742,9 @@ Index_t unwindPhiOffset;
 /*----------------------------------------------------------------------------*/
 {
 
-  int r0, r1, t0, t1, p0, p1;
+  MhdCell_t cell[7];
 
-  Scalar_t rr, rd, td, pd;
+  Scalar_t rr;
 
   Scalar_t Bscale = (double)2.2068908 / MHD_B_NORM;
 
@@ -213,47 +752,19 @@ Index_t unwindPhiOffset;
 
   if ((r.r < config.mhdRadialMax) && (r.r > config.mhdRadialMin)) {
 
+    mhdFindCells(r, cell, MHD_ALL_FIELDS);
+
     //Br
-    rd = mhdTriLinearBinarySearch(mhdBrrDim, r.r, &r0, &r1, mhdDimMin[0], mhdBrrDimMax[0]-1);
-    td = mhdTriLinearBinarySearch(mhdBrtDim, r.theta, &t0, &t1, mhdDimMin[0], mhdBrtDimMax[0]-1);
-    pd = mhdTriLinearBinarySearch(mhdBrpDim, r.phi, &p0, &p1, mhdDimMin[0], mhdBrpDimMax[0]-1);
-
-    B.r = ((1.0 - s) * mhdInterpolate(mhdBr0,
-                                      r0, r1, t0, t1, p0, p1,
-                                      rd, td, pd,
-                                      mhdBrrDimMax[0], mhdBrtDimMax[0]) +
-                   s * mhdInterpolate(mhdBr1,
-                                      r0, r1, t0, t1, p0, p1,
-                                      rd, td, pd,
-                                      mhdBrrDimMax[0], mhdBrtDimMax[0])) * Bscale;
+    B.r = mhdInterpolateCell(mhdBr0, mhdBr1, &cell[MHD_BR], s,
+                             mhdBrrDimMax[0], mhdBrtDimMax[0]) * Bscale;
 
     //Bt
-    rd = mhdTriLinearBinarySearch(mhdBtrDim, r.r, &r0, &r1, mhdDimMin[0], mhdBtrDimMax[0]-1);
-    td = mhdTriLinearBinarySearch(mhdBttDim, r.theta, &t0, &t1, mhdDimMin[0], mhdBttDimMax[0]-1);
-    pd = mhdTriLinearBinarySearch(mhdBtpDim, r.phi, &p0, &p1, mhdDimMin[0], mhdBtpDimMax[0]-1);
-
-    B.theta = ((1.0 - s) * mhdInterpolate(mhdBt0,
-                                          r0, r1, t0, t1, p0, p1,
-                                          rd, td, pd,
-                                          mhdBtrDimMax[0], mhdBttDimMax[0]) +
-                       s * mhdInterpolate(mhdBt1,
-                                          r0, r1, t0, t1, p0, p1,
-                                          rd, td, pd,
-                                          mhdBtrDimMax[0], mhdBttDimMax[0])) * Bscale;
+    B.theta = mhdInterpolateCell(mhdBt0, mhdBt1, &cell[MHD_BT], s,
+                                 mhdBtrDimMax[0], mhdBttDimMax[0]) * Bscale;
 
     //Bp
-    rd = mhdTriLinearBinarySearch(mhdBprDim, r.r, &r0, &r1, mhdDimMin[0], mhdBprDimMax[0]-1);
-    td = mhdTriLinearBinarySearch(mhdBptDim, r.theta, &t0, &t1, mhdDimMin[0], mhdBptDimMax[0]-1);
-    pd = mhdTriLinearBinarySearch(mhdBppDim, r.phi, &p0, &p1, mhdDimMin[0], mhdBppDimMax[0]-1);
-
-    B.phi = ((1.0 - s) * mhdInterpolate(mhdBp0,
-                                        r0, r1, t0, t1, p0, p1,
-                                        rd, td, pd,
-                                        mhdBprDimMax[0], mhdBptDimMax[0]) +
-                     s * mhdInterpolate(mhdBp1,
-                                        r0, r1, t0, t1, p0, p1,
-                                        rd, td, pd,
-                                        mhdBprDimMax[0], mhdBptDimMax[0])) * Bscale;
+    B.phi = mhdInterpolateCell(mhdBp0, mhdBp1, &cell[MHD_BP], s,
+                               mhdBprDimMax[0], mhdBptDimMax[0]) * Bscale;
 
   } else {
 
@@ -457,32 +968,16 @@ Index_t unwindPhiOffset;
 
 /*----------------------------------------------------------------------------*/
 /*----------------------------------------------------------------------------*/
-/*--*/ void mhdTriLinear( SphVec_t position,                              /*--*/
-/*--*/                    float mhdBp0[], float mhdBt0[], float mhdBr0[], /*--*/
-/*--*/                    float mhdVp0[], float mhdVt0[], float mhdVr0[], /*--*/
-/*--*/                    float mhdD0[],                                  /*--*/
-/*--*/                    float mhdBp1[], float mhdBt1[], float mhdBr1[], /*--*/
-/*--*/                    float mhdVp1[], float mhdVt1[], float mhdVr1[], /*--*/
-/*--*/                    float mhdD1[],                                  /*--*/
-/*--*/                    Scalar_t s)                                     /*--*/
-/*--*/                                                                    /*--*/
-/*--*/                                                                    /*--*/
-/*--  Get the data from the nearest mhd node and interpolate                --*/
-/*--  in time.                                                              --*/
+/*--*/ static SphVec_t mhdMeshPosition( SphVec_t position )               /*--*/
+/*--                                                                        --*/
+/*--  A position in AU in the coordinates of the MHD mesh: in RS, with     --*/
+/*--  phiOffset taken off phi.                                             --*/
 /*----------------------------------------------------------------------------*/
 /*----------------------------------------------------------------------------*/
 {
 
   SphVec_t r;
 
-  int r0, r1, t0, t1, p0, p1;
-  int bp_r0, bp_r1, bp_t0, bp_t1, bp_p0, bp_p1;
-  int bt_r0, bt_r1, bt_t0, bt_t1, bt_p0, bt_p1;
-  int br_r0, br_r1, br_t0, br_t1, br_p0, br_p1;
-
-
-  Scalar_t rd, td, pd;
-
   // convert from units of AU to Solar Radius and leave the
   //   angles alone
   r.r = position.r / RSAU;
@@ -498,132 +993,243 @@ Index_t unwindPhiOffset;
     while ( r.phi > (2.0 * PI) ) r.phi -= (2.0 * PI);
 
   if ( (r.phi < 0.0) || (r.phi > 2.0 * PI) ) {
-    if (mpi_rank == 0) printf("WARNING: r.phi (%f) out of bounds\n", r.phi);
+    if (mpi_rank_world == 0) printf("WARNING: r.phi (%f) out of bounds\n", r.phi);
+  }
+
+  return r;
+
+}
+/*----------- END mhdMeshPosition() -----------------------------*/
+
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/ void mhdCurlSlice( float Bp[], float Bt[], float Br[],              /*--*/
+/*--*/                    float *curl[3], int plane0, int plane1 )        /*--*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+{
+
+  int p, t, r, rDim, tDim, i;
+  float *rMesh, *tMesh, *pMesh;
+  SphVec_t position, c;
+  MhdCell_t cell[7];
+
+  rDim = *mhdMeshSize[MHD_RHO][MHD_R];
+  tDim = *mhdMeshSize[MHD_RHO][MHD_THETA];
+
+  rMesh = *mhdMesh[MHD_RHO][MHD_R];
+  tMesh = *mhdMesh[MHD_RHO][MHD_THETA];
+  pMesh = *mhdMesh[MHD_RHO][MHD_PHI];
+
+  for (p = plane0; p < plane1; p++) {
+    for (t = 0; t < tDim; t++) {
+      for (r = 0; r < rDim; r++) {
+
+        position.r = rMesh[r];
+        position.theta = tMesh[t];
+        position.phi = pMesh[p];
+
+        // the curl is singular on the axis: take it from the next
+        // point of the mesh towards the equator
+        if (sin(position.theta) < 1.0e-6)
+          position.theta = (t < tDim / 2) ? tMesh[t + 1] : tMesh[t - 1];
+
+        mhdFindCells(position, cell, MHD_ALL_FIELDS);
+
+        c = mhdNodeCurlBoverB2(position, Bp, Bt, Br, Bp, Bt, Br,
+                               cell[MHD_BP].i0[MHD_R], cell[MHD_BP].i1[MHD_R],
+                               cell[MHD_BP].i0[MHD_THETA], cell[MHD_BP].i1[MHD_THETA],
+                               cell[MHD_BP].i0[MHD_PHI], cell[MHD_BP].i1[MHD_PHI],
+                               cell[MHD_BT].i0[MHD_R], cell[MHD_BT].i1[MHD_R],
+                               cell[MHD_BT].i0[MHD_THETA], cell[MHD_BT].i1[MHD_THETA],
+                               cell[MHD_BT].i0[MHD_PHI], cell[MHD_BT].i1[MHD_PHI],
+                               cell[MHD_BR].i0[MHD_R], cell[MHD_BR].i1[MHD_R],
+                               cell[MHD_BR].i0[MHD_THETA], cell[MHD_BR].i1[MHD_THETA],
+                               cell[MHD_BR].i0[MHD_PHI], cell[MHD_BR].i1[MHD_PHI],
+                               0.0);
+
+        i = r + rDim * t + rDim * tDim * p;
+
+        curl[0][i] = c.r;
+        curl[1][i] = c.theta;
+        curl[2][i] = c.phi;
+
+      }
+    }
   }
 
+}
+/*----------- END mhdCurlSlice() --------------------------------*/
+
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/ void mhdTriLinear( SphVec_t position,                              /*--*/
+/*--*/                    float mhdBp0[], float mhdBt0[], float mhdBr0[], /*--*/
+/*--*/                    float mhdVp0[], float mhdVt0[], float mhdVr0[], /*--*/
+/*--*/                    float mhdD0[],                                  /*--*/
+/*--*/                    float mhdBp1[], float mhdBt1[], float mhdBr1[], /*--*/
+/*--*/                    float mhdVp1[], float mhdVt1[], float mhdVr1[], /*--*/
+/*--*/                    float mhdD1[],                                  /*--*/
+/*--*/                    Scalar_t s)                                     /*--*/
+/*--*/                                                                    /*--*/
+/*--*/                                                                    /*--*/
+/*--  Get the data from the nearest mhd node and interpolate                --*/
+/*--  in time.                                                              --*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+{
+
+  SphVec_t r;
+
+  MhdCell_t cell[7];
+
+  Scalar_t value[7];
+
+  Index_t hintNode;
+
+  r = mhdMeshPosition(position);
+
   //position
   mhdNode.r.r = position.r; // keep in units of AU
   mhdNode.r.theta = position.theta;
   mhdNode.r.phi = position.phi;
 
 
-  //Bp
-  rd = mhdTriLinearBinarySearch(mhdBprDim, r.r, &bp_r0, &bp_r1, mhdDimMin[0], mhdBprDimMax[0]-1);
-  td = mhdTriLinearBinarySearch(mhdBptDim, r.theta, &bp_t0, &bp_t1, mhdDimMin[0], mhdBptDimMax[0]-1);
-  pd = mhdTriLinearBinarySearch(mhdBppDim, r.phi, &bp_p0, &bp_p1, mhdDimMin[0], mhdBppDimMax[0]-1);
-
-  mhdNode.mhdB.phi = ((1.0 - s) * mhdInterpolate(mhdBp0,
-                                                bp_r0, bp_r1, bp_t0, bp_t1, bp_p0, bp_p1,
-                                                rd, td, pd,
-                                                mhdBprDimMax[0], mhdBptDimMax[0]) +
-                              s * mhdInterpolate(mhdBp1,
-                                                bp_r0, bp_r1, bp_t0, bp_t1, bp_p0, bp_p1,
-                                                rd, td, pd,
-                                                mhdBprDimMax[0], mhdBptDimMax[0])) * config.mhdBConvert;
-
-  //Bt
-  rd = mhdTriLinearBinarySearch(mhdBtrDim, r.r, &bt_r0, &bt_r1, mhdDimMin[0], mhdBtrDimMax[0]-1);
-  td = mhdTriLinearBinarySearch(mhdBttDim, r.theta, &bt_t0, &bt_t1, mhdDimMin[0], mhdBttDimMax[0]-1);
-  pd = mhdTriLinearBinarySearch(mhdBtpDim, r.phi, &bt_p0, &bt_p1, mhdDimMin[0], mhdBtpDimMax[0]-1);
-
-  mhdNode.mhdB.theta = ((1.0 - s) * mhdInterpolate(mhdBt0,
-                                                  bt_r0, bt_r1, bt_t0, bt_t1, bt_p0, bt_p1,
-                                                  rd, td, pd,
-                                                  mhdBtrDimMax[0], mhdBttDimMax[0]) +
-                                s * mhdInterpolate(mhdBt1,
-                                                  bt_r0, bt_r1, bt_t0, bt_t1, bt_p0, bt_p1,
-                                                  rd, td, pd,
-                                                  mhdBtrDimMax[0], mhdBttDimMax[0])) * config.mhdBConvert;
-
-  //Br
-  rd = mhdTriLinearBinarySearch(mhdBrrDim, r.r, &br_r0, &br_r1, mhdDimMin[0], mhdBrrDimMax[0]-1);
-  td = mhdTriLinearBinarySearch(mhdBrtDim, r.theta, &br_t0, &br_t1, mhdDimMin[0], mhdBrtDimMax[0]-1);
-  pd = mhdTriLinearBinarySearch(mhdBrpDim, r.phi, &br_p0, &br_p1, mhdDimMin[0], mhdBrpDimMax[0]-1);
-
-  mhdNode.mhdB.r = ((1.0 - s) * mhdInterpolate(mhdBr0,
-                                              br_r0, br_r1, br_t0, br_t1, br_p0, br_p1,
-                                              rd, td, pd,
-                                              mhdBrrDimMax[0], mhdBrtDimMax[0]) +
-                            s * mhdInterpolate(mhdBr1,
-                                              br_r0, br_r1, br_t0, br_t1, br_p0, br_p1,
-                                              rd, td, pd,
-                                              mhdBrrDimMax[0], mhdBrtDimMax[0])) * config.mhdBConvert;
-
-
-  //Vp
-  rd = mhdTriLinearBinarySearch(mhdVprDim, r.r, &r0, &r1, mhdDimMin[0], mhdVprDimMax[0]-1);
-  td = mhdTriLinearBinarySearch(mhdVptDim, r.theta, &t0, &t1, mhdDimMin[0], mhdVptDimMax[0]-1);
-  pd = mhdTriLinearBinarySearch(mhdVppDim, r.phi, &p0, &p1, mhdDimMin[0], mhdVppDimMax[0]-1);
-
-  mhdNode.mhdV.phi = ((1.0 - s) * mhdInterpolate(mhdVp0,
-                                                r0, r1, t0, t1, p0, p1,
-                                                rd, td, pd,
-                                                mhdVprDimMax[0], mhdVptDimMax[0]) +
-                              s * mhdInterpolate(mhdVp1,
-                                                r0, r1, t0, t1, p0, p1,
-                                                rd, td, pd,
-                                                mhdVprDimMax[0], mhdVptDimMax[0])) * config.mhdVConvert;
-
-  //Vt
-  rd = mhdTriLinearBinarySearch(mhdVtrDim, r.r, &r0, &r1, mhdDimMin[0], mhdVtrDimMax[0]-1);
-  td = mhdTriLinearBinarySearch(mhdVttDim, r.theta, &t0, &t1, mhdDimMin[0], mhdVttDimMax[0]-1);
-  pd = mhdTriLinearBinarySearch(mhdVtpDim, r.phi, &p0, &p1, mhdDimMin[0], mhdVtpDimMax[0]-1);
-
-  mhdNode.mhdV.theta = ((1.0 - s) * mhdInterpolate(mhdVt0,
-                                                  r0, r1, t0, t1, p0, p1,
-                                                  rd, td, pd,
-                                                  mhdVtrDimMax[0], mhdVttDimMax[0]) +
-                                s * mhdInterpolate(mhdVt1,
-                                                  r0, r1, t0, t1, p0, p1,
-                                                  rd, td, pd,
-                                                  mhdVtrDimMax[0], mhdVttDimMax[0])) * config.mhdVConvert;
-
-  //Vr
-  rd = mhdTriLinearBinarySearch(mhdVrrDim, r.r, &r0, &r1, mhdDimMin[0], mhdVrrDimMax[0]-1);
-  td = mhdTriLinearBinarySearch(mhdVrtDim, r.theta, &t0, &t1, mhdDimMin[0], mhdVrtDimMax[0]-1);
-  pd = mhdTriLinearBinarySearch(mhdVrpDim, r.phi, &p0, &p1, mhdDimMin[0], mhdVrpDimMax[0]-1);
-
-  mhdNode.mhdV.r = ((1.0 - s) * mhdInterpolate(mhdVr0,
-                                              r0, r1, t0, t1, p0, p1,
-                                              rd, td, pd,
-                                              mhdVrrDimMax[0], mhdVrtDimMax[0]) +
-                            s * mhdInterpolate(mhdVr1,
-                                              r0, r1, t0, t1, p0, p1,
-                                              rd, td, pd,
-                                              mhdVrrDimMax[0], mhdVrtDimMax[0])) * config.mhdVConvert;
+  mhdFindCells(r, cell, MHD_ALL_FIELDS);
+
+  if (mhdPacked != NULL) {
+
+    // one record per corner holds every field of both slices
+    mhdInterpolatePacked(&cell[MHD_RHO], s, value);
+
+  } else {
+
+    value[MHD_BP] = mhdInterpolateCell(mhdBp0, mhdBp1, &cell[MHD_BP], s,
+                                       mhdBprDimMax[0], mhdBptDimMax[0]);
+    value[MHD_BT] = mhdInterpolateCell(mhdBt0, mhdBt1, &cell[MHD_BT], s,
+                                       mhdBtrDimMax[0], mhdBttDimMax[0]);
+    value[MHD_BR] = mhdInterpolateCell(mhdBr0, mhdBr1, &cell[MHD_BR], s,
+                                       mhdBrrDimMax[0], mhdBrtDimMax[0]);
+    value[MHD_VP] = mhdInterpolateCell(mhdVp0, mhdVp1, &cell[MHD_VP], s,
+                                       mhdVprDimMax[0], mhdVptDimMax[0]);
+    value[MHD_VT] = mhdInterpolateCell(mhdVt0, mhdVt1, &cell[MHD_VT], s,
+                                       mhdVtrDimMax[0], mhdVttDimMax[0]);
+    value[MHD_VR] = mhdInterpolateCell(mhdVr0, mhdVr1, &cell[MHD_VR], s,
+                                       mhdVrrDimMax[0], mhdVrtDimMax[0]);
+    value[MHD_RHO] = mhdInterpolateCell(mhdD0, mhdD1, &cell[MHD_RHO], s,
+                                        mhdDrDimMax[0], mhdDtDimMax[0]);
+
+  }
+
+  //B
+  mhdNode.mhdB.phi   = value[MHD_BP] * config.mhdBConvert;
+  mhdNode.mhdB.theta = value[MHD_BT] * config.mhdBConvert;
+  mhdNode.mhdB.r     = value[MHD_BR] * config.mhdBConvert;
+
+  //V
+  mhdNode.mhdV.phi   = value[MHD_VP] * config.mhdVConvert;
+  mhdNode.mhdV.theta = value[MHD_VT] * config.mhdVConvert;
+  mhdNode.mhdV.r     = value[MHD_VR] * config.mhdVConvert;
 
   // check for underflows in Vr and set to min acceptable radial flow
   if ( mhdNode.mhdV.r < (config.mhdVmin / C) ) mhdNode.mhdV.r = (config.mhdVmin / C);
 
   //D
-  rd = mhdTriLinearBinarySearch(mhdDrDim, r.r, &r0, &r1, mhdDimMin[0], mhdDrDimMax[0]-1);
-  td = mhdTriLinearBinarySearch(mhdDtDim, r.theta, &t0, &t1, mhdDimMin[0], mhdDtDimMax[0]-1);
-  pd = mhdTriLinearBinarySearch(mhdDpDim, r.phi, &p0, &p1, mhdDimMin[0], mhdDpDimMax[0]-1);
+  mhdNode.mhdD = value[MHD_RHO] * config.mhdRhoConvert;
 
-  mhdNode.mhdD = ((1.0 - s) * mhdInterpolate(mhdD0,
-                                            r0, r1, t0, t1, p0, p1,
-                                            rd, td, pd,
-                                            mhdDrDimMax[0], mhdDtDimMax[0]) +
-                          s * mhdInterpolate(mhdD1,
-                                            r0, r1, t0, t1, p0, p1,
-                                            rd, td, pd,
-                                            mhdDrDimMax[0], mhdDtDimMax[0])) * config.mhdRhoConvert;
 
+  // calculate the curl of B/B^2 if using shell drift, or interpolate
+  // it from the rho mesh where it is computed once per slice
+  if ((config.useDrift > 0) && (mhdCurl[0][0] != NULL)) {
+
+    mhdNode.curlBoverB2.r = mhdInterpolateCell(mhdCurl[0][0], mhdCurl[1][0], &cell[MHD_RHO], s,
+                                               mhdDrDimMax[0], mhdDtDimMax[0]);
+    mhdNode.curlBoverB2.theta = mhdInterpolateCell(mhdCurl[0][1], mhdCurl[1][1], &cell[MHD_RHO], s,
+                                                   mhdDrDimMax[0], mhdDtDimMax[0]);
+    mhdNode.curlBoverB2.phi = mhdInterpolateCell(mhdCurl[0][2], mhdCurl[1][2], &cell[MHD_RHO], s,
+                                                 mhdDrDimMax[0], mhdDtDimMax[0]);
+
+  } else if (config.useDrift > 0) {
+
+    // The stencil points of the curl must not replace this node's cells
+    // in mhdCellHint.
+    hintNode = mhdCellHintNode;
+    mhdCellHintNode = -1;
 
-  // calculate the curl of B/B^2 if using shell drift
-  if (config.useDrift > 0)
     mhdNode.curlBoverB2 = mhdNodeCurlBoverB2(r,
                                              mhdBp0, mhdBt0, mhdBr0,
                                              mhdBp1, mhdBt1, mhdBr1,
-                                             bp_r0, bp_r1, bp_t0, bp_t1, bp_p0, bp_p1,
-                                             bt_r0, bt_r1, bt_t0, bt_t1, bt_p0, bt_p1,
-                                             br_r0, br_r1, br_t0, br_t1, br_p0, br_p1,
+                                             cell[MHD_BP].i0[MHD_R], cell[MHD_BP].i1[MHD_R],
+                                             cell[MHD_BP].i0[MHD_THETA], cell[MHD_BP].i1[MHD_THETA],
+                                             cell[MHD_BP].i0[MHD_PHI], cell[MHD_BP].i1[MHD_PHI],
+                                             cell[MHD_BT].i0[MHD_R], cell[MHD_BT].i1[MHD_R],
+                                             cell[MHD_BT].i0[MHD_THETA], cell[MHD_BT].i1[MHD_THETA],
+                                             cell[MHD_BT].i0[MHD_PHI], cell[MHD_BT].i1[MHD_PHI],
+                                             cell[MHD_BR].i0[MHD_R], cell[MHD_BR].i1[MHD_R],
+                                             cell[MHD_BR].i0[MHD_THETA], cell[MHD_BR].i1[MHD_THETA],
+                                             cell[MHD_BR].i0[MHD_PHI], cell[MHD_BR].i1[MHD_PHI],
                                              s);
 
+    mhdCellHintNode = hintNode;
+
+  }
+
 }
 /*----------- END mhdTriLinear() --------------------------------*/
 
 
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/ void mhdTriLinearVelocity( SphVec_t position,                      /*--*/
+/*--*/                    float mhdVp0[], float mhdVt0[], float mhdVr0[], /*--*/
+/*--*/                    float mhdVp1[], float mhdVt1[], float mhdVr1[], /*--*/
+/*--*/                    Scalar_t s)                                     /*--*/
+/*--                                                                        --*/
+/*--  As mhdTriLinear(), but only the velocity (mhdNode.mhdV).              --*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+{
+
+  SphVec_t r;
+
+  MhdCell_t cell[7];
+
+  Scalar_t value[7];
+
+  r = mhdMeshPosition(position);
+
+  if (mhdPacked != NULL) {
+
+    // the records of the rho mesh hold the velocity too
+    mhdFindCells(r, cell, 1 << MHD_RHO);
+    mhdInterpolatePacked(&cell[MHD_RHO], s, value);
+
+  } else {
+
+    mhdFindCells(r, cell, MHD_VELOCITY_FIELDS);
+
+    value[MHD_VP] = mhdInterpolateCell(mhdVp0, mhdVp1, &cell[MHD_VP], s,
+                                       mhdVprDimMax[0], mhdVptDimMax[0]);
+    value[MHD_VT] = mhdInterpolateCell(mhdVt0, mhdVt1, &cell[MHD_VT], s,
+                                       mhdVtrDimMax[0], mhdVttDimMax[0]);
+    value[MHD_VR] = mhdInterpolateCell(mhdVr0, mhdVr1, &cell[MHD_VR], s,
+                                       mhdVrrDimMax[0], mhdVrtDimMax[0]);
+
+  }
+
+  mhdNode.mhdV.phi   = value[MHD_VP] * config.mhdVConvert;
+  mhdNode.mhdV.theta = value[MHD_VT] * config.mhdVConvert;
+  mhdNode.mhdV.r     = value[MHD_VR] * config.mhdVConvert;
+
+  // check for underflows in Vr and set to min acceptable radial flow
+  if ( mhdNode.mhdV.r < (config.mhdVmin / C) ) mhdNode.mhdV.r = (config.mhdVmin / C);
+
+}
+/*----------- END mhdTriLinearVelocity() ------------------------*/
+
+
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 /*--*/ SphVec_t fieldAlignedFlow(SphVec_t B)                    /*--*/
@@ -675,6 +1281,34 @@ Index_t unwindPhiOffset;
 /*----------- END fieldAlignedFlow() --------------------------------*/
 
 
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/ void mhdWindVelocity(Node_t node)                        /*--*/
+/*--*/                                                          /*--*/
+/*--  The velocity of the Parker wind model (mhdNode.mhdV).       --*/
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+{
+  Vec_t rOld;
+
+  Scalar_t rmag, rOldmag, oneOverR;
+
+  rOld = node.rOld;
+
+  rOldmag = sqrt(rOld.x * rOld.x + rOld.y * rOld.y + rOld.z * rOld.z);
+  rmag = node.rmag;
+
+  oneOverR = rOldmag / rmag;
+
+  mhdNode.mhdV.r     = node.mhdVr;
+  mhdNode.mhdV.theta = node.mhdVtheta * oneOverR;
+  mhdNode.mhdV.phi   = node.mhdVphi * oneOverR;
+
+}
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+
+
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 /*--*/ void mhdWind(Node_t node)                                /*--*/
@@ -685,15 +1319,13 @@ Index_t unwindPhiOffset;
 {
   Vec_t rOld;
 
-  Scalar_t rmag, rOldmag, oneOverR, theta, thetaOld, br, bt, bp, vr ,vt ,vp, rho;
+  Scalar_t rmag, rOldmag, oneOverR, theta, thetaOld, br, bt, bp, vr, rho;
 
   rOld  = node.rOld;
   br    = node.mhdBr;
   bt    = node.mhdBtheta;
   bp    = node.mhdBphi;
   vr    = node.mhdVr;
-  vt    = node.mhdVtheta;
-  vp    = node.mhdVphi;
   rho   = node.mhdDensity;
 
   rOldmag = sqrt(rOld.x * rOld.x + rOld.y * rOld.y + rOld.z * rOld.z);
@@ -724,9 +1356,7 @@ Index_t unwindPhiOffset;
   // visually is annoying.  Fix when there is nothing critical going on.  Haha. - MG
 
   // velocity field
-  mhdNode.mhdV.r     = vr;
-  mhdNode.mhdV.theta = vt * oneOverR;
-  mhdNode.mhdV.phi   = vp * oneOverR;
+  mhdWindVelocity(node);
 
   // density
   mhdNode.mhdD = rho * oneOverR * oneOverR;
@@ -761,6 +1391,7 @@ Index_t unwindPhiOffset;
 
   // Set the phi offset for the MHD solution rotation
   phiOffset += dtPhiOffset;
+  mhdInvalidateSamples();
 
   for (face = 0; face < NUM_FACES; face++)
   {
@@ -768,6 +1399,10 @@ Index_t unwindPhiOffset;
     {
       for (col = 0; col < FACE_COLS; col++)
       {
+
+        // only the nodes stored on this rank (see NODE_SLOT)
+        if (!LOCAL_NODE(face,row,col)) continue;
+
         for (shell = INNER_ACTIVE_SHELL; shell < LOCAL_NUM_SHELLS; shell++)
         {
 
@@ -788,7 +1423,7 @@ Index_t unwindPhiOffset;
               while ( rSpherical.phi > (2.0 * PI) ) rSpherical.phi -= (2.0 * PI);
 
             if ( (rSpherical.phi < 0.0) || (rSpherical.phi > 2.0 * PI) ) {
-              if (mpi_rank == 0) printf("WARNING: rSpherical.phi (%f) out of bounds\n", rSpherical.phi);
+              if (mpi_rank_world == 0) printf("WARNING: rSpherical.phi (%f) out of bounds\n", rSpherical.phi);
             }
 
             rOldSpherical = cartToSphPos(grid[idx_frcs(face,row,col,shell)].rOld);
@@ -801,7 +1436,7 @@ Index_t unwindPhiOffset;
               while ( rOldSpherical.phi > (2.0 * PI) ) rOldSpherical.phi -= (2.0 * PI);
 
             if ( (rOldSpherical.phi < 0.0) || (rOldSpherical.phi > 2.0 * PI) ) {
-              if (mpi_rank == 0) printf("WARNING: rOldSpherical.phi (%f) out of bounds\n", rOldSpherical.phi);
+              if (mpi_rank_world == 0) printf("WARNING: rOldSpherical.phi (%f) out of bounds\n", rOldSpherical.phi);
             }
 
             grid[idx_frcs(face,row,col,shell)].r = sphToCartPos(rSpherical);
@@ -837,7 +1472,7 @@ Index_t unwindPhiOffset;
         while ( config.obsPhi[pObsIndex] > (2.0 * PI) ) config.obsPhi[pObsIndex] -= (2.0 * PI);
 
       if ( (config.obsPhi[pObsIndex] < 0.0) || (config.obsPhi[pObsIndex] > 2.0 * PI) ) {
-        if (mpi_rank == 0) printf("WARNING: config.obsPhi[pObsIndex] (%f) out of bounds\n", config.obsPhi[pObsIndex]);
+        if (mpi_rank_world == 0) printf("WARNING: config.obsPhi[pObsIndex] (%f) out of bounds\n", config.obsPhi[pObsIndex]);
       }
 
     }
@@ -856,7 +1491,7 @@ Index_t unwindPhiOffset;
         while ( config.obsPhi[pObsIndex] > (2.0 * PI) ) config.obsPhi[pObsIndex] -= (2.0 * PI);
 
       if ( (config.obsPhi[pObsIndex] < 0.0) || (config.obsPhi[pObsIndex] > 2.0 * PI) ) {
-        if (mpi_rank == 0) printf("WARNING: config.obsPhi[pObsIndex] (%f) out of bounds\n", config.obsPhi[pObsIndex]);
+        if (mpi_rank_world == 0) printf("WARNING: config.obsPhi[pObsIndex] (%f) out of bounds\n", config.obsPhi[pObsIndex]);
       }
 
     }
@@ -885,6 +1520,9 @@ Index_t unwindPhiOffset;
   for (face = 0; face < NUM_FACES; face++) {
     for (row = 0; row < FACE_ROWS; row++) {
       for (col = 0; col < FACE_COLS; col++) {
+
+        if (!LOCAL_NODE(face,row,col)) continue;
+
         for (shell = INNER_ACTIVE_SHELL; shell < LOCAL_NUM_SHELLS; shell++) {
 
           // reset the phi offset for both r and rOld
@@ -898,7 +1536,7 @@ Index_t unwindPhiOffset;
             while (rSpherical.phi > (2.0 * PI) ) rSpherical.phi -= (2.0 * PI);
 
           if ( (rSpherical.phi < 0.0) || (rSpherical.phi > 2.0 * PI) ) {
-            if (mpi_rank == 0) printf("WARNING: rSpherical.phi (%f) out of bounds\n", rSpherical.phi);
+            if (mpi_rank_world == 0) printf("WARNING: rSpherical.phi (%f) out of bounds\n", rSpherical.phi);
           }
 
           rOldSpherical = cartToSphPos(grid[idx_frcs(face,row,col,shell)].rOld);
@@ -911,7 +1549,7 @@ Index_t unwindPhiOffset;
             while (rOldSpherical.phi > (2.0 * PI) ) rOldSpherical.phi -= (2.0 * PI);
 
           if ( (rOldSpherical.phi < 0.0) || (rOldSpherical.phi > 2.0 * PI) ) {
-            if (mpi_rank == 0) printf("WARNING: rOldSpherical.phi (%f) out of bounds\n", rOldSpherical.phi);
+            if (mpi_rank_world == 0) printf("WARNING: rOldSpherical.phi (%f) out of bounds\n", rOldSpherical.phi);
           }
 
           grid[idx_frcs(face,row,col,shell)].r = sphToCartPos(rSpherical);
@@ -942,6 +1580,7 @@ Index_t unwindPhiOffset;
   // reset the offset to zero
   azi_sun -= phiOffset;
   phiOffset = 0.0;
+  mhdInvalidateSamples();
 
 }
 /*------------------------------------------------------------------*/
@@ -961,7 +1600,7 @@ Index_t unwindPhiOffset;
   Vec_t velocity;
 
   rSphAu = cartToSphPosAu(r);
-  mhdGetNode(rSphAu, node);
+  mhdGetNodeVelocity(rSphAu, node);
   velocity = sphToCartVector(mhdNode.mhdV, r);
 
   return velocity;
@@ -1016,7 +1655,7 @@ Index_t unwindPhiOffset;
 /*--*/    void                                                      /*---*/
 /*--*/    mhdMoveNodes( Scalar_t dt )                               /*---*/
 /*-----------------------------------------------------------------------*/
-// The RK4 in here uses mhdGetNode - the previous step's s factor and file
+// The RK4 in here uses mhdGetNodeVelocity - the previous step's s factor and file
 // data are correct here since they have not been updated yet.
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
@@ -1039,6 +1678,9 @@ Index_t unwindPhiOffset;
   for (face = 0; face < NUM_FACES; face++ ){
     for (row = 0; row < FACE_ROWS; row++  ){
       for (col = 0; col < FACE_COLS; col++  ){
+
+        if (!LOCAL_NODE(face,row,col)) continue;
+
         for (shell = shell0; shell < LOCAL_NUM_SHELLS; shell++){
 
           idx = idx_frcs(face,row,col,shell);
@@ -1051,7 +1693,9 @@ Index_t unwindPhiOffset;
           grid[idx].rOld = node.r;
 
           // 4th order RungeKutta
+          mhdUseCellHint(idx);
           r1 = rungeKuttaFlow(r0, dt, node);
+          mhdUseCellHint(-1);
 
           rmag = sqrt( (r1.x*r1.x) + (r1.y*r1.y) + (r1.z*r1.z) );
 
@@ -32,14 +32,87 @@ typedef struct {
 extern mhdNode_t mhdNode;
 extern Index_t unwindPhiOffset;
 
+// The MHD fields and the axes of their meshes, as in mhdMesh[][].
+#define MHD_BP  0
+#define MHD_BT  1
+#define MHD_BR  2
+#define MHD_VP  3
+#define MHD_VT  4
+#define MHD_VR  5
+#define MHD_RHO 6
+
+#define MHD_PHI   0
+#define MHD_THETA 1
+#define MHD_R     2
+
+// Sets of fields for mhdFindCells(): a bit (1 << field) per field.
+#define MHD_ALL_FIELDS      0x7f
+#define MHD_VELOCITY_FIELDS ((1 << MHD_VP) | (1 << MHD_VT) | (1 << MHD_VR))
+
+// The mesh cell of one field around a position: the bounding indices
+// along each axis, and the fraction of the way from i0 to i1.
+typedef struct {
+  int      i0[3];
+  int      i1[3];
+  Scalar_t d[3];
+} MhdCell_t;
+
 int mhdBinarySearch(float *, float, int, int);
 
 Scalar_t mhdTriLinearBinarySearch(float *, Scalar_t, int *, int *, int, int);
 
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/  void                                                              /*--*/
+/*--*/  mhdBuildMeshIndex( void );                                        /*--*/
+/*--                                                                        --*/
+/*--  Build the lookup tables of mhdFindCells() for the meshes in          --*/
+/*--  mhdMesh[][]. Meshes that are equal are indexed once.                 --*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/  void                                                              /*--*/
+/*--*/  mhdUseCellHint( Index_t idx );                                    /*--*/
+/*--                                                                        --*/
+/*--  Start the searches of mhdFindCells() from the cells that grid node   --*/
+/*--  idx was last found in, and keep the cells found for it. A cached     --*/
+/*--  cell is only a starting point, so a stale one (after the shells      --*/
+/*--  ripple or move between ranks) costs a search but gives the same      --*/
+/*--  cells. While it is set, mhdGetNode() also keeps the velocity of      --*/
+/*--  the node for mhdGetNodeVelocity() to reuse at the same position.     --*/
+/*--  -1 stops using a node's cells.                                       --*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/  void                                                              /*--*/
+/*--*/  mhdFindCells( SphVec_t r, MhdCell_t cell[7], int fields );        /*--*/
+/*--                                                                        --*/
+/*--  Find the cell of each field around r (in RS, with phiOffset taken    --*/
+/*--  off). Gives the same cells as mhdTriLinearBinarySearch() does, with  --*/
+/*--  one table lookup for each distinct mesh. Only the fields with their  --*/
+/*--  bit (1 << field) set in fields are looked up.                        --*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+
 Scalar_t mhdInterpolate(float *,
                         int, int, int, int, int, int,
                         Scalar_t, Scalar_t, Scalar_t,
                         int, int);
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/  void                                                              /*--*/
+/*--*/  mhdPackSlice( int level, float *V[7], int plane0, int plane1 );   /*--*/
+/*--                                                                        --*/
+/*--  Resample the fields V (bp, bt, br, vp, vt, vr, rho) of one slice      --*/
+/*--  onto the rho mesh and store them as the given level (0 or 1) of the  --*/
+/*--  records of mhdPacked, for the phi planes plane0 to plane1 - 1.       --*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+
 /*----------------------------------------------------------------------------*/
 /*----------------------------------------------------------------------------*/
 /*--*/  SphVec_t                                                          /*--*/
@@ -74,6 +147,17 @@ Scalar_t mhdInterpolate(float *,
 
 
 
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/ void mhdCurlSlice( float Bp[], float Bt[], float Br[],              /*--*/
+/*--*/                    float *curl[3], int plane0, int plane1 );       /*--*/
+/*--                                                                        --*/
+/*--  Compute curl(B/B^2) of one slice (r, theta and phi components) at    --*/
+/*--  the points of the rho mesh, in the phi planes plane0 to plane1 - 1,  --*/
+/*--  as mhdNodeCurlBoverB2() does at a node.                              --*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+
 /*----------------------------------------------------------------------------*/
 /*----------------------------------------------------------------------------*/
 /*--*/ void mhdTriLinear( SphVec_t position,                              /*--*/
@@ -91,6 +175,17 @@ Scalar_t mhdInterpolate(float *,
 /*----------------------------------------------------------------------------*/
 /*----------------------------------------------------------------------------*/
 
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*--*/ void mhdTriLinearVelocity( SphVec_t position,                      /*--*/
+/*--*/                    float *, float *, float *,                      /*--*/
+/*--*/                    float *, float *, float *,                      /*--*/
+/*--*/                    Scalar_t);                                      /*--*/
+/*--                                                                        --*/
+/*--  As mhdTriLinear(), but only the velocity (mhdNode.mhdV).              --*/
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+
 
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
@@ -111,6 +206,27 @@ Scalar_t mhdInterpolate(float *,
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/ void                                                     /*--*/
+/*--*/ mhdGetNodeVelocity(SphVec_t position, Node_t node);      /*--*/
+/*--*/                                                          /*--*/
+/*--   gets only the mhd velocity at the specified position, for  --*/
+/*--   moving the nodes                                           --*/
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/ void                                                     /*--*/
+/*--*/ mhdInvalidateSamples(void);                              /*--*/
+/*--*/                                                          /*--*/
+/*--   Forget the velocities that mhdGetNode() kept for reuse by  --*/
+/*--   mhdGetNodeVelocity(). Must be called whenever s_cor, the   --*/
+/*--   slices or phiOffset change.                                --*/
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 /*--*/ void mhdWind(Node_t node);                               /*--*/
@@ -119,6 +235,14 @@ Scalar_t mhdInterpolate(float *,
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/ void mhdWindVelocity(Node_t node);                       /*--*/
+/*--*/                                                          /*--*/
+/*--  The velocity of the Parker wind model (mhdNode.mhdV).       --*/
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 /*--*/ void rotateCoupledDomain( Scalar_t dt );                 /*--*/
@@ -37,7 +37,11 @@
 #include "error.h"
 
 MPI_Comm comm_shared;       /*-- shared communicator for local node. --*/
-MPI_Rank_t mpi_rank;        /*-- rank of processor.                  --*/
+MPI_Comm comm_stream;       /*-- ranks of this face group.           --*/
+MPI_Comm comm_face;         /*-- ranks holding the same shells.      --*/
+MPI_Rank_t mpi_rank;        /*-- rank of processor in comm_stream.   --*/
+MPI_Rank_t mpi_rank_world;  /*-- rank of processor in MPI_COMM_WORLD. --*/
+MPI_Rank_t face_group;      /*-- face group of processor.            --*/
 MPI_Rank_t mpi_rank_shared; /*-- rank of processor in local node.    --*/
 int mpi_np;                 /*-- number of processors.               --*/
 int mpi_np_shared;          /*-- number of processors in local node. --*/
@@ -58,6 +62,12 @@ MPI_Status status;          /*-- error struct for mpi calls.         --*/
   MPI_Comm_rank( MPI_COMM_WORLD, &mpi_rank);
   MPI_Comm_size(MPI_COMM_WORLD, &mpi_np);
 
+  // Until initMPIFaceGroups() there is a single face group.
+  mpi_rank_world = mpi_rank;
+  face_group     = 0;
+  comm_stream    = MPI_COMM_WORLD;
+  comm_face      = MPI_COMM_SELF;
+
   MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
                       MPI_INFO_NULL, &comm_shared);
   MPI_Comm_rank(comm_shared, &mpi_rank_shared);
@@ -68,6 +78,50 @@ MPI_Status status;          /*-- error struct for mpi calls.         --*/
 /*--------END initMPI() ------------------------------------*/
 /*----------------------------------------------------------*/
 
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+/*---*/         void                                   /*---*/
+/*---*/   initMPIFaceGroups(void)                      /*---*/
+/*---                                                    ---*/
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+{
+
+  Index_t numRows;
+
+  NUM_FACE_GROUPS = config.numFaceGroups;
+  numRows = NUM_FACES * FACE_ROWS;
+
+  if ( (mpi_np % NUM_FACE_GROUPS) != 0 )
+    panic("initMPIFaceGroups: numFaceGroups must divide the number of MPI ranks.\n");
+
+  if (NUM_FACE_GROUPS > numRows)
+    panic("initMPIFaceGroups: numFaceGroups must not exceed 6*numRowsPerFace.\n");
+
+  // Consecutive world ranks go to different face groups, so the ranks
+  // that hold the same shells (and exchange halos) tend to share a node.
+  // World rank 0 is rank 0 of face group 0.
+  if (NUM_FACE_GROUPS > 1) {
+
+    face_group = mpi_rank_world % NUM_FACE_GROUPS;
+
+    MPI_Comm_split(MPI_COMM_WORLD, face_group, mpi_rank_world, &comm_stream);
+    MPI_Comm_split(MPI_COMM_WORLD, mpi_rank_world / NUM_FACE_GROUPS,
+                   mpi_rank_world, &comm_face);
+
+    MPI_Comm_rank(comm_stream, &mpi_rank);
+    N_PROCS = mpi_np / NUM_FACE_GROUPS;
+
+  }
+
+  FIRST_GROUP_STREAM = FACE_GROUP_ROW(face_group) * FACE_COLS;
+  GROUP_NUM_STREAMS  = (FACE_GROUP_ROW(face_group + 1)
+                        - FACE_GROUP_ROW(face_group)) * FACE_COLS;
+
+}
+/*--------END initMPIFaceGroups() --------------------------*/
+/*----------------------------------------------------------*/
+
 /*----------------------------------------------------------*/
 /*----------------------------------------------------------*/
 /*---*/         void                                   /*---*/
@@ -94,7 +148,9 @@ initMPI_cubeShellStruct();
 /*----------------------------------------------------------*/
 {
 
-  Index_t i, divisor, remainder, offsetSumGrid, offsetSumEparts;
+  Index_t i, divisor, remainder;
+
+  Index_t counts[N_PROCS];
 
   // allocate the arrays which are used in gatherv/scatterv
   recvCountGrid   = (Index_t *) malloc(sizeof(Index_t)*(int)N_PROCS);
@@ -106,20 +162,55 @@ initMPI_cubeShellStruct();
   divisor   = config.numNodesPerStream / N_PROCS;
   remainder = config.numNodesPerStream % N_PROCS;
 
-  offsetSumGrid   = 0;
-  offsetSumEparts = 0;
-
   for (i = 0; i < N_PROCS; i++) {
 
-    recvCountGrid[i]   = divisor;
-    recvCountEparts[i] = divisor;
+    counts[i] = divisor;
+
+    if (i < remainder)
+      counts[i] += 1;
 
-    if (i < remainder) {
+  }
 
-      recvCountGrid[i]   += 1;
-      recvCountEparts[i] += 1;
+  // Rebalancing may hand a rank up to MAX_SHELL_SHARE times the
+  // largest even share of the shells.
+  MAX_LOCAL_NUM_SHELLS = counts[0] + 1;
 
-    }
+  if (config.shellRebalanceInterval > 0) {
+
+    MAX_LOCAL_NUM_SHELLS = MAX_SHELL_SHARE * counts[0];
+
+    if (MAX_LOCAL_NUM_SHELLS > config.numNodesPerStream - N_PROCS + 1)
+      MAX_LOCAL_NUM_SHELLS = config.numNodesPerStream - N_PROCS + 1;
+
+    MAX_LOCAL_NUM_SHELLS += 1;
+
+  }
+
+  setShellCounts(counts);
+
+}
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+
+
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+/*---*/         void                                   /*---*/
+/*---*/   setShellCounts(Index_t *counts)              /*---*/
+/*---                                                    ---*/
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+{
+
+  Index_t i, offsetSumGrid, offsetSumEparts;
+
+  offsetSumGrid   = 0;
+  offsetSumEparts = 0;
+
+  for (i = 0; i < N_PROCS; i++) {
+
+    recvCountGrid[i]   = counts[i];
+    recvCountEparts[i] = counts[i];
 
     if (i == mpi_rank)
       LOCAL_NUM_SHELLS = recvCountGrid[i] + 1;
@@ -35,8 +35,20 @@
 #define PREV_PROC( mpi_rank )   ( mpi_rank - 1 )
 #define NEXT_PROC( mpi_rank )   ( mpi_rank + 1 )
 
+/*-- With shell rebalancing on, a rank holds at most this many times --*/
+/*-- the even share of the active shells.                           --*/
+#define MAX_SHELL_SHARE 2
+
+/*-- Shells are only moved if that cuts the largest shell load of a  --*/
+/*-- rank by at least this fraction.                                --*/
+#define MIN_REBALANCE_GAIN 0.05
+
 extern MPI_Comm comm_shared;       /*-- shared communicator for local node. --*/
-extern MPI_Rank_t mpi_rank;        /*-- rank of processor.                  --*/
+extern MPI_Comm comm_stream;       /*-- ranks of this face group.           --*/
+extern MPI_Comm comm_face;         /*-- ranks holding the same shells.      --*/
+extern MPI_Rank_t mpi_rank;        /*-- rank of processor in comm_stream.   --*/
+extern MPI_Rank_t mpi_rank_world;  /*-- rank of processor in MPI_COMM_WORLD. --*/
+extern MPI_Rank_t face_group;      /*-- face group of processor.            --*/
 extern MPI_Rank_t mpi_rank_shared; /*-- rank of processor in local node.    --*/
 extern int mpi_np;                 /*-- number of processors.               --*/
 extern int mpi_np_shared;          /*-- number of processors in local node. --*/
@@ -47,6 +59,23 @@ extern MPI_Win win;                /*-- window for shared arrays.           --*/
 void initMPI(int argc, char* argv[]);
 void initMPITypes();
 
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+/*---*/         void                                   /*---*/
+/*---*/   initMPIFaceGroups(void);                     /*---*/
+/*---                                                    ---*/
+/*--- Split the ranks into config.numFaceGroups face     ---*/
+/*--- groups. Each face group owns a block of the        ---*/
+/*--- (face,row) rows of the cube and runs the usual     ---*/
+/*--- shell decomposition on comm_stream, so mpi_rank    ---*/
+/*--- and N_PROCS describe a rank's place along the       ---*/
+/*--- streams. comm_face links the ranks of all face     ---*/
+/*--- groups that hold the same shells.                  ---*/
+/*--- Each group holds and updates only its own rows    ---*/
+/*--- and their halo (see initFaceGroupNodes()).         ---*/
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+
 /*----------------------------------------------------------*/
 /*----------------------------------------------------------*/
 /*---*/         void                                   /*---*/
@@ -55,5 +84,16 @@ void initMPITypes();
 /*----------------------------------------------------------*/
 /*----------------------------------------------------------*/
 
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+/*---*/         void                                   /*---*/
+/*---*/   setShellCounts(Index_t *counts);             /*---*/
+/*---                                                    ---*/
+/*--- Give rank p of comm_stream counts[p] consecutive  ---*/
+/*--- active shells of every stream: sets the gatherv/  ---*/
+/*--- scatterv counts and offsets and LOCAL_NUM_SHELLS. ---*/
+/*----------------------------------------------------------*/
+/*----------------------------------------------------------*/
+
 
 #endif
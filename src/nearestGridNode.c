@@ -96,6 +96,9 @@ getNearestGridNodesOnShell( Index_t shell,
     for (row = 0; row < FACE_ROWS; row++){
       for (col = 0; col < FACE_COLS; col++){
         
+        // only the nodes stored on this rank (see NODE_SLOT)
+        if (!LOCAL_NODE(face,row,col)) continue;
+        
         dx.x =
         grid[idx_frcs(face,row,col,shell)].r.x -
         r.x ;
@@ -125,6 +128,8 @@ getNearestGridNodesOnShell( Index_t shell,
     for (row = 0; row < FACE_ROWS; row++){
       for (col = 0; col < FACE_COLS; col++){
         
+        if (!LOCAL_NODE(face,row,col)) continue;
+        
         if ( (face != *nface) ||
             (row  != *nrow)  ||
             (col  != *ncol)  ) {
@@ -162,6 +167,8 @@ getNearestGridNodesOnShell( Index_t shell,
     for (row = 0; row < FACE_ROWS; row++){
       for (col = 0; col < FACE_COLS; col++){
         
+        if (!LOCAL_NODE(face,row,col)) continue;
+        
         if ( (face != *nface) ||
             (row  != *nrow)  ||
             (col  != *ncol)  ) {
@@ -198,6 +205,8 @@ getNearestGridNodesOnShell( Index_t shell,
     for (row = 0; row < FACE_ROWS; row++){
       for (col = 0; col < FACE_COLS; col++){
         
+        if (!LOCAL_NODE(face,row,col)) continue;
+        
         if (
             ( (face != *eface) ||
              (row  != *erow)  ||
@@ -314,6 +323,9 @@ getNearestExclGridNodesOnShell( Index_t shell,
     for (row = 0; row < FACE_ROWS; row++){
       for (col = 0; col < FACE_COLS; col++){
         
+        // only the nodes stored on this rank (see NODE_SLOT)
+        if (!LOCAL_NODE(face,row,col)) continue;
+        
         if ( (face != fa) ||
             (row  != ro) ||
             (col  != co) ) {
@@ -350,6 +362,8 @@ getNearestExclGridNodesOnShell( Index_t shell,
     for (row = 0; row < FACE_ROWS; row++){
       for (col = 0; col < FACE_COLS; col++){
         
+        if (!LOCAL_NODE(face,row,col)) continue;
+        
         if ( (face != fa) ||
             (row  != ro) ||
             (col  != co) ) {
@@ -394,6 +408,8 @@ getNearestExclGridNodesOnShell( Index_t shell,
     for (row = 0; row < FACE_ROWS; row++){
       for (col = 0; col < FACE_COLS; col++){
         
+        if (!LOCAL_NODE(face,row,col)) continue;
+        
         if ( (face != fa) ||
             (row  != ro) || 
             (col  != co) ) {
@@ -436,6 +452,8 @@ getNearestExclGridNodesOnShell( Index_t shell,
     for (row = 0; row < FACE_ROWS; row++){
       for (col = 0; col < FACE_COLS; col++){
         
+        if (!LOCAL_NODE(face,row,col)) continue;
+        
         if ( (face != fa) ||
             (row  != ro) || 
             (col  != co) ) {
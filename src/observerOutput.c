@@ -39,14 +39,16 @@ time_t start_time;
 
   /* Here print out the main parameters of the run */
 
-  if (mpi_rank ==0) {
+  if (mpi_rank_world == 0) {
     printf("\n******************************************************************\n");
     printf("*******************  EPREM Version %s  ************************\n",VERSION);
     printf("******************************************************************\n");
 
-    printf("Shells: %d\nProcessors: %d\n",
+    printf("Shells: %d\nProcessors: %d\nFace groups: %d\nEP threads per processor: %d\n",
            TOTAL_NUM_SHELLS,
-           N_PROCS);
+           mpi_np,
+           NUM_FACE_GROUPS,
+           N_THREADS);
 
     if (config.mhdCouple) {
 
@@ -78,7 +80,7 @@ time_t start_time;
   }
 
 
-  if (mpi_rank == 0) {
+  if (mpi_rank_world == 0) {
 
     rpout = fopen("./epremRunParams.dat","w");
 
@@ -129,12 +131,12 @@ time_t start_time;
     fprintf(rpout,"NUM_MUSTEPS\n");
     fprintf(rpout,"%i\n",NUM_MUSTEPS);
     fprintf(rpout,"N_PROCS\n");
-    fprintf(rpout,"%i\n",N_PROCS);
+    fprintf(rpout,"%i\n",mpi_np);
     fprintf(rpout,"TOTAL_NUM_SHELLS\n");
     fprintf(rpout,"%i\n",TOTAL_NUM_SHELLS);
     fclose(rpout);
 
-  } /* if mpi_rank ==0 */
+  } /* if mpi_rank_world ==0 */
 
 }/*-------- END RunParamsOut()      --------------------------------*/
 /*------------------------------------------------------------------*/
@@ -185,19 +187,19 @@ time_t start_time;
 
   timer_other = timer_wall - timer_sum;
 
-  all_timer_diffusestream= malloc(N_PROCS*sizeof(double));
-  all_timer_adiabaticfocus= malloc(N_PROCS*sizeof(double));
-  all_timer_adiabaticchange= malloc(N_PROCS*sizeof(double));
-  all_timer_diffuseshell= malloc(N_PROCS*sizeof(double));
-  all_timer_driftshell= malloc(N_PROCS*sizeof(double));
-  all_timer_eptotal= malloc(N_PROCS*sizeof(double));
-  all_timer_mhd_io= malloc(N_PROCS*sizeof(double));
-  all_timer_eprem_io= malloc(N_PROCS*sizeof(double));
-  all_timer_init= malloc(N_PROCS*sizeof(double));
-  all_timer_other= malloc(N_PROCS*sizeof(double));
-  all_timer_wall= malloc(N_PROCS*sizeof(double));
-  all_timer_MPIgatherscatter= malloc(N_PROCS*sizeof(double));
-  all_timer_MPIsendrecv= malloc(N_PROCS*sizeof(double));
+  all_timer_diffusestream= malloc(mpi_np*sizeof(double));
+  all_timer_adiabaticfocus= malloc(mpi_np*sizeof(double));
+  all_timer_adiabaticchange= malloc(mpi_np*sizeof(double));
+  all_timer_diffuseshell= malloc(mpi_np*sizeof(double));
+  all_timer_driftshell= malloc(mpi_np*sizeof(double));
+  all_timer_eptotal= malloc(mpi_np*sizeof(double));
+  all_timer_mhd_io= malloc(mpi_np*sizeof(double));
+  all_timer_eprem_io= malloc(mpi_np*sizeof(double));
+  all_timer_init= malloc(mpi_np*sizeof(double));
+  all_timer_other= malloc(mpi_np*sizeof(double));
+  all_timer_wall= malloc(mpi_np*sizeof(double));
+  all_timer_MPIgatherscatter= malloc(mpi_np*sizeof(double));
+  all_timer_MPIsendrecv= malloc(mpi_np*sizeof(double));
 //
 // ****** Gather all timers form all processors.
 //
@@ -216,7 +218,7 @@ time_t start_time;
   MPI_Allgather (&timer_MPIsendrecv,     1,MPI_DOUBLE,all_timer_MPIsendrecv,     1,MPI_DOUBLE,MPI_COMM_WORLD);
 
   
-  if (mpi_rank == 0){
+  if (mpi_rank_world == 0){
     
     time ( &curr_time );
     
@@ -254,144 +256,144 @@ time_t start_time;
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_MPIgatherscatter[i]>max_tmp) max_tmp=all_timer_MPIgatherscatter[i];
       if(all_timer_MPIgatherscatter[i]<min_tmp) min_tmp=all_timer_MPIgatherscatter[i];
       mean = mean + all_timer_MPIgatherscatter[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","|->MPI (Gather/Scatter)",mean,max_tmp,min_tmp);
     
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_MPIsendrecv[i]>max_tmp) max_tmp=all_timer_MPIsendrecv[i];
       if(all_timer_MPIsendrecv[i]<min_tmp) min_tmp=all_timer_MPIsendrecv[i];
       mean = mean + all_timer_MPIsendrecv[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","|->MPI (Send/Recv)",mean,max_tmp,min_tmp);
     
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_init[i]>max_tmp) max_tmp=all_timer_init[i];
       if(all_timer_init[i]<min_tmp) min_tmp=all_timer_init[i];
       mean = mean + all_timer_init[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","Initialization",mean,max_tmp,min_tmp);
  
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_eprem_io[i]>max_tmp) max_tmp=all_timer_eprem_io[i];
       if(all_timer_eprem_io[i]<min_tmp) min_tmp=all_timer_eprem_io[i];
       mean = mean + all_timer_eprem_io[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","IO (EPREM)",mean,max_tmp,min_tmp);
 
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_mhd_io[i]>max_tmp) max_tmp=all_timer_mhd_io[i];
       if(all_timer_mhd_io[i]<min_tmp) min_tmp=all_timer_mhd_io[i];
       mean = mean + all_timer_mhd_io[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","IO (MHD)",mean,max_tmp,min_tmp);
 
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_eptotal[i]>max_tmp) max_tmp=all_timer_eptotal[i];
       if(all_timer_eptotal[i]<min_tmp) min_tmp=all_timer_eptotal[i];
       mean = mean + all_timer_eptotal[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","EP Total",mean,max_tmp,min_tmp);
 
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_diffusestream[i]>max_tmp) max_tmp=all_timer_diffusestream[i];
       if(all_timer_diffusestream[i]<min_tmp) min_tmp=all_timer_diffusestream[i];
       mean = mean + all_timer_diffusestream[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","|->EP DiffuseStream",mean,max_tmp,min_tmp);
 
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_adiabaticfocus[i]>max_tmp) max_tmp=all_timer_adiabaticfocus[i];
       if(all_timer_adiabaticfocus[i]<min_tmp) min_tmp=all_timer_adiabaticfocus[i];
       mean = mean + all_timer_adiabaticfocus[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","|->EP Adiabatic Focus",mean,max_tmp,min_tmp);
 
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_adiabaticchange[i]>max_tmp) max_tmp=all_timer_adiabaticchange[i];
       if(all_timer_adiabaticchange[i]<min_tmp) min_tmp=all_timer_adiabaticchange[i];
       mean = mean + all_timer_adiabaticchange[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","|->EP Adiabatic Change",mean,max_tmp,min_tmp);
 
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_diffuseshell[i]>max_tmp) max_tmp=all_timer_diffuseshell[i];
       if(all_timer_diffuseshell[i]<min_tmp) min_tmp=all_timer_diffuseshell[i];
       mean = mean + all_timer_diffuseshell[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","|->EP Diffuse Shell",mean,max_tmp,min_tmp);
 
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_driftshell[i]>max_tmp) max_tmp=all_timer_driftshell[i];
       if(all_timer_driftshell[i]<min_tmp) min_tmp=all_timer_driftshell[i];
       mean = mean + all_timer_driftshell[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","|->EP Drift Shell",mean,max_tmp,min_tmp);
 
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_other[i]>max_tmp) max_tmp=all_timer_other[i];
       if(all_timer_other[i]<min_tmp) min_tmp=all_timer_other[i];
       mean = mean + all_timer_other[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","Other",mean,max_tmp,min_tmp);
 
     max_tmp=0.0;
     min_tmp=1.0e200;
     mean=0.0;
-    for (i=0;i<N_PROCS;i++){
+    for (i=0;i<mpi_np;i++){
       if(all_timer_wall[i]>max_tmp) max_tmp=all_timer_wall[i];
       if(all_timer_wall[i]<min_tmp) min_tmp=all_timer_wall[i];
       mean = mean + all_timer_wall[i];
     }
-    mean = mean/N_PROCS;
+    mean = mean/mpi_np;
     fprintf(rpout,"%-24s  %9.2f  %9.2f  %9.2f\n","Total (Wall)",mean,max_tmp,min_tmp);
 
     fprintf(rpout,"--------------------------------------------------------\n\n");
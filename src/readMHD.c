@@ -10,7 +10,11 @@
 /* Temple Place, Suite 330, Boston MA 02111-1307 USA or by viewing the */
 /* license online at http://www.gnu.org/copyleft/gpl.html. */
 
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <hdf5.h>
 #include <hdf5_hl.h>
 
@@ -25,9 +29,11 @@
 #include "error.h"
 #include "simCore.h"
 #include "flow.h"
+#include "mhdInterp.h"
 #include "observerOutput.h"
 #include "timers.h"
 #include "mhdIO.h"
+#include "mhdCache.h"
 
 Scalar_t *mhdTime;
 
@@ -39,6 +45,7 @@ Index_t mhdFileIndex1;
 
 Index_t mhdFileIndex_loaded0=-9999;
 Index_t mhdFileIndex_loaded1=-9999;
+Index_t mhdFileIndex_prefetch=-9999;
 
 Index_t mhdMallocFlag;
 Index_t mhdEqFileFlag;
@@ -133,6 +140,95 @@ MPI_Win mhdVt_1_win;
 MPI_Win mhdVr_1_win;
 MPI_Win mhdD_1_win;
 
+float * mhdBp_2;
+float * mhdBt_2;
+float * mhdBr_2;
+float * mhdVp_2;
+float * mhdVt_2;
+float * mhdVr_2;
+float * mhdD_2;
+
+MPI_Win mhdBp_2_win;
+MPI_Win mhdBt_2_win;
+MPI_Win mhdBr_2_win;
+MPI_Win mhdVp_2_win;
+MPI_Win mhdVt_2_win;
+MPI_Win mhdVr_2_win;
+MPI_Win mhdD_2_win;
+
+MhdRecord_t * mhdPacked = NULL;
+MPI_Win mhdPacked_win;
+
+// The files whose slices levels 0 and 1 of mhdPacked hold.
+static Index_t mhdPackedIndex[2] = {-9999, -9999};
+
+float * mhdCurl[2][3] = {{NULL, NULL, NULL}, {NULL, NULL, NULL}};
+
+// The windows of mhdCurl, the arrays they hold (until the first slices
+// are loaded, mhdCurl stays NULL), and the files of the two levels.
+static float * mhdCurlData[2][3];
+static MPI_Win mhdCurlWin[2][3];
+static Index_t mhdCurlAllocated = 0;
+static Index_t mhdCurlIndex[2] = {-9999, -9999};
+
+// The three MHD time slices by field (Bp, Bt, Br, Vp, Vt, Vr, D):
+// slices 0 and 1 bound the current time, slice 2 takes the prefetch.
+// Moving a slice from one slot to another swaps these pointers.
+static float **mhdSlot[3][7] = {
+  {&mhdBp_0, &mhdBt_0, &mhdBr_0, &mhdVp_0, &mhdVt_0, &mhdVr_0, &mhdD_0},
+  {&mhdBp_1, &mhdBt_1, &mhdBr_1, &mhdVp_1, &mhdVt_1, &mhdVr_1, &mhdD_1},
+  {&mhdBp_2, &mhdBt_2, &mhdBr_2, &mhdVp_2, &mhdVt_2, &mhdVr_2, &mhdD_2}
+};
+
+static MPI_Win *mhdSlotWin[3][7] = {
+  {&mhdBp_0_win, &mhdBt_0_win, &mhdBr_0_win, &mhdVp_0_win, &mhdVt_0_win, &mhdVr_0_win, &mhdD_0_win},
+  {&mhdBp_1_win, &mhdBt_1_win, &mhdBr_1_win, &mhdVp_1_win, &mhdVt_1_win, &mhdVr_1_win, &mhdD_1_win},
+  {&mhdBp_2_win, &mhdBt_2_win, &mhdBr_2_win, &mhdVp_2_win, &mhdVt_2_win, &mhdVr_2_win, &mhdD_2_win}
+};
+
+// The mesh of each field along phi, theta and r, and its length.
+float **mhdMesh[7][3] = {
+  {&mhdBppDim, &mhdBptDim, &mhdBprDim}, {&mhdBtpDim, &mhdBttDim, &mhdBtrDim},
+  {&mhdBrpDim, &mhdBrtDim, &mhdBrrDim}, {&mhdVppDim, &mhdVptDim, &mhdVprDim},
+  {&mhdVtpDim, &mhdVttDim, &mhdVtrDim}, {&mhdVrpDim, &mhdVrtDim, &mhdVrrDim},
+  {&mhdDpDim,  &mhdDtDim,  &mhdDrDim}
+};
+
+int32_t *mhdMeshSize[7][3] = {
+  {mhdBppDimMax, mhdBptDimMax, mhdBprDimMax}, {mhdBtpDimMax, mhdBttDimMax, mhdBtrDimMax},
+  {mhdBrpDimMax, mhdBrtDimMax, mhdBrrDimMax}, {mhdVppDimMax, mhdVptDimMax, mhdVprDimMax},
+  {mhdVtpDimMax, mhdVttDimMax, mhdVtrDimMax}, {mhdVrpDimMax, mhdVrtDimMax, mhdVrrDimMax},
+  {mhdDpDimMax,  mhdDtDimMax,  mhdDrDimMax}
+};
+
+// With mhdCacheFile, the meshes, times and slices are all read where
+// the cache is mapped (see mhdCache.h), and no shared windows are used.
+static Index_t mhdCacheMapped = 0;
+
+// The times as listed in mhdTime.txt (or in the cache).
+static double *mhdListedTime = NULL;
+
+// The full length of the r mesh of each field. With mhdRadialWindow,
+// mhdB?rDimMax etc. hold only the points out to the radial window, and
+// the slices are read and stored with rows of that length.
+static int32_t mhdRadialFull[7];
+
+// The first call of mhdGetInterpData comes before the grid is placed
+// (see eprem.c), so the radial window is not taken from the grid then.
+static Index_t mhdGridPlaced = 0;
+
+// The I/O thread that fills slice 2 on rank 0 of comm_shared. It only
+// reads files and makes no MPI calls (MPI runs MPI_THREAD_FUNNELED).
+static pthread_t mhdPrefetchThread;
+static Index_t mhdPrefetchRunning = 0;
+
+static void mhdFinishPrefetch(void);
+
+static void mhdReadFiles(Index_t fileIndex,
+                         float *mhdBp[], float *mhdBt[], float *mhdBr[],
+                         float *mhdVp[], float *mhdVt[], float *mhdVr[],
+                         float *mhdD[], int reader, int numReaders);
+
 int coupleStarted=0;
 char file_extension[5];
 
@@ -145,7 +241,7 @@ char file_extension[5];
 /*--  element.                                                    --*/
 /*------------------------------------------------------------------*/
 {/*-----------------------------------------------------------------*/
-  if ((status != 0) && (mpi_rank == 0)) {
+  if ((status != 0) && (mpi_rank_world == 0)) {
     printf("\n\nERROR WITH AN SD! status = %d\n",status);
   }
 }/*-------- END ERR(intn status)  ----------------------------------*/
@@ -176,6 +272,563 @@ char file_extension[5];
 }/*-------- END mhdFetchCouplingInfo()  ----------------------------*/
 /*------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdSetRadialRange(void)                              /*--*/
+/*--                                                              --*/
+/*--  Set rScale and mhdRadialMin/Max to the radii that the r     --*/
+/*--  meshes of all seven fields cover, and note the full length  --*/
+/*--  of each r mesh.                                             --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  int field;
+  Scalar_t rMin, rMax, rTemp;
+
+  for (field = 0; field < 7; field++)
+    mhdRadialFull[field] = *mhdMeshSize[field][2];
+
+  rMin = (*mhdMesh[0][2])[0];
+  rMax = (*mhdMesh[0][2])[*mhdMeshSize[0][2] - 1];
+
+  for (field = 1; field < 7; field++) {
+
+    rTemp = (*mhdMesh[field][2])[0];
+    if (rTemp > rMin)
+      rMin = rTemp;
+
+    rTemp = (*mhdMesh[field][2])[*mhdMeshSize[field][2] - 1];
+    if (rTemp < rMax)
+      rMax = rTemp;
+
+  }
+
+  // set rScale, and mhdRadialMin/Max
+  config.rScale = rMin * RSAU;
+  config.mhdRadialMin = rMin;
+  config.mhdRadialMax = rMax;
+
+}/*-------- END mhdSetRadialRange()  -------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdCachePut(FILE *cfile, int64_t offset,             /*--*/
+/*--*/                 const void *data, size_t bytes)          /*--*/
+/*--                                                              --*/
+/*--  Write one block of the cache file at its offset.            --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  if ( (fseeko(cfile, (off_t) offset, SEEK_SET) != 0) ||
+       (fwrite(data, 1, bytes, cfile) != bytes) )
+    panic("mhdCachePut: unable to write the MHD cache\n");
+
+}/*-------- END mhdCachePut()  -------------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdWriteCache(void)                                  /*--*/
+/*--                                                              --*/
+/*--  Convert the MHD sequence in mhdDirectory into the cache file --*/
+/*--  mhdCacheFile: meshes, times and every time slice. The file  --*/
+/*--  is written under a temporary name and renamed when complete.--*/
+/*--  Called by one rank, after mhdReadFieldIndex().              --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  MhdCacheHeader_t header;
+  FILE *cfile;
+  char tmpName[MAX_STRING_SIZE + 8];
+  float *fields[7];
+  Index_t fileIndex;
+  int field, axis;
+
+  double timer_tmp = 0;
+
+  timer_tmp = MPI_Wtime();
+
+  memset(&header, 0, sizeof(header));
+
+  header.numFiles = config.mhdNumFiles;
+
+  for (field = 0; field < 7; field++)
+    for (axis = 0; axis < 3; axis++)
+      header.dims[field][axis] = *mhdMeshSize[field][axis];
+
+  mhdCacheLayout(&header);
+
+  snprintf(tmpName, sizeof(tmpName), "%s.tmp", config.mhdCacheFile);
+
+  cfile = fopen(tmpName, "wb");
+  if (cfile == NULL) {
+    printf("ERROR - Could not create file \"%s\"\n", tmpName);
+    panic("Can't write the MHD cache.");
+  }
+
+  mhdCachePut(cfile, 0, &header, sizeof(header));
+
+  for (field = 0; field < 7; field++)
+    for (axis = 0; axis < 3; axis++)
+      mhdCachePut(cfile, header.meshOffset[field][axis], *mhdMesh[field][axis],
+                  sizeof(float) * header.dims[field][axis]);
+
+  mhdCachePut(cfile, header.timeOffset, mhdListedTime, sizeof(double) * header.numFiles);
+
+  for (field = 0; field < 7; field++)
+    fields[field] = (float *) malloc(sizeof(float) * header.dims[field][0]
+                                     * header.dims[field][1] * header.dims[field][2]);
+
+  for (fileIndex = 0; fileIndex < header.numFiles; fileIndex++) {
+
+    mhdReadFiles(fileIndex, &fields[0], &fields[1], &fields[2],
+                 &fields[3], &fields[4], &fields[5], &fields[6], 0, 1);
+
+    for (field = 0; field < 7; field++)
+      mhdCachePut(cfile, header.sliceOffset + header.sliceBytes * fileIndex
+                         + header.fieldOffset[field], fields[field],
+                  sizeof(float) * header.dims[field][0]
+                  * header.dims[field][1] * header.dims[field][2]);
+
+  }
+
+  for (field = 0; field < 7; field++)
+    free(fields[field]);
+
+  // Pad the last slice out to its full length.
+  if ( (fflush(cfile) != 0) ||
+       (ftruncate(fileno(cfile), (off_t) header.fileBytes) != 0) ||
+       (fclose(cfile) != 0) ||
+       (rename(tmpName, config.mhdCacheFile) != 0) )
+    panic("mhdWriteCache: unable to finish the MHD cache\n");
+
+  printf("  --> IO MHD: Wrote %d coronal sequences to cache %s.\n",
+         header.numFiles, config.mhdCacheFile);
+
+  timer_mhd_io = timer_mhd_io + (MPI_Wtime() - timer_tmp);
+
+}/*-------- END mhdWriteCache()  -----------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdAllocateSlots(void)                               /*--*/
+/*--                                                              --*/
+/*--  Allocate the shared windows of slots 0 and 1, and of slot 2 --*/
+/*--  with mhdPrefetch, at the current size of the fields. The    --*/
+/*--  memory is on rank 0 of comm_shared.                         --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  MPI_Aint N, size;
+  int disp_unit, slot, field, numSlots;
+
+  numSlots = (config.mhdPrefetch > 0) ? 3 : 2;
+
+  for (slot = 0; slot < numSlots; slot++) {
+    for (field = 0; field < 7; field++) {
+
+      if (mpi_rank_shared == 0)
+        N = (MPI_Aint)(*mhdMeshSize[field][0]) * (*mhdMeshSize[field][1]) * (*mhdMeshSize[field][2]);
+      else
+        N = 0;
+
+      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared,
+                              mhdSlot[slot][field], mhdSlotWin[slot][field]);
+      if (mpi_rank_shared != 0)
+        MPI_Win_shared_query(*mhdSlotWin[slot][field], 0, &size, &disp_unit, mhdSlot[slot][field]);
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, *mhdSlotWin[slot][field]);
+
+    }
+  }
+
+}/*-------- END mhdAllocateSlots()  --------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdFreeSlots(void)                                   /*--*/
+/*--                                                              --*/
+/*--  Free the shared windows of mhdAllocateSlots().              --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  int slot, field, numSlots;
+
+  numSlots = (config.mhdPrefetch > 0) ? 3 : 2;
+
+  for (slot = 0; slot < numSlots; slot++) {
+    for (field = 0; field < 7; field++) {
+      MPI_Win_unlock_all(*mhdSlotWin[slot][field]);
+      MPI_Win_free(mhdSlotWin[slot][field]);
+    }
+  }
+
+}/*-------- END mhdFreeSlots()  ------------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdAllocatePacked(void)                              /*--*/
+/*--                                                              --*/
+/*--  Allocate the shared window of mhdPacked at the current size --*/
+/*--  of the rho mesh, on rank 0 of comm_shared. It holds nothing  --*/
+/*--  until mhdUpdatePacked() fills it.                            --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  MPI_Aint N, size;
+  int disp_unit;
+
+  if (mpi_rank_shared == 0)
+    N = (MPI_Aint)(*mhdMeshSize[6][0]) * (*mhdMeshSize[6][1]) * (*mhdMeshSize[6][2]);
+  else
+    N = 0;
+
+  MPI_Win_allocate_shared(N*sizeof(MhdRecord_t), sizeof(MhdRecord_t), MPI_INFO_NULL,
+                          comm_shared, &mhdPacked, &mhdPacked_win);
+  if (mpi_rank_shared != 0)
+    MPI_Win_shared_query(mhdPacked_win, 0, &size, &disp_unit, &mhdPacked);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdPacked_win);
+
+  mhdPackedIndex[0] = -9999;
+  mhdPackedIndex[1] = -9999;
+
+}/*-------- END mhdAllocatePacked()  -------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdFreePacked(void)                                  /*--*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  MPI_Win_unlock_all(mhdPacked_win);
+  MPI_Win_free(&mhdPacked_win);
+
+  mhdPacked = NULL;
+
+}/*-------- END mhdFreePacked()  -----------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdUpdatePacked(void)                                /*--*/
+/*--                                                              --*/
+/*--  Bring mhdPacked up to the slices in slots 0 and 1. The ranks --*/
+/*--  of comm_shared each resample their share of the phi planes.  --*/
+/*--  A slice that moves from level 1 to level 0 is copied, not    --*/
+/*--  resampled. Must be called by all ranks, with the slots read. --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  int plane0, plane1, numPlanes, slot, field;
+  Index_t record, record0, record1;
+  float *V[7];
+
+  if (mhdPacked == NULL)
+    return;
+
+  if ((mhdFileIndex_loaded0 == mhdPackedIndex[0]) && (mhdFileIndex_loaded1 == mhdPackedIndex[1]))
+    return;
+
+  numPlanes = *mhdMeshSize[6][0];
+  plane0 = numPlanes * mpi_rank_shared / mpi_np_shared;
+  plane1 = numPlanes * (mpi_rank_shared + 1) / mpi_np_shared;
+
+  record0 = (Index_t)plane0 * (*mhdMeshSize[6][1]) * (*mhdMeshSize[6][2]);
+  record1 = (Index_t)plane1 * (*mhdMeshSize[6][1]) * (*mhdMeshSize[6][2]);
+
+  // No rank may still interpolate from the records.
+  MPI_Barrier(comm_shared);
+
+  if ((mhdFileIndex_loaded0 != mhdPackedIndex[0]) && (mhdFileIndex_loaded0 == mhdPackedIndex[1])) {
+    for (record = record0; record < record1; record++)
+      memcpy(mhdPacked[record].v[0], mhdPacked[record].v[1], sizeof(mhdPacked[record].v[0]));
+    mhdPackedIndex[0] = mhdPackedIndex[1];
+    mhdPackedIndex[1] = -9999;
+  }
+
+  for (slot = 0; slot < 2; slot++) {
+
+    if ((slot == 0) ? (mhdFileIndex_loaded0 == mhdPackedIndex[0])
+                    : (mhdFileIndex_loaded1 == mhdPackedIndex[1]))
+      continue;
+
+    for (field = 0; field < 7; field++)
+      V[field] = *mhdSlot[slot][field];
+
+    mhdPackSlice(slot, V, plane0, plane1);
+
+  }
+
+  mhdPackedIndex[0] = mhdFileIndex_loaded0;
+  mhdPackedIndex[1] = mhdFileIndex_loaded1;
+
+  MPI_Win_sync(mhdPacked_win);
+  MPI_Barrier(comm_shared);
+
+}/*-------- END mhdUpdatePacked()  ---------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdAllocateCurl(void)                                /*--*/
+/*--                                                              --*/
+/*--  Allocate the shared windows of mhdCurl at the current size  --*/
+/*--  of the rho mesh, on rank 0 of comm_shared. They hold nothing --*/
+/*--  until mhdUpdateCurl() fills them.                            --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  MPI_Aint N, size;
+  int disp_unit, level, component;
+
+  if (mpi_rank_shared == 0)
+    N = (MPI_Aint)(*mhdMeshSize[6][0]) * (*mhdMeshSize[6][1]) * (*mhdMeshSize[6][2]);
+  else
+    N = 0;
+
+  for (level = 0; level < 2; level++) {
+    for (component = 0; component < 3; component++) {
+
+      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared,
+                              &mhdCurlData[level][component], &mhdCurlWin[level][component]);
+      if (mpi_rank_shared != 0)
+        MPI_Win_shared_query(mhdCurlWin[level][component], 0, &size, &disp_unit,
+                             &mhdCurlData[level][component]);
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdCurlWin[level][component]);
+
+      mhdCurl[level][component] = NULL;
+
+    }
+    mhdCurlIndex[level] = -9999;
+  }
+
+  mhdCurlAllocated = 1;
+
+}/*-------- END mhdAllocateCurl()  ---------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdFreeCurl(void)                                    /*--*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  int level, component;
+
+  for (level = 0; level < 2; level++) {
+    for (component = 0; component < 3; component++) {
+      MPI_Win_unlock_all(mhdCurlWin[level][component]);
+      MPI_Win_free(&mhdCurlWin[level][component]);
+      mhdCurl[level][component] = NULL;
+    }
+  }
+
+  mhdCurlAllocated = 0;
+
+}/*-------- END mhdFreeCurl()  -------------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdUpdateCurl(void)                                  /*--*/
+/*--                                                              --*/
+/*--  Bring mhdCurl up to the slices in slots 0 and 1. The ranks   --*/
+/*--  of comm_shared each compute their share of the phi planes.   --*/
+/*--  A level 1 that becomes level 0 is handed over, not computed  --*/
+/*--  again. Must be called by all ranks, with the slots read.     --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  int plane0, plane1, numPlanes, level, component;
+  float *data;
+  MPI_Win win;
+
+  if (mhdCurlAllocated == 0)
+    return;
+
+  if ((mhdFileIndex_loaded0 == mhdCurlIndex[0]) && (mhdFileIndex_loaded1 == mhdCurlIndex[1]))
+    return;
+
+  numPlanes = *mhdMeshSize[6][0];
+  plane0 = numPlanes * mpi_rank_shared / mpi_np_shared;
+  plane1 = numPlanes * (mpi_rank_shared + 1) / mpi_np_shared;
+
+  // No rank may still interpolate from the fields.
+  MPI_Barrier(comm_shared);
+
+  if ((mhdFileIndex_loaded0 != mhdCurlIndex[0]) && (mhdFileIndex_loaded0 == mhdCurlIndex[1])) {
+    for (component = 0; component < 3; component++) {
+      data = mhdCurlData[0][component];
+      mhdCurlData[0][component] = mhdCurlData[1][component];
+      mhdCurlData[1][component] = data;
+      win = mhdCurlWin[0][component];
+      mhdCurlWin[0][component] = mhdCurlWin[1][component];
+      mhdCurlWin[1][component] = win;
+    }
+    mhdCurlIndex[0] = mhdCurlIndex[1];
+    mhdCurlIndex[1] = -9999;
+  }
+
+  for (level = 0; level < 2; level++) {
+
+    if ((level == 0) ? (mhdFileIndex_loaded0 == mhdCurlIndex[0])
+                     : (mhdFileIndex_loaded1 == mhdCurlIndex[1]))
+      continue;
+
+    mhdCurlSlice(*mhdSlot[level][0], *mhdSlot[level][1], *mhdSlot[level][2],
+                 mhdCurlData[level], plane0, plane1);
+
+  }
+
+  mhdCurlIndex[0] = mhdFileIndex_loaded0;
+  mhdCurlIndex[1] = mhdFileIndex_loaded1;
+
+  for (level = 0; level < 2; level++) {
+    for (component = 0; component < 3; component++) {
+      MPI_Win_sync(mhdCurlWin[level][component]);
+      mhdCurl[level][component] = mhdCurlData[level][component];
+    }
+  }
+
+  MPI_Barrier(comm_shared);
+
+}/*-------- END mhdUpdateCurl()  -----------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static Index_t                                       /*--*/
+/*--*/     mhdSetRadialWindow(Scalar_t rNeed, int margin,       /*--*/
+/*--*/                        int count[7])                     /*--*/
+/*--                                                              --*/
+/*--  Widen the radial window of each field (the number of r mesh --*/
+/*--  points held, from the inner boundary out) to the first point --*/
+/*--  at or beyond rNeed plus margin points. A window that already --*/
+/*--  reaches margin/2 points beyond rNeed is left alone, and no   --*/
+/*--  window shrinks. The new windows go to count, not to          --*/
+/*--  mhdMeshSize, which the caller sets once nothing reads it.    --*/
+/*--  Returns whether any window changed.                          --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  int field, points;
+  Index_t changed = 0;
+  float *mesh;
+
+  for (field = 0; field < 7; field++) {
+
+    count[field] = *mhdMeshSize[field][2];
+
+    mesh = *mhdMesh[field][2];
+
+    // points up to and including the first one at or beyond rNeed
+    points = 1;
+    while ((points < mhdRadialFull[field]) && (mesh[points - 1] < rNeed))
+      points++;
+
+    // at least one cell to interpolate in
+    if ((points < 2) && (mhdRadialFull[field] > 1))
+      points = 2;
+
+    if (points + margin / 2 <= count[field])
+      continue;
+
+    points += margin;
+    if (points > mhdRadialFull[field])
+      points = mhdRadialFull[field];
+
+    if (points > count[field]) {
+      count[field] = points;
+      changed = 1;
+    }
+
+  }
+
+  return changed;
+
+}/*-------- END mhdSetRadialWindow()  ------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdUpdateRadialWindow(void)                          /*--*/
+/*--                                                              --*/
+/*--  Widen the radial window to the outermost node of the grid.  --*/
+/*--  If it changes, the slots are allocated again at the new     --*/
+/*--  size and every slice is read again. Must be called by all   --*/
+/*--  ranks.                                                      --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  Index_t face, row, col, shell;
+  Scalar_t rmag, rLocal, rNeed;
+  int field, count[7];
+
+  rLocal = 0.0;
+
+  for (face = 0; face < NUM_FACES; face++)
+    for (row = 0; row < FACE_ROWS; row++)
+      for (col = 0; col < FACE_COLS; col++)
+        for (shell = 0; shell < LOCAL_NUM_SHELLS; shell++) {
+          if (!LOCAL_NODE(face,row,col)) continue;
+          rmag = grid[idx_frcs(face,row,col,shell)].rmag;
+          if (rmag > rLocal)
+            rLocal = rmag;
+        }
+
+  MPI_Allreduce(&rLocal, &rNeed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+  // grid radii are in units of rScale (AU), the MHD mesh in RS
+  if (mhdSetRadialWindow(rNeed * config.rScale / RSAU, config.mhdRadialWindow, count) == 0)
+    return;
+
+  // Nothing may still use or fill the slots. The prefetch thread reads
+  // the mesh sizes to size its slabs, so they change only after it is done.
+  mhdFinishPrefetch();
+  MPI_Barrier(comm_shared);
+
+  for (field = 0; field < 7; field++)
+    *mhdMeshSize[field][2] = count[field];
+
+  mhdFreeSlots();
+  mhdAllocateSlots();
+
+  if (mhdPacked != NULL) {
+    mhdFreePacked();
+    mhdAllocatePacked();
+  }
+
+  if (mhdCurlAllocated > 0) {
+    mhdFreeCurl();
+    mhdAllocateCurl();
+  }
+
+  mhdFileIndex_loaded0 = -9999;
+  mhdFileIndex_loaded1 = -9999;
+  mhdFileIndex_prefetch = -9999;
+
+  ROOT_MSG("  --> IO MHD: Radial window widened to %d of %d points.\n",
+           *mhdMeshSize[2][2], mhdRadialFull[2]);
+
+}/*-------- END mhdUpdateRadialWindow()  ---------------------------*/
+/*------------------------------------------------------------------*/
+
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 /*--*/     void                                                 /*--*/
@@ -201,9 +854,18 @@ char file_extension[5];
 
   Scalar_t initialTime, timeVar;
 
-  MPI_Aint N;
-  MPI_Aint size;
-  int disp_unit;
+  int field, axis, count[7];
+
+  // a cache, if there is one, holds the time list too
+  if ((config.mhdCacheFile[0] != '\0') && (mhdCacheMapped == 0))
+    mhdCacheMapped = mhdCacheMap(config.mhdCacheFile);
+
+  if (mhdCacheMapped > 0) {
+
+    nFileLines = mhdCacheHeader()->numFiles;
+    mhdListedTime = mhdCacheTimes();
+
+  } else {
 
   // build the path to the time file
   sprintf(mhdTimeFilenameWithPath, "%s%s", config.mhdDirectory, mhdTimeFilename);
@@ -220,7 +882,7 @@ char file_extension[5];
   while (fgets(line, max, rfile) != NULL) {
     nFileLines++;
   }
-  mhdTime = (Scalar_t *)malloc(sizeof(Scalar_t) * nFileLines);
+  mhdListedTime = (double *)calloc(nFileLines, sizeof(double));
 
   // reset the file pointer to the beginning of the file
   rewind(rfile);
@@ -230,9 +892,7 @@ char file_extension[5];
     if (fgets(line, max, rfile) != NULL) {
       result = strtok(line, delims);
       if (result != NULL) {
-        timeVar = (Scalar_t)atof(result) * config.mhdTimeConvert / DAY;
-        if (t == 0) {initialTime = timeVar;}
-        mhdTime[t] = config.mhdStartTime / DAY + (timeVar - initialTime);
+        mhdListedTime[t] = atof(result);
       }
       result = strtok(NULL, delims);
     }
@@ -241,6 +901,16 @@ char file_extension[5];
   // close the file
   fclose(rfile);
 
+  }
+
+  mhdTime = (Scalar_t *)malloc(sizeof(Scalar_t) * nFileLines);
+
+  for (int t=0; t<nFileLines; t++) {
+    timeVar = (Scalar_t)mhdListedTime[t] * config.mhdTimeConvert / DAY;
+    if (t == 0) {initialTime = timeVar;}
+    mhdTime[t] = config.mhdStartTime / DAY + (timeVar - initialTime);
+  }
+
   // store the number of files
   config.mhdNumFiles = nFileLines;
 
@@ -257,84 +927,180 @@ char file_extension[5];
     hdf5_input = 0;
     strncpy(file_extension,".hdf",strlen(".hdf")+1);
 
-    // The size of the index arrays doesn't change in time in this version.
-    mhdReadFieldIndex();
-
-    if(mpi_rank_shared==0){
-      N=(int)mhdBprDimMax[0]*(int)mhdBptDimMax[0]*(int)mhdBppDimMax[0];
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBp_0, &mhdBp_0_win);
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBp_1, &mhdBp_1_win);
-      N=(int)mhdBtrDimMax[0]*(int)mhdBttDimMax[0]*(int)mhdBtpDimMax[0];
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBt_0, &mhdBt_0_win);
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBt_1, &mhdBt_1_win);
-      N=(int)mhdBrrDimMax[0]*(int)mhdBrtDimMax[0]*(int)mhdBrpDimMax[0];
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBr_0, &mhdBr_0_win);
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBr_1, &mhdBr_1_win);
-      N=(int)mhdVprDimMax[0]*(int)mhdVptDimMax[0]*(int)mhdVppDimMax[0];
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVp_0, &mhdVp_0_win);
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVp_1, &mhdVp_1_win);
-      N=(int)mhdVtrDimMax[0]*(int)mhdVttDimMax[0]*(int)mhdVtpDimMax[0];
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVt_0, &mhdVt_0_win);
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVt_1, &mhdVt_1_win);
-      N=(int)mhdVrrDimMax[0]*(int)mhdVrtDimMax[0]*(int)mhdVrpDimMax[0];
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVr_0, &mhdVr_0_win);
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVr_1, &mhdVr_1_win);
-      N=(int)mhdDrDimMax[0]*(int)mhdDtDimMax[0]*(int)mhdDpDimMax[0];
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdD_0, &mhdD_0_win);
-      MPI_Win_allocate_shared(N*sizeof(float), sizeof(float), MPI_INFO_NULL, comm_shared, &mhdD_1, &mhdD_1_win);
-    }else{
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBp_0, &mhdBp_0_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBp_1, &mhdBp_1_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBt_0, &mhdBt_0_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBt_1, &mhdBt_1_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBr_0, &mhdBr_0_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdBr_1, &mhdBr_1_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVp_0, &mhdVp_0_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVp_1, &mhdVp_1_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVt_0, &mhdVt_0_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVt_1, &mhdVt_1_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVr_0, &mhdVr_0_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdVr_1, &mhdVr_1_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdD_0, &mhdD_0_win);
-      MPI_Win_allocate_shared(0, sizeof(float), MPI_INFO_NULL, comm_shared, &mhdD_1, &mhdD_1_win);
-      MPI_Win_shared_query(mhdBp_0_win, 0, &size, &disp_unit, &mhdBp_0);
-      MPI_Win_shared_query(mhdBt_0_win, 0, &size, &disp_unit, &mhdBt_0);
-      MPI_Win_shared_query(mhdBr_0_win, 0, &size, &disp_unit, &mhdBr_0);
-      MPI_Win_shared_query(mhdVp_0_win, 0, &size, &disp_unit, &mhdVp_0);
-      MPI_Win_shared_query(mhdVt_0_win, 0, &size, &disp_unit, &mhdVt_0);
-      MPI_Win_shared_query(mhdVr_0_win, 0, &size, &disp_unit, &mhdVr_0);
-      MPI_Win_shared_query(mhdD_0_win, 0, &size, &disp_unit, &mhdD_0);
-      MPI_Win_shared_query(mhdBp_1_win, 0, &size, &disp_unit, &mhdBp_1);
-      MPI_Win_shared_query(mhdBt_1_win, 0, &size, &disp_unit, &mhdBt_1);
-      MPI_Win_shared_query(mhdBr_1_win, 0, &size, &disp_unit, &mhdBr_1);
-      MPI_Win_shared_query(mhdVp_1_win, 0, &size, &disp_unit, &mhdVp_1);
-      MPI_Win_shared_query(mhdVt_1_win, 0, &size, &disp_unit, &mhdVt_1);
-      MPI_Win_shared_query(mhdVr_1_win, 0, &size, &disp_unit, &mhdVr_1);
-      MPI_Win_shared_query(mhdD_1_win, 0, &size, &disp_unit, &mhdD_1);
+    if (mhdCacheMapped > 0) {
+
+      // The meshes are in the cache.
+      for (field = 0; field < 7; field++) {
+        for (axis = 0; axis < 3; axis++) {
+          *mhdMeshSize[field][axis] = mhdCacheHeader()->dims[field][axis];
+          *mhdMesh[field][axis] = mhdCacheMesh(field, axis);
+        }
+      }
+
+      mhdSetRadialRange();
+
+    } else {
+
+      // The size of the index arrays doesn't change in time in this version.
+      mhdReadFieldIndex();
+
+      // Convert the sequence into the cache for later runs, and map it.
+      if (config.mhdCacheFile[0] != '\0') {
+
+        if (mpi_rank_world == 0)
+          mhdWriteCache();
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        mhdCacheMapped = mhdCacheMap(config.mhdCacheFile);
+        if (mhdCacheMapped == 0)
+          panic("mhdFetchFileList: the MHD cache was not written\n");
+
+      }
+
     }
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdBp_0_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdBt_0_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdBr_0_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdVp_0_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdVt_0_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdVr_0_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdD_0_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdBp_1_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdBt_1_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdBr_1_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdVp_1_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdVt_1_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdVr_1_win);
-    MPI_Win_lock_all(MPI_MODE_NOCHECK, mhdD_1_win);
 
-    mhdMallocFlag = 1;
+    // Lookup tables for the mesh searches of the interpolation.
+    mhdBuildMeshIndex();
+
+    // Start the radial window at the radius the nodes are placed from.
+    if ((config.mhdRadialWindow > 0) && (mhdCacheMapped == 0)) {
+
+      for (field = 0; field < 7; field++)
+        *mhdMeshSize[field][2] = 1;
+
+      if (config.mhdInitRadius > 0.0)
+        mhdSetRadialWindow(config.mhdInitRadius / RSAU, config.mhdRadialWindow, count);
+      else
+        mhdSetRadialWindow(config.mhdRadialMax, config.mhdRadialWindow, count);
+
+      for (field = 0; field < 7; field++)
+        *mhdMeshSize[field][2] = count[field];
+
+    }
 
   }
 
+  // Shared windows for the slices, unless they are read from the cache.
+  if ((mhdMallocFlag == 0) && (mhdCacheMapped == 0))
+    mhdAllocateSlots();
+
+  // The interleaved records, wherever the slices come from.
+  if ((mhdMallocFlag == 0) && (config.mhdInterleave > 0))
+    mhdAllocatePacked();
+
+  // curl(B/B^2) for the drift, on the rho mesh.
+  if ((mhdMallocFlag == 0) && (config.useDrift > 0) && (config.mhdCurlOnMesh > 0))
+    mhdAllocateCurl();
+
+  mhdMallocFlag = 1;
+
 
 }/*-------- END mhdFetchFileList()  --------------------------------*/
 /*------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdSwapSlots(int slotA, int slotB)                   /*--*/
+/*--                                                              --*/
+/*--  Swap the MHD slices held in two slots, with their windows.  --*/
+/*--  Every rank of comm_shared must swap the same slots.         --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  int field;
+  float *data;
+  MPI_Win win;
+
+  for (field = 0; field < 7; field++) {
+
+    data = *mhdSlot[slotA][field];
+    *mhdSlot[slotA][field] = *mhdSlot[slotB][field];
+    *mhdSlot[slotB][field] = data;
+
+    win = *mhdSlotWin[slotA][field];
+    *mhdSlotWin[slotA][field] = *mhdSlotWin[slotB][field];
+    *mhdSlotWin[slotB][field] = win;
+
+  }
+
+}/*-------- END mhdSwapSlots()  ------------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void *                                        /*--*/
+/*--*/     mhdPrefetchRead(void *arg)                           /*--*/
+/*--                                                              --*/
+/*--  Body of the I/O thread: read file mhdFileIndex_prefetch     --*/
+/*--  into slot 2.                                                --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  (void) arg;
+
+  mhdReadFiles(mhdFileIndex_prefetch,
+               &mhdBp_2, &mhdBt_2, &mhdBr_2,
+               &mhdVp_2, &mhdVt_2, &mhdVr_2,
+               &mhdD_2, 0, 1);
+
+  return NULL;
+
+}/*-------- END mhdPrefetchRead()  ---------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdStartPrefetch(Index_t fileIndex)                  /*--*/
+/*--                                                              --*/
+/*--  Start reading an MHD file into slot 2 in the background.     --*/
+/*--  Slot 2 must not be in use.                                  --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  mhdFileIndex_prefetch = fileIndex;
+
+  if (mpi_rank_shared == 0) {
+
+    if (pthread_create(&mhdPrefetchThread, NULL, mhdPrefetchRead, NULL) != 0)
+      panic("mhdStartPrefetch: unable to start the MHD I/O thread\n");
+
+    mhdPrefetchRunning = 1;
+
+  }
+
+}/*-------- END mhdStartPrefetch()  --------------------------------*/
+/*------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/*--*/     static void                                          /*--*/
+/*--*/     mhdFinishPrefetch(void)                              /*--*/
+/*--                                                              --*/
+/*--  Wait for a running prefetch to finish. Only the wait counts  --*/
+/*--  toward timer_mhd_io.                                        --*/
+/*------------------------------------------------------------------*/
+{/*-----------------------------------------------------------------*/
+
+  double timer_tmp = 0;
+
+  if (mhdPrefetchRunning == 0) return;
+
+  timer_tmp = MPI_Wtime();
+
+  pthread_join(mhdPrefetchThread, NULL);
+
+  mhdPrefetchRunning = 0;
+
+  if (mpi_rank_world == 0) printf("  --> IO MHD: Coronal sequence %03d prefetched.\n",mhdFileIndex_prefetch+1);
+
+  timer_mhd_io = timer_mhd_io + (MPI_Wtime() - timer_tmp);
+
+}/*-------- END mhdFinishPrefetch()  -------------------------------*/
+/*------------------------------------------------------------------*/
+
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 /*--*/     void                                                 /*--*/
@@ -344,37 +1110,22 @@ char file_extension[5];
 /*------------------------------------------------------------------*/
 {/*-----------------------------------------------------------------*/
 
+   if ((config.mhdCouple > 0) && (mhdPacked != NULL))
+      mhdFreePacked();
+
+   if ((config.mhdCouple > 0) && (mhdCurlAllocated > 0))
+      mhdFreeCurl();
+
+   if ((config.mhdCouple > 0) && (mhdCacheMapped > 0)) {
+      mhdCacheUnmap();
+      mhdCacheMapped = 0;
+      return;
+   }
+
    if (config.mhdCouple > 0) {
-      MPI_Win_unlock_all(mhdBp_0_win);
-      MPI_Win_unlock_all(mhdBt_0_win);
-      MPI_Win_unlock_all(mhdBr_0_win);
-      MPI_Win_unlock_all(mhdVp_0_win);
-      MPI_Win_unlock_all(mhdVt_0_win);
-      MPI_Win_unlock_all(mhdVr_0_win);
-      MPI_Win_unlock_all(mhdD_0_win);
-      MPI_Win_unlock_all(mhdBp_1_win);
-      MPI_Win_unlock_all(mhdBt_1_win);
-      MPI_Win_unlock_all(mhdBr_1_win);
-      MPI_Win_unlock_all(mhdVp_1_win);
-      MPI_Win_unlock_all(mhdVt_1_win);
-      MPI_Win_unlock_all(mhdVr_1_win);
-      MPI_Win_unlock_all(mhdD_1_win);
-
-      MPI_Win_free(&mhdBp_0_win);
-      MPI_Win_free(&mhdBt_0_win);
-      MPI_Win_free(&mhdBr_0_win);
-      MPI_Win_free(&mhdVp_0_win);
-      MPI_Win_free(&mhdVt_0_win);
-      MPI_Win_free(&mhdVr_0_win);
-      MPI_Win_free(&mhdD_0_win);
-      MPI_Win_free(&mhdBp_1_win);
-      MPI_Win_free(&mhdBt_1_win);
-      MPI_Win_free(&mhdBr_1_win);
-      MPI_Win_free(&mhdVp_1_win);
-      MPI_Win_free(&mhdVt_1_win);
-      MPI_Win_free(&mhdVr_1_win);
-      MPI_Win_free(&mhdD_1_win);
-  }
+      mhdFinishPrefetch();
+      mhdFreeSlots();
+   }
 
 }/*-------- END cleanupMPIWindows()  -------------------------------*/
 /*------------------------------------------------------------------*/
@@ -391,10 +1142,17 @@ char file_extension[5];
 /*------------------------------------------------------------------*/
 {
 
-  int i,N;
+  int i, field;
   int need_sync_0,need_sync_1;
+  Index_t loaded, nextIndex, gridPlaced;
   Scalar_t time_interp;
 
+  gridPlaced = mhdGridPlaced;
+  mhdGridPlaced = 1;
+
+  // s_cor and the slices change from here on.
+  mhdInvalidateSamples();
+
 //
 // Set the time we are interpolating to (the current time plus the time step).
 //
@@ -447,35 +1205,60 @@ char file_extension[5];
   }
 
 //
-// Read or copy MHD data as needed.
+// With the cache the slices are read where they are mapped: point the
+// slots at them, and ask for the pages of the next one ahead of time.
 //
 
+  if (mhdCacheMapped > 0) {
+
+    if ((mhdFileIndex0 != mhdFileIndex_loaded0) || (mhdFileIndex1 != mhdFileIndex_loaded1)) {
+
+      for (field = 0; field < 7; field++) {
+        *mhdSlot[0][field] = mhdCacheSlice(mhdFileIndex0, field);
+        *mhdSlot[1][field] = mhdCacheSlice(mhdFileIndex1, field);
+      }
+
+      mhdFileIndex_loaded0 = mhdFileIndex0;
+      mhdFileIndex_loaded1 = mhdFileIndex1;
+
+      if (config.mhdPrefetch > 0)
+        mhdCacheWillNeed(mhdFileIndex1 + 1);
+
+    }
+
+    mhdUpdatePacked();
+    mhdUpdateCurl();
+
+    return;
+
+  }
+
+  if ((config.mhdRadialWindow > 0) && (gridPlaced > 0))
+    mhdUpdateRadialWindow();
+
+//
+// Read or move MHD data as needed.
+//
+
+  // A slice that is still being prefetched may be needed now, and no
+  // other read may run next to the prefetch.
+  if ((mhdFileIndex0 != mhdFileIndex_loaded0) || (mhdFileIndex1 != mhdFileIndex_loaded1))
+    mhdFinishPrefetch();
+
   if (mhdFileIndex0 != mhdFileIndex_loaded0){ // if state0 needs to be updated
     MPI_Barrier(comm_shared);
+    loaded = mhdFileIndex_loaded0;
     if (mhdFileIndex0 == mhdFileIndex_loaded1){ // if state0 used is already stored previously in state1
-      if(mpi_rank_shared==0) {
-        N=(int)mhdBprDimMax[0]*(int)mhdBptDimMax[0]*(int)mhdBppDimMax[0];
-        memcpy(&mhdBp_0[0],&mhdBp_1[0],N*sizeof(float));
-        N=(int)mhdBtrDimMax[0]*(int)mhdBttDimMax[0]*(int)mhdBtpDimMax[0];
-        memcpy(&mhdBt_0[0],&mhdBt_1[0],N*sizeof(float));
-        N=(int)mhdBrrDimMax[0]*(int)mhdBrtDimMax[0]*(int)mhdBrpDimMax[0];
-        memcpy(&mhdBr_0[0],&mhdBr_1[0],N*sizeof(float));
-        N=(int)mhdVprDimMax[0]*(int)mhdVptDimMax[0]*(int)mhdVppDimMax[0];
-        memcpy(&mhdVp_0[0],&mhdVp_1[0],N*sizeof(float));
-        N=(int)mhdVtrDimMax[0]*(int)mhdVttDimMax[0]*(int)mhdVtpDimMax[0];
-        memcpy(&mhdVt_0[0],&mhdVt_1[0],N*sizeof(float));
-        N=(int)mhdVrrDimMax[0]*(int)mhdVrtDimMax[0]*(int)mhdVrpDimMax[0];
-        memcpy(&mhdVr_0[0],&mhdVr_1[0],N*sizeof(float));
-        N=(int)mhdDrDimMax[0]*(int)mhdDtDimMax[0]*(int)mhdDpDimMax[0];
-        memcpy(&mhdD_0[0],&mhdD_1[0],N*sizeof(float));
-      }
+      mhdSwapSlots(0, 1);
+      mhdFileIndex_loaded1 = loaded;
+    } else if (mhdFileIndex0 == mhdFileIndex_prefetch){
+      mhdSwapSlots(0, 2);
+      mhdFileIndex_prefetch = loaded;
     } else {
-      if(mpi_rank_shared==0) {
-        mhdReadData(mhdFileIndex0,
-                &mhdBp_0, &mhdBt_0, &mhdBr_0,
-                &mhdVp_0, &mhdVt_0, &mhdVr_0,
-                &mhdD_0);
-      }
+      mhdReadData(mhdFileIndex0,
+              &mhdBp_0, &mhdBt_0, &mhdBr_0,
+              &mhdVp_0, &mhdVt_0, &mhdVr_0,
+              &mhdD_0);
     }
     mhdFileIndex_loaded0 = mhdFileIndex0;
     need_sync_0 = 1;
@@ -485,7 +1268,10 @@ char file_extension[5];
 
   if (mhdFileIndex1 != mhdFileIndex_loaded1){
     MPI_Barrier(comm_shared);
-    if(mpi_rank_shared==0) {
+    if (mhdFileIndex1 == mhdFileIndex_prefetch){
+      mhdSwapSlots(1, 2);
+      mhdFileIndex_prefetch = mhdFileIndex_loaded1;
+    } else {
       mhdReadData(mhdFileIndex1,
                 &mhdBp_1, &mhdBt_1, &mhdBr_1,
                 &mhdVp_1, &mhdVt_1, &mhdVr_1,
@@ -521,6 +1307,22 @@ char file_extension[5];
 
   if (need_sync_0 + need_sync_1 > 0) MPI_Barrier(comm_shared);
 
+  mhdUpdatePacked();
+  mhdUpdateCurl();
+
+//
+// Read the file after the current interval in the background while the
+// current slices are in use. Slot 2 is free here: every rank is past
+// the barriers above, and a prefetch still running is for this file.
+//
+
+  nextIndex = mhdFileIndex1 + 1;
+
+  if ((config.mhdPrefetch > 0) && (nextIndex < config.mhdNumFiles) &&
+      (nextIndex != mhdFileIndex_prefetch) &&
+      (nextIndex != mhdFileIndex_loaded0) && (nextIndex != mhdFileIndex_loaded1))
+    mhdStartPrefetch(nextIndex);
+
 }
 /*----------------- END mhdGetInterpData(dt)  ------------------------*/
 /*--------------------------------------------------------------------*/
@@ -535,15 +1337,49 @@ char file_extension[5];
 /*--*/            float *mhdD[])                                  /*--*/
 /*--*/                                                            /*--*/
 /*--                                                                --*/
-/*--This function reads the MHD data from a HDF file.              --*/
+/*--This function reads the MHD data from a HDF file. All ranks of  --*/
+/*--comm_shared call it and share the reading (see mhdReadFiles).   --*/
 /*--------------------------------------------------------------------*/
 {/*-------------------------------------------------------------------*/
-  char fileNames[7][MAX_STRING_SIZE];
 
   double timer_tmp = 0;
 
   timer_tmp = MPI_Wtime();
 
+  mhdReadFiles(fileIndex, mhdBp, mhdBt, mhdBr, mhdVp, mhdVt, mhdVr, mhdD,
+               mpi_rank_shared, mpi_np_shared);
+
+  if (mpi_rank_world == 0) printf("  --> IO MHD: Coronal sequence %03d read.\n",fileIndex+1);
+
+  timer_mhd_io = timer_mhd_io + (MPI_Wtime() - timer_tmp);
+
+}/*-------- END mhdReadData()  -----------------------*/
+/*------------------------------------------------------------------*/
+
+
+/*--------------------------------------------------------------------*/
+/*--------------------------------------------------------------------*/
+/*--------------------------------------------------------------------*/
+/*--*/     static void                                            /*--*/
+/*--*/     mhdReadFiles(Index_t fileIndex,                        /*--*/
+/*--*/            float *mhdBp[], float *mhdBt[], float *mhdBr[], /*--*/
+/*--*/            float *mhdVp[], float *mhdVt[], float *mhdVr[], /*--*/
+/*--*/            float *mhdD[],                                  /*--*/
+/*--*/            int reader, int numReaders)                     /*--*/
+/*--*/                                                            /*--*/
+/*--                                                                --*/
+/*--Read this reader's share of the seven MHD fields of one time    --*/
+/*--slice. The fields, and with more than seven readers slabs of    --*/
+/*--them, are dealt out to the numReaders readers in turn, and each --*/
+/*--reads straight into the shared window, out to the radial window --*/
+/*--of the field. Makes no MPI calls, so that the prefetch thread   --*/
+/*--can use it.                                                     --*/
+/*--------------------------------------------------------------------*/
+{/*-------------------------------------------------------------------*/
+  char fileNames[7][MAX_STRING_SIZE];
+  float **fields[7];
+  int numSlabs, part, field;
+
   if (config.mhdDigits == 3) {
 
     sprintf(fileNames[0], "%sbp%03d%s", config.mhdDirectory, fileIndex + 1, file_extension);
@@ -566,32 +1402,30 @@ char file_extension[5];
 
   }
 
-  // reading in Bp
-  mhdReadDatafromFile(fileNames[0], mhdBp);
-
-  // reading in Bt
-  mhdReadDatafromFile(fileNames[1], mhdBt);
+  fields[0] = mhdBp;
+  fields[1] = mhdBt;
+  fields[2] = mhdBr;
+  fields[3] = mhdVp;
+  fields[4] = mhdVt;
+  fields[5] = mhdVr;
+  fields[6] = mhdD;
 
-  // reading in Br
-  mhdReadDatafromFile(fileNames[2], mhdBr);
+  // Enough slabs per field that every reader gets a part.
+  numSlabs = (numReaders + 6) / 7;
 
-  // reading in Vp
-  mhdReadDatafromFile(fileNames[3], mhdVp);
+  for (part = reader; part < 7 * numSlabs; part += numReaders) {
 
-  // reading in Vt
-  mhdReadDatafromFile(fileNames[4], mhdVt);
+    field = part / numSlabs;
 
-  // reading in Vr
-  mhdReadDatafromFile(fileNames[5], mhdVr);
+    if ((numSlabs == 1) && (*mhdMeshSize[field][2] == mhdRadialFull[field]))
+      mhdReadDatafromFile(fileNames[field], fields[field]);
+    else
+      mhdReadSlabfromFile(fileNames[field], *fields[field],
+                          part % numSlabs, numSlabs, *mhdMeshSize[field][2]);
 
-  // reading in D
-  mhdReadDatafromFile(fileNames[6], mhdD);
-
-  if (mpi_rank == 0) printf("  --> IO MHD: Coronal sequence %03d read.\n",fileIndex+1);
-
-  timer_mhd_io = timer_mhd_io + (MPI_Wtime() - timer_tmp);
+  }
 
-}/*-------- END mhdReadData()  -----------------------*/
+}/*-------- END mhdReadFiles()  ----------------------*/
 /*------------------------------------------------------------------*/
 
 
@@ -606,8 +1440,6 @@ char file_extension[5];
 
   char fileNames[7][MAX_STRING_SIZE];
 
-  Scalar_t rMin, rMax, rTemp;
-
   double timer_tmp=0;
 
   timer_tmp = MPI_Wtime();
@@ -651,10 +1483,6 @@ char file_extension[5];
     mhdBprDim = (float *)malloc(sizeof(float) * (int)(mhdBprDimMax[0]));
     mhdReadMesh(fileNames[0], "dim1", 2, &mhdBprDim);
 
-    // grab the min and max for the r
-    rMin = mhdBprDim[0];
-    rMax = mhdBprDim[mhdBprDimMax[0] - 1];
-
     // mhdBtpDim
     mhdReadMeshDimensions(fileNames[1], "dim3", 0, &mhdBtpDimMax[0]);
     mhdBtpDim = (float *)malloc(sizeof(float) * (int)(mhdBtpDimMax[0]));
@@ -670,15 +1498,6 @@ char file_extension[5];
     mhdBtrDim = (float *)malloc(sizeof(float) * (int)(mhdBtrDimMax[0]));
     mhdReadMesh(fileNames[1], "dim1", 2, &mhdBtrDim);
 
-    // grab the min and max for the r
-    rTemp = mhdBtrDim[0];
-    if (rTemp > rMin)
-      rMin = rTemp;
-
-    rTemp = mhdBtrDim[mhdBtrDimMax[0] - 1];
-    if (rTemp < rMax)
-      rMax = rTemp;
-
     // mhdBrpDim
     mhdReadMeshDimensions(fileNames[2], "dim3", 0, &mhdBrpDimMax[0]);
     mhdBrpDim = (float *)malloc(sizeof(float) * (int)(mhdBrpDimMax[0]));
@@ -694,15 +1513,6 @@ char file_extension[5];
     mhdBrrDim = (float *)malloc(sizeof(float) * (int)(mhdBrrDimMax[0]));
     mhdReadMesh(fileNames[2], "dim1", 2, &mhdBrrDim);
 
-    // grab the min and max for the r
-    rTemp = mhdBrrDim[0];
-    if (rTemp > rMin)
-      rMin = rTemp;
-
-    rTemp = mhdBrrDim[mhdBrrDimMax[0] - 1];
-    if (rTemp < rMax)
-      rMax = rTemp;
-
     // mhdVppDim
     mhdReadMeshDimensions(fileNames[3], "dim3", 0, &mhdVppDimMax[0]);
     mhdVppDim = (float *)malloc(sizeof(float) * (int)(mhdVppDimMax[0]));
@@ -718,15 +1528,6 @@ char file_extension[5];
     mhdVprDim = (float *)malloc(sizeof(float) * (int)(mhdVprDimMax[0]));
     mhdReadMesh(fileNames[3], "dim1", 2, &mhdVprDim);
 
-    // grab the min and max for the r
-    rTemp = mhdVprDim[0];
-    if (rTemp > rMin)
-      rMin = rTemp;
-
-    rTemp = mhdVprDim[mhdVprDimMax[0] - 1];
-    if (rTemp < rMax)
-      rMax = rTemp;
-
     // mhdVtpDim
     mhdReadMeshDimensions(fileNames[4], "dim3", 0, &mhdVtpDimMax[0]);
     mhdVtpDim = (float *)malloc(sizeof(float) * (int)(mhdVtpDimMax[0]));
@@ -742,15 +1543,6 @@ char file_extension[5];
     mhdVtrDim = (float *)malloc(sizeof(float) * (int)(mhdVtrDimMax[0]));
     mhdReadMesh(fileNames[4], "dim1", 2, &mhdVtrDim);
 
-    // grab the min and max for the r
-    rTemp = mhdVtrDim[0];
-    if (rTemp > rMin)
-      rMin = rTemp;
-
-    rTemp = mhdVtrDim[mhdVtrDimMax[0] - 1];
-    if (rTemp < rMax)
-      rMax = rTemp;
-
     // mhdVrpDim
     mhdReadMeshDimensions(fileNames[5], "dim3", 0, &mhdVrpDimMax[0]);
     mhdVrpDim = (float *)malloc(sizeof(float) * (int)(mhdVrpDimMax[0]));
@@ -766,15 +1558,6 @@ char file_extension[5];
     mhdVrrDim = (float *)malloc(sizeof(float) * (int)(mhdVrrDimMax[0]));
     mhdReadMesh(fileNames[5], "dim1", 2, &mhdVrrDim);
 
-    // grab the min and max for the r
-    rTemp = mhdVrrDim[0];
-    if (rTemp > rMin)
-      rMin = rTemp;
-
-    rTemp = mhdVrrDim[mhdVrrDimMax[0] - 1];
-    if (rTemp < rMax)
-      rMax = rTemp;
-
     // mhdDpDim
     mhdReadMeshDimensions(fileNames[6], "dim3", 0, &mhdDpDimMax[0]);
     mhdDpDim = (float *)malloc(sizeof(float) * (int)(mhdDpDimMax[0]));
@@ -790,19 +1573,7 @@ char file_extension[5];
     mhdDrDim = (float *)malloc(sizeof(float) * (int)(mhdDrDimMax[0]));
     mhdReadMesh(fileNames[6], "dim1", 2, &mhdDrDim);
 
-    // grab the min and max for the r
-    rTemp = mhdDrDim[0];
-    if (rTemp > rMin)
-      rMin = rTemp;
-
-    rTemp = mhdDrDim[mhdDrDimMax[0] - 1];
-    if (rTemp < rMax)
-      rMax = rTemp;
-
-  // set rScale, and mhdRadialMin/Max
-  config.rScale = rMin * RSAU;
-  config.mhdRadialMin = rMin;
-  config.mhdRadialMax = rMax;
+  mhdSetRadialRange();
 
   timer_mhd_io = timer_mhd_io + (MPI_Wtime() - timer_tmp);
 
@@ -90,6 +90,11 @@ extern float * mhdDpDim;
 extern float * mhdDtDim;
 extern float * mhdDrDim;
 
+// The mesh of each field (bp, bt, br, vp, vt, vr, rho) along phi,
+// theta and r, and its length.
+extern float **mhdMesh[7][3];
+extern int32_t *mhdMeshSize[7][3];
+
 extern float * mhdBp_0;
 extern float * mhdBt_0;
 extern float * mhdBr_0;
@@ -122,6 +127,40 @@ extern MPI_Win mhdVp_1_win;
 extern MPI_Win mhdVt_1_win;
 extern MPI_Win mhdVr_1_win;
 extern MPI_Win mhdD_1_win;
+
+/*-- The slice the next MHD file is prefetched into (mhdPrefetch). --*/
+extern float * mhdBp_2;
+extern float * mhdBt_2;
+extern float * mhdBr_2;
+extern float * mhdVp_2;
+extern float * mhdVt_2;
+extern float * mhdVr_2;
+extern float * mhdD_2;
+
+extern MPI_Win mhdBp_2_win;
+extern MPI_Win mhdBt_2_win;
+extern MPI_Win mhdBr_2_win;
+extern MPI_Win mhdVp_2_win;
+extern MPI_Win mhdVt_2_win;
+extern MPI_Win mhdVr_2_win;
+extern MPI_Win mhdD_2_win;
+
+/*-- With mhdInterleave, the seven fields (bp, bt, br, vp, vt, vr, rho) --*/
+/*-- of slices 0 and 1 resampled onto the rho mesh, one record of a    --*/
+/*-- cache line per mesh point, laid out like the rho slices.          --*/
+typedef struct {
+  float v[2][7];
+  float pad[2];
+} MhdRecord_t;
+
+extern MhdRecord_t * mhdPacked;
+extern MPI_Win mhdPacked_win;
+
+/*-- With mhdCurlOnMesh, curl(B/B^2) (r, theta and phi components) of  --*/
+/*-- slices 0 and 1 on the rho mesh, laid out like the rho slices.     --*/
+/*-- NULL until the first slices are loaded.                           --*/
+extern float * mhdCurl[2][3];
+
 extern char file_extension[5];
 
 void ERR(int);
@@ -71,6 +71,7 @@
 #include "global.h"
 #include "configuration.h"
 #include "searchTypes.h"
+#include "unifiedOutput.h"
 #include "simCore.h"
 #include "geometry.h"
 #include "observerOutput.h"
@@ -82,25 +83,18 @@
 /*--*/  void                                                    /*--*/
 /*--*/  getPointObsProjections( void )                          /*--*/
 /*--*/                                                          /*--*/
-/*--    get all projections on the point observer spheres         --*/
+/*--    get the projections of this face group's streams on the   --*/
+/*--    point observer spheres                                    --*/
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 {
 
-  Index_t face, col, row;
+  Index_t stream;
 
-  for (face = 0; face < NUM_FACES; face++)
-  {
-    for (row = 0; row < FACE_ROWS; row++)
-    {
-      for (col = 0; col < FACE_COLS; col++)
-      {
-
-        pointObsProjectedStreamData( face, row, col );
-
-      }
-    }
-  }
+  for (stream = FIRST_GROUP_STREAM; stream < FIRST_GROUP_STREAM + GROUP_NUM_STREAMS; stream++)
+    pointObsProjectedStreamData( computeLines[stream][0],
+                                 computeLines[stream][1],
+                                 computeLines[stream][2] );
 
 }
 /*------------------------------------------------------------------*/
@@ -136,24 +130,24 @@
   timer_tmp = MPI_Wtime();
 
   MPI_Gatherv(&grid[idx_frcs(face,row,col,INNER_ACTIVE_SHELL)],
-                  ACTIVE_STREAM_SIZE,
-                  Node_T,
+                  1,
+                  StreamNodes_T,
                   streamGrid,
                   recvCountGrid,
                   displGrid,
-                  Node_T,
+                  StreamNode_T,
                   0,
-                  MPI_COMM_WORLD);
+                  comm_stream);
 
   MPI_Gatherv(&eParts[idx_frcsspem(face,row,col,INNER_ACTIVE_SHELL,0,0,0)],
-                  ACTIVE_STREAM_SIZE*NUM_SPECIES*NUM_ESTEPS*NUM_MUSTEPS,
-                  Scalar_T,
+                  1,
+                  StreamEparts_T,
                   ePartsStream,
                   recvCountEparts,
                   displEparts,
                   Scalar_T,
                   0,
-                  MPI_COMM_WORLD );
+                  comm_stream );
 
   timer_MPIgatherscatter = timer_MPIgatherscatter + (MPI_Wtime() - timer_tmp);
 
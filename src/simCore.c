@@ -35,6 +35,7 @@
 #include "unifiedOutput.h"
 #include "searchTypes.h"
 #include "cubeShellStruct.h"
+#include "cubeShellInit.h"
 #include "observerOutput.h"
 #include "error.h"
 #include "timers.h"
@@ -52,6 +53,14 @@ Index_t weInitializedEPs;
 Index_t mhdGridStatus;
 Index_t sync_hel=0;
 Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
+
+// State of the stream gather/compute/scatter pipeline
+// (see start_stream_from_shells()).
+static MPI_Request *gatherRequests     = NULL;
+static MPI_Request *scatterRequests    = NULL;
+static Index_t      scatterPending     = 0;
+static Node_t      *singleStreamGrid   = NULL;
+static Scalar_t    *singleEPartsStream = NULL;
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 /*--*/          void                                                /*---*/
@@ -166,148 +175,1181 @@ Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
 
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
-/*--*/          void                                                 /*--*/
-/*--*/          update_stream_from_shells ( Index_t iterIndex )      /*--*/
+/*--*/          static void                                          /*--*/
+/*--*/          igather_stream ( Index_t iterIndex,                  /*--*/
+/*--*/                           Scalar_t *ePartsBuf,                /*--*/
+/*--*/                           Node_t *gridBuf,                    /*--*/
+/*--*/                           MPI_Request *requests )             /*--*/
 /*--                                                                   --*/
-/*-- Gather single stream from the cooresponding shells                --*/
-/*-- across all MPI ranks.                                             --*/
+/*-- Start gathering stream iterIndex of every rank from the           --*/
+/*-- corresponding shells into ePartsBuf/gridBuf. Fills 2*N_PROCS      --*/
+/*-- requests (MPI_REQUEST_NULL for ranks without a stream). Only the  --*/
+/*-- StreamNode_T fields of the nodes are moved.                       --*/
 /*--                                                                   --*/
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 {
 
-  Index_t proc, workIndex, num_calls;
-
-  double timer_tmp = 0;
-
-  MPI_Request request_grid[N_PROCS];
-  MPI_Request request_eparts[N_PROCS];
-
-  timer_tmp = MPI_Wtime();
-
-  num_calls = 0;
+  Index_t proc, workIndex;
 
   for (proc = 0; proc < N_PROCS; proc++)
   {
 
-    workIndex = proc + N_PROCS * iterIndex;
+    requests[proc]           = MPI_REQUEST_NULL;
+    requests[N_PROCS + proc] = MPI_REQUEST_NULL;
 
-    if (workIndex < NUM_STREAMS)
+    if (iterIndex < RANK_NUM_STREAMS(proc))
     {
-      num_calls++;
 
-      MPI_Igatherv(&eParts[idx_frcsspem(computeLines[workIndex][0],
-                                        computeLines[workIndex][1],
-                                        computeLines[workIndex][2],
+      workIndex = WORK_INDEX(proc, iterIndex);
+
+      MPI_Igatherv(&eParts[idx_frcsspem(computeLines[GROUP_STREAM(workIndex)][0],
+                                        computeLines[GROUP_STREAM(workIndex)][1],
+                                        computeLines[GROUP_STREAM(workIndex)][2],
                                         INNER_ACTIVE_SHELL,0,0,0)],
-                   ACTIVE_STREAM_SIZE*NUM_SPECIES*NUM_ESTEPS*NUM_MUSTEPS,
-                   Scalar_T,
-                   ePartsStream,
+                   1,
+                   StreamEparts_T,
+                   ePartsBuf,
                    recvCountEparts,
                    displEparts,
                    Scalar_T,
                    proc,
-                   MPI_COMM_WORLD,
-                   &request_eparts[proc]);
+                   comm_stream,
+                   &requests[proc]);
 
-      MPI_Igatherv(&grid[idx_frcs(computeLines[workIndex][0],
-                                  computeLines[workIndex][1],
-                                  computeLines[workIndex][2],
+      MPI_Igatherv(&grid[idx_frcs(computeLines[GROUP_STREAM(workIndex)][0],
+                                  computeLines[GROUP_STREAM(workIndex)][1],
+                                  computeLines[GROUP_STREAM(workIndex)][2],
                                   INNER_ACTIVE_SHELL)],
-                   ACTIVE_STREAM_SIZE,
-                   Node_T,
-                   streamGrid,
+                   1,
+                   StreamNodes_T,
+                   gridBuf,
                    recvCountGrid,
                    displGrid,
-                   Node_T,
+                   StreamNode_T,
                    proc,
-                   MPI_COMM_WORLD,
-                   &request_grid[proc]);
+                   comm_stream,
+                   &requests[N_PROCS + proc]);
+
+    }
+
+  }
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static void                                          /*--*/
+/*--*/          iscatter_stream ( Index_t iterIndex,                 /*--*/
+/*--*/                            Scalar_t *ePartsBuf,               /*--*/
+/*--*/                            Node_t *gridBuf,                   /*--*/
+/*--*/                            MPI_Request *requests )            /*--*/
+/*--                                                                   --*/
+/*-- Start scattering stream iterIndex of every rank from              --*/
+/*-- ePartsBuf/gridBuf back to the corresponding shells; the inverse   --*/
+/*-- of igather_stream(). Of the nodes, only the StreamSeam_T fields   --*/
+/*-- set by updateStreamValues() go back.                              --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t proc, workIndex;
+
+  for (proc = 0; proc < N_PROCS; proc++)
+  {
+
+    requests[proc]           = MPI_REQUEST_NULL;
+    requests[N_PROCS + proc] = MPI_REQUEST_NULL;
+
+    if (iterIndex < RANK_NUM_STREAMS(proc))
+    {
+
+      workIndex = WORK_INDEX(proc, iterIndex);
+
+      MPI_Iscatterv(ePartsBuf,
+                    recvCountEparts,
+                    displEparts,
+                    Scalar_T,
+                    &eParts[idx_frcsspem(computeLines[GROUP_STREAM(workIndex)][0],
+                                         computeLines[GROUP_STREAM(workIndex)][1],
+                                         computeLines[GROUP_STREAM(workIndex)][2],
+                                         INNER_ACTIVE_SHELL,0,0,0)],
+                    1,
+                    StreamEparts_T,
+                    proc,
+                    comm_stream,
+                    &requests[proc]);
+
+      MPI_Iscatterv(gridBuf,
+                    recvCountGrid,
+                    displGrid,
+                    StreamSeam_T,
+                    &grid[idx_frcs(computeLines[GROUP_STREAM(workIndex)][0],
+                                   computeLines[GROUP_STREAM(workIndex)][1],
+                                   computeLines[GROUP_STREAM(workIndex)][2],
+                                   INNER_ACTIVE_SHELL)],
+                    1,
+                    StreamSeams_T,
+                    proc,
+                    comm_stream,
+                    &requests[N_PROCS + proc]);
 
     }
 
   }
 
-  MPI_Waitall(num_calls, request_eparts, MPI_STATUSES_IGNORE);
-  MPI_Waitall(num_calls, request_grid,   MPI_STATUSES_IGNORE);
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          update_stream_from_shells ( Index_t iterIndex )      /*--*/
+/*--                                                                   --*/
+/*-- Gather single stream from the cooresponding shells                --*/
+/*-- across all MPI ranks.                                             --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  double timer_tmp = 0;
+
+  MPI_Request requests[2*N_PROCS];
+
+  timer_tmp = MPI_Wtime();
+
+  igather_stream(iterIndex, ePartsStream, streamGrid, requests);
+
+  MPI_Waitall(2*N_PROCS, requests, MPI_STATUSES_IGNORE);
+
+  timer_MPIgatherscatter = timer_MPIgatherscatter
+                           + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          update_shells_from_stream ( Index_t iterIndex )      /*--*/
+/*--                                                                   --*/
+/*-- Scatter single stream to the cooresponding shells                 --*/
+/*-- across all MPI ranks.                                             --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  double timer_tmp = 0;
+
+  MPI_Request requests[2*N_PROCS];
+
+  timer_tmp = MPI_Wtime();
+
+  iscatter_stream(iterIndex, ePartsStream, streamGrid, requests);
+
+  MPI_Waitall(2*N_PROCS, requests, MPI_STATUSES_IGNORE);
+
+  timer_MPIgatherscatter = timer_MPIgatherscatter
+                           + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static void                                          /*--*/
+/*--*/          point_stream ( Node_t *gridBuf, Scalar_t *ePartsBuf )/*--*/
+/*--                                                                   --*/
+/*-- Point streamGrid/ePartsStream at another stream buffer; NULL      --*/
+/*-- points them back at the single-stream buffers of                  --*/
+/*-- allocateGlobalVariables().                                        --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  if (singleStreamGrid == NULL)
+  {
+    singleStreamGrid   = streamGrid;
+    singleEPartsStream = ePartsStream;
+  }
+
+  if (gridBuf != NULL)
+  {
+    streamGrid   = gridBuf;
+    ePartsStream = ePartsBuf;
+  }
+  else
+  {
+    streamGrid   = singleStreamGrid;
+    ePartsStream = singleEPartsStream;
+  }
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          start_stream_from_shells ( Index_t iterIndex )       /*--*/
+/*--                                                                   --*/
+/*-- Start the gather of stream iterIndex into its pipeline slot       --*/
+/*-- (see STREAM_PIPE_DEPTH). Returns right away; the stream is ready  --*/
+/*-- once finish_stream_from_shells( iterIndex ) returns. At most one  --*/
+/*-- gather may be in flight.                                          --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  double timer_tmp = 0;
+
+  timer_tmp = MPI_Wtime();
+
+  if (gatherRequests == NULL)
+  {
+    gatherRequests  = (MPI_Request *) malloc(sizeof(MPI_Request)*2*N_PROCS);
+    scatterRequests = (MPI_Request *) malloc(sizeof(MPI_Request)*2*N_PROCS);
+    scatterPending  = 0;
+  }
+
+  igather_stream(iterIndex,
+                 &ePartsStreamPipe[STREAM_PIPE_SLOT(iterIndex)
+                                   * TOTAL_ACTIVE_STREAM_SIZE * SPEM],
+                 &streamGridPipe[STREAM_PIPE_SLOT(iterIndex)
+                                 * TOTAL_ACTIVE_STREAM_SIZE],
+                 gatherRequests);
+
+  timer_MPIgatherscatter = timer_MPIgatherscatter
+                           + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          finish_stream_from_shells ( Index_t iterIndex )      /*--*/
+/*--                                                                   --*/
+/*-- Wait for the gather of stream iterIndex and point                 --*/
+/*-- streamGrid/ePartsStream at its pipeline slot.                     --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  double timer_tmp = 0;
+
+  timer_tmp = MPI_Wtime();
+
+  MPI_Waitall(2*N_PROCS, gatherRequests, MPI_STATUSES_IGNORE);
+
+  point_stream(&streamGridPipe[STREAM_PIPE_SLOT(iterIndex)
+                               * TOTAL_ACTIVE_STREAM_SIZE],
+               &ePartsStreamPipe[STREAM_PIPE_SLOT(iterIndex)
+                                 * TOTAL_ACTIVE_STREAM_SIZE * SPEM]);
+
+  timer_MPIgatherscatter = timer_MPIgatherscatter
+                           + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          start_shells_from_stream ( Index_t iterIndex )       /*--*/
+/*--                                                                   --*/
+/*-- Start the scatter of stream iterIndex from its pipeline slot,     --*/
+/*-- after waiting for the scatter started before it (if any).         --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  double timer_tmp = 0;
+
+  timer_tmp = MPI_Wtime();
+
+  if (scatterPending)
+    MPI_Waitall(2*N_PROCS, scatterRequests, MPI_STATUSES_IGNORE);
+
+  iscatter_stream(iterIndex,
+                  &ePartsStreamPipe[STREAM_PIPE_SLOT(iterIndex)
+                                    * TOTAL_ACTIVE_STREAM_SIZE * SPEM],
+                  &streamGridPipe[STREAM_PIPE_SLOT(iterIndex)
+                                  * TOTAL_ACTIVE_STREAM_SIZE],
+                  scatterRequests);
+
+  scatterPending = 1;
+
+  timer_MPIgatherscatter = timer_MPIgatherscatter
+                           + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          finish_shells_from_stream ( void )                   /*--*/
+/*--                                                                   --*/
+/*-- Wait for the last scatter of the pipeline and point               --*/
+/*-- streamGrid/ePartsStream back at the single-stream buffers.        --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  double timer_tmp = 0;
+
+  timer_tmp = MPI_Wtime();
+
+  if (scatterPending)
+    MPI_Waitall(2*N_PROCS, scatterRequests, MPI_STATUSES_IGNORE);
+
+  scatterPending = 0;
+
+  point_stream(NULL, NULL);
+
+  timer_MPIgatherscatter = timer_MPIgatherscatter
+                           + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static void                                          /*--*/
+/*--*/          streamTransposeTypes ( MPI_Datatype ringNode,        /*--*/
+/*--*/                                 MPI_Datatype node,            /*--*/
+/*--*/                                 MPI_Datatype *shellNodes,     /*--*/
+/*--*/                                 MPI_Datatype *shellEparts,    /*--*/
+/*--*/                                 MPI_Datatype *streamNodes,    /*--*/
+/*--*/                                 MPI_Datatype *streamEparts,   /*--*/
+/*--*/                                 int *shellCounts,             /*--*/
+/*--*/                                 int *streamCounts,            /*--*/
+/*--*/                                 int *nodeDispls,              /*--*/
+/*--*/                                 int *epartsDispls )           /*--*/
+/*--                                                                   --*/
+/*-- Build the per-rank datatypes of the stream transpose.             --*/
+/*-- shellNodes[p]/shellEparts[p] pick, out of grid/eParts, the local  --*/
+/*-- part of every stream rank p works on. streamNodes[p] and          --*/
+/*-- streamEparts[p] place the part held by rank p of every stream     --*/
+/*-- this rank works on into streamGridAll/ePartsStreamAll, at the     --*/
+/*-- byte offsets nodeDispls[p]/epartsDispls[p]. A count of 0 marks    --*/
+/*-- a rank with nothing to exchange; its types are not to be freed.   --*/
+/*-- The node types are built from ringNode/node, i.e.                 --*/
+/*-- StreamNodes_T/StreamNode_T going into the streams and             --*/
+/*-- StreamSeams_T/StreamSeam_T coming back.                           --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t proc, iterIndex, workIndex, numStreams;
+
+  MPI_Aint nodeOffsets[MAX_RANK_NUM_STREAMS + 1];
+  MPI_Aint epartsOffsets[MAX_RANK_NUM_STREAMS + 1];
+
+  for (proc = 0; proc < N_PROCS; proc++)
+  {
+
+    // Outgoing: the streams of rank proc, straight out of the shells.
+    numStreams = RANK_NUM_STREAMS(proc);
+
+    for (iterIndex = 0; iterIndex < numStreams; iterIndex++)
+    {
+
+      workIndex = WORK_INDEX(proc, iterIndex);
+
+      nodeOffsets[iterIndex] = (MPI_Aint) sizeof(Node_t)
+                               * idx_frcs(computeLines[GROUP_STREAM(workIndex)][0],
+                                          computeLines[GROUP_STREAM(workIndex)][1],
+                                          computeLines[GROUP_STREAM(workIndex)][2],
+                                          INNER_ACTIVE_SHELL);
+
+      epartsOffsets[iterIndex] = (MPI_Aint) sizeof(Scalar_t)
+                                 * idx_frcsspem(computeLines[GROUP_STREAM(workIndex)][0],
+                                                computeLines[GROUP_STREAM(workIndex)][1],
+                                                computeLines[GROUP_STREAM(workIndex)][2],
+                                                INNER_ACTIVE_SHELL,0,0,0);
+
+    }
+
+    shellCounts[proc] = (numStreams > 0) ? 1 : 0;
+
+    if (numStreams > 0)
+    {
+
+      MPI_Type_create_hindexed_block(numStreams, 1, nodeOffsets,
+                                     ringNode, &shellNodes[proc]);
+      MPI_Type_commit(&shellNodes[proc]);
+
+      MPI_Type_create_hindexed_block(numStreams, 1, epartsOffsets,
+                                     StreamEparts_T, &shellEparts[proc]);
+      MPI_Type_commit(&shellEparts[proc]);
+
+    }
+    else
+    {
+
+      shellNodes[proc]  = node;
+      shellEparts[proc] = Scalar_T;
+
+    }
+
+    // Incoming: the part held by rank proc of each of our streams.
+    numStreams = RANK_NUM_STREAMS(mpi_rank);
+
+    streamCounts[proc]  = (numStreams > 0) ? 1 : 0;
+    nodeDispls[proc]    = (int) (sizeof(Node_t) * displGrid[proc]);
+    epartsDispls[proc]  = (int) (sizeof(Scalar_t) * displEparts[proc]);
+
+    if (numStreams > 0)
+    {
+
+      MPI_Type_create_hvector(numStreams, recvCountGrid[proc],
+                              (MPI_Aint) sizeof(Node_t) * TOTAL_ACTIVE_STREAM_SIZE,
+                              node, &streamNodes[proc]);
+      MPI_Type_commit(&streamNodes[proc]);
+
+      MPI_Type_create_hvector(numStreams, recvCountEparts[proc],
+                              (MPI_Aint) sizeof(Scalar_t) * TOTAL_ACTIVE_STREAM_SIZE * SPEM,
+                              Scalar_T, &streamEparts[proc]);
+      MPI_Type_commit(&streamEparts[proc]);
+
+    }
+    else
+    {
+
+      streamNodes[proc]  = node;
+      streamEparts[proc] = Scalar_T;
+
+    }
+
+  }
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static void                                          /*--*/
+/*--*/          freeStreamTransposeTypes (                           /*--*/
+/*--*/                     MPI_Datatype *shellNodes,                 /*--*/
+/*--*/                     MPI_Datatype *shellEparts,                /*--*/
+/*--*/                     MPI_Datatype *streamNodes,                /*--*/
+/*--*/                     MPI_Datatype *streamEparts,               /*--*/
+/*--*/                     int *shellCounts,                         /*--*/
+/*--*/                     int *streamCounts )                       /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t proc;
+
+  for (proc = 0; proc < N_PROCS; proc++)
+  {
+
+    if (shellCounts[proc] > 0)
+    {
+      MPI_Type_free(&shellNodes[proc]);
+      MPI_Type_free(&shellEparts[proc]);
+    }
+
+    if (streamCounts[proc] > 0)
+    {
+      MPI_Type_free(&streamNodes[proc]);
+      MPI_Type_free(&streamEparts[proc]);
+    }
+
+  }
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          update_streams_from_shells ( void )                  /*--*/
+/*--                                                                   --*/
+/*-- Gather every stream this rank works on from the corresponding     --*/
+/*-- shells across all MPI ranks, in one all-to-all per data set.      --*/
+/*-- Stream iterIndex lands at streamGridAll[iterIndex *               --*/
+/*-- TOTAL_ACTIVE_STREAM_SIZE] (see select_stream()). Same result as   --*/
+/*-- calling update_stream_from_shells() for every iterIndex.          --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  MPI_Datatype shellNodes[N_PROCS], shellEparts[N_PROCS];
+  MPI_Datatype streamNodes[N_PROCS], streamEparts[N_PROCS];
+  int shellCounts[N_PROCS], streamCounts[N_PROCS], shellDispls[N_PROCS];
+  int nodeDispls[N_PROCS], epartsDispls[N_PROCS];
+  Index_t proc;
+
+  double timer_tmp = 0;
+
+  timer_tmp = MPI_Wtime();
+
+  streamTransposeTypes(StreamNodes_T, StreamNode_T,
+                       shellNodes, shellEparts, streamNodes, streamEparts,
+                       shellCounts, streamCounts, nodeDispls, epartsDispls);
+
+  // The shell-side types carry absolute offsets into grid/eParts.
+  for (proc = 0; proc < N_PROCS; proc++) shellDispls[proc] = 0;
+
+  MPI_Alltoallw(eParts, shellCounts, shellDispls, shellEparts,
+                ePartsStreamAll, streamCounts, epartsDispls, streamEparts,
+                comm_stream);
+
+  MPI_Alltoallw(grid, shellCounts, shellDispls, shellNodes,
+                streamGridAll, streamCounts, nodeDispls, streamNodes,
+                comm_stream);
+
+  freeStreamTransposeTypes(shellNodes, shellEparts, streamNodes, streamEparts,
+                           shellCounts, streamCounts);
+
+  timer_MPIgatherscatter = timer_MPIgatherscatter
+                           + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          update_shells_from_streams ( void )                  /*--*/
+/*--                                                                   --*/
+/*-- Scatter every stream this rank works on back to the               --*/
+/*-- corresponding shells across all MPI ranks; the inverse of         --*/
+/*-- update_streams_from_shells().                                     --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  MPI_Datatype shellNodes[N_PROCS], shellEparts[N_PROCS];
+  MPI_Datatype streamNodes[N_PROCS], streamEparts[N_PROCS];
+  int shellCounts[N_PROCS], streamCounts[N_PROCS], shellDispls[N_PROCS];
+  int nodeDispls[N_PROCS], epartsDispls[N_PROCS];
+  Index_t proc;
+
+  double timer_tmp = 0;
+
+  timer_tmp = MPI_Wtime();
+
+  streamTransposeTypes(StreamSeams_T, StreamSeam_T,
+                       shellNodes, shellEparts, streamNodes, streamEparts,
+                       shellCounts, streamCounts, nodeDispls, epartsDispls);
+
+  for (proc = 0; proc < N_PROCS; proc++) shellDispls[proc] = 0;
+
+  MPI_Alltoallw(ePartsStreamAll, streamCounts, epartsDispls, streamEparts,
+                eParts, shellCounts, shellDispls, shellEparts,
+                comm_stream);
+
+  MPI_Alltoallw(streamGridAll, streamCounts, nodeDispls, streamNodes,
+                grid, shellCounts, shellDispls, shellNodes,
+                comm_stream);
+
+  freeStreamTransposeTypes(shellNodes, shellEparts, streamNodes, streamEparts,
+                           shellCounts, streamCounts);
+
+  timer_MPIgatherscatter = timer_MPIgatherscatter
+                           + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static Index_t                                       /*--*/
+/*--*/          faceGroupOf ( Index_t face, Index_t row )            /*--*/
+/*--                                                                   --*/
+/*-- The face group owning the nodes of the given (face,row) row.      --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t group;
+
+  group = 0;
+
+  while (face * FACE_ROWS + row >= FACE_GROUP_ROW(group + 1))
+    group++;
+
+  return group;
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static Index_t                                       /*--*/
+/*--*/          faceGroupOfNode ( Index_t node )                     /*--*/
+/*--                                                                   --*/
+/*-- The face group owning the shell node with the given idx_frc.      --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  return faceGroupOf(node / RC, (node % RC) / FACE_COLS);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+// The shell links of every node of a shell, by idx_frc: the idx_frc of
+// its n, e, w and s neighbors. They are the same on every shell.
+static Index_t      *nodeLinks      = NULL;
+
+// Per face group: the halo datatypes exchanged with it on comm_face.
+static int          *haloSendCounts = NULL;
+static int          *haloRecvCounts = NULL;
+static MPI_Datatype *haloSendTypes  = NULL;
+static MPI_Datatype *haloRecvTypes  = NULL;
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          initFaceGroupNodes ( void )                          /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t face, row, col, node, link;
+
+  Node_t *cube;
+
+  nodeRole  = (Index_t *) malloc(sizeof(Index_t) * FRC);
+  nodeSlot  = (Index_t *) malloc(sizeof(Index_t) * FRC);
+  nodeLinks = (Index_t *) malloc(sizeof(Index_t) * 4 * FRC);
+
+  // The links of a whole scratch shell.
+  cube = (Node_t *) malloc(sizeof(Node_t) * FRC);
+
+  initNEWS(cube, INNER_SHELL);
+
+  for (node = 0; node < FRC; node++)
+  {
+
+    nodeLinks[4 * node + 0] = idx_frc(cube[node].n.face, cube[node].n.row, cube[node].n.col);
+    nodeLinks[4 * node + 1] = idx_frc(cube[node].e.face, cube[node].e.row, cube[node].e.col);
+    nodeLinks[4 * node + 2] = idx_frc(cube[node].w.face, cube[node].w.row, cube[node].w.col);
+    nodeLinks[4 * node + 3] = idx_frc(cube[node].s.face, cube[node].s.row, cube[node].s.col);
+
+  }
+
+  free(cube);
+
+  for (face = 0; face < NUM_FACES; face++)
+    for (row = 0; row < FACE_ROWS; row++)
+      for (col = 0; col < FACE_COLS; col++)
+        nodeRole[idx_frc(face,row,col)] = (faceGroupOf(face, row) == face_group) ?
+                                          NODE_OWNED : NODE_REMOTE;
+
+  // The halo: every node linked with an owned node, either way. An owned
+  // node needs the positions of the nodes its links reach for its shell
+  // data, and the eParts of the nodes whose links reach it.
+  for (node = 0; node < FRC; node++)
+  {
+    for (link = 0; link < 4; link++)
+    {
+
+      if ( (nodeRole[node] == NODE_OWNED) &&
+           (nodeRole[nodeLinks[4 * node + link]] == NODE_REMOTE) )
+        nodeRole[nodeLinks[4 * node + link]] = NODE_HALO;
+
+      if ( (nodeRole[node] == NODE_REMOTE) &&
+           (nodeRole[nodeLinks[4 * node + link]] == NODE_OWNED) )
+        nodeRole[node] = NODE_HALO;
+
+    }
+  }
+
+  NUM_LOCAL_NODES = 0;
+
+  for (node = 0; node < FRC; node++)
+    nodeSlot[node] = (nodeRole[node] != NODE_REMOTE) ? NUM_LOCAL_NODES++ : -1;
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          initFaceGroupHalo ( void )                           /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t node, link, other, group, numSend, numRecv;
+
+  Index_t *halo;
+
+  MPI_Aint *sendOffsets, *recvOffsets;
+
+  if (NUM_FACE_GROUPS == 1)
+    return;
+
+  // Called again after the shells are rebalanced.
+  if (haloSendTypes != NULL)
+  {
+
+    for (group = 0; group < NUM_FACE_GROUPS; group++)
+    {
+      if (haloSendCounts[group] > 0) MPI_Type_free(&haloSendTypes[group]);
+      if (haloRecvCounts[group] > 0) MPI_Type_free(&haloRecvTypes[group]);
+    }
+
+    free(haloSendCounts);
+    free(haloRecvCounts);
+    free(haloSendTypes);
+    free(haloRecvTypes);
+
+  }
+
+  haloSendCounts = (int *) malloc(sizeof(int) * NUM_FACE_GROUPS);
+  haloRecvCounts = (int *) malloc(sizeof(int) * NUM_FACE_GROUPS);
+  haloSendTypes  = (MPI_Datatype *) malloc(sizeof(MPI_Datatype) * NUM_FACE_GROUPS);
+  haloRecvTypes  = (MPI_Datatype *) malloc(sizeof(MPI_Datatype) * NUM_FACE_GROUPS);
+
+  halo        = (Index_t *) malloc(sizeof(Index_t) * FRC);
+  sendOffsets = (MPI_Aint *) malloc(sizeof(MPI_Aint) * FRC);
+  recvOffsets = (MPI_Aint *) malloc(sizeof(MPI_Aint) * FRC);
+
+  // The offsets are taken from slot 0 of a shell; the eParts of a node
+  // lie at the same distance from it on every shell.
+  for (group = 0; group < NUM_FACE_GROUPS; group++)
+  {
+
+    // Mark the links between our owned nodes and those of group: our
+    // end goes out (1), its end comes in (2).
+    for (node = 0; node < FRC; node++)
+      halo[node] = 0;
+
+    if (group != face_group)
+    {
+      for (node = 0; node < FRC; node++)
+      {
+        for (link = 0; link < 4; link++)
+        {
+
+          other = nodeLinks[4 * node + link];
+
+          if ( (nodeRole[node] == NODE_OWNED) && (faceGroupOfNode(other) == group) )
+          {
+            halo[node]  |= 1;
+            halo[other] |= 2;
+          }
+
+          if ( (nodeRole[other] == NODE_OWNED) && (faceGroupOfNode(node) == group) )
+          {
+            halo[other] |= 1;
+            halo[node]  |= 2;
+          }
+
+        }
+      }
+    }
+
+    numSend = 0;
+    numRecv = 0;
+
+    for (node = 0; node < FRC; node++)
+    {
+
+      if (halo[node] & 1)
+        sendOffsets[numSend++] = (MPI_Aint) sizeof(Scalar_t) * nodeSlot[node] * SSPEM;
+
+      if (halo[node] & 2)
+        recvOffsets[numRecv++] = (MPI_Aint) sizeof(Scalar_t) * nodeSlot[node] * SSPEM;
+
+    }
+
+    haloSendCounts[group] = (numSend > 0) ? 1 : 0;
+    haloSendTypes[group]  = Scalar_T;
+
+    if (numSend > 0)
+    {
+      MPI_Type_create_hindexed_block(numSend, SPEM, sendOffsets,
+                                     Scalar_T, &haloSendTypes[group]);
+      MPI_Type_commit(&haloSendTypes[group]);
+    }
+
+    haloRecvCounts[group] = (numRecv > 0) ? 1 : 0;
+    haloRecvTypes[group]  = Scalar_T;
+
+    if (numRecv > 0)
+    {
+      MPI_Type_create_hindexed_block(numRecv, SPEM, recvOffsets,
+                                     Scalar_T, &haloRecvTypes[group]);
+      MPI_Type_commit(&haloRecvTypes[group]);
+    }
+
+  }
+
+  free(halo);
+  free(sendOffsets);
+  free(recvOffsets);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          exchangeFaceGroupHalo ( Index_t shell )              /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  int HALO_TAG = 3;
+
+  Index_t group, numRequests;
+
+  Scalar_t *shellEparts;
+
+  MPI_Request requests[2 * NUM_FACE_GROUPS];
+
+  double timer_tmp;
+
+  if (NUM_FACE_GROUPS == 1)
+    return;
+
+  timer_tmp = MPI_Wtime();
+
+  // slot 0 of the shell (see initFaceGroupHalo())
+  shellEparts = &eParts[RING_SHELL(shell) * SPEM];
+
+  numRequests = 0;
+
+  // The rank of face group g in comm_face is g.
+  for (group = 0; group < NUM_FACE_GROUPS; group++)
+  {
+
+    if (haloRecvCounts[group] > 0)
+      MPI_Irecv(shellEparts, 1, haloRecvTypes[group], group,
+                HALO_TAG, comm_face, &requests[numRequests++]);
+
+    if (haloSendCounts[group] > 0)
+      MPI_Isend(shellEparts, 1, haloSendTypes[group], group,
+                HALO_TAG, comm_face, &requests[numRequests++]);
+
+  }
+
+  MPI_Waitall(numRequests, requests, MPI_STATUSES_IGNORE);
+
+  timer_MPIsendrecv = timer_MPIsendrecv + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          gatherFaceGroupStream ( Index_t face,                /*--*/
+/*--*/                                  Index_t row,                 /*--*/
+/*--*/                                  Index_t col,                 /*--*/
+/*--*/                                  Index_t withEparts )         /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  int STREAM_TAG = 4;
+
+  Index_t owner;
+
+  double timer_tmp;
+
+  timer_tmp = MPI_Wtime();
+
+  owner = faceGroupOf(face, row);
+
+  if (owner == face_group)
+  {
+
+    MPI_Gatherv(&grid[idx_frcs(face,row,col,INNER_ACTIVE_SHELL)],
+                1,
+                StreamNodes_T,
+                streamGrid,
+                recvCountGrid,
+                displGrid,
+                StreamNode_T,
+                0,
+                comm_stream);
+
+    if (withEparts > 0)
+      MPI_Gatherv(&eParts[idx_frcsspem(face,row,col,INNER_ACTIVE_SHELL,0,0,0)],
+                  1,
+                  StreamEparts_T,
+                  ePartsStream,
+                  recvCountEparts,
+                  displEparts,
+                  Scalar_T,
+                  0,
+                  comm_stream);
+
+  }
+
+  // The rank of face group g in comm_face is g.
+  if ( (mpi_rank == 0) && (owner != 0) )
+  {
+
+    if (face_group == owner)
+    {
+
+      MPI_Send(streamGrid, TOTAL_ACTIVE_STREAM_SIZE, StreamNode_T,
+               0, STREAM_TAG, comm_face);
+
+      if (withEparts > 0)
+        MPI_Send(ePartsStream, TOTAL_ACTIVE_STREAM_SIZE * SPEM, Scalar_T,
+                 0, STREAM_TAG, comm_face);
+
+    }
+    else if (face_group == 0)
+    {
+
+      MPI_Recv(streamGrid, TOTAL_ACTIVE_STREAM_SIZE, StreamNode_T,
+               owner, STREAM_TAG, comm_face, MPI_STATUS_IGNORE);
+
+      if (withEparts > 0)
+        MPI_Recv(ePartsStream, TOTAL_ACTIVE_STREAM_SIZE * SPEM, Scalar_T,
+                 owner, STREAM_TAG, comm_face, MPI_STATUS_IGNORE);
+
+    }
+
+  }
+
+  timer_MPIgatherscatter = timer_MPIgatherscatter
+                           + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          select_stream ( Index_t iterIndex )                  /*--*/
+/*--                                                                   --*/
+/*-- Point streamGrid/ePartsStream at stream iterIndex of              --*/
+/*-- streamGridAll/ePartsStreamAll so that the stream solvers work on  --*/
+/*-- it in place. An iterIndex with no stream on this rank (e.g. -1)   --*/
+/*-- points them back at their own single-stream buffers.              --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  if ( (iterIndex >= 0) && (iterIndex < RANK_NUM_STREAMS(mpi_rank)) )
+    point_stream(&streamGridAll[iterIndex * TOTAL_ACTIVE_STREAM_SIZE],
+                 &ePartsStreamAll[iterIndex * TOTAL_ACTIVE_STREAM_SIZE * SPEM]);
+  else
+    point_stream(NULL, NULL);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+typedef struct {
+  Scalar_t cost;
+  Index_t  stream;
+} StreamCost_t;
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static int                                           /*--*/
+/*--*/          compareStreamCost ( const void *a, const void *b )   /*--*/
+/*--                                                                   --*/
+/*-- qsort() order of the streams: most costly first, ties by stream.  --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  const StreamCost_t *x = (const StreamCost_t *) a;
+  const StreamCost_t *y = (const StreamCost_t *) b;
+
+  if (x->cost > y->cost) return -1;
+  if (x->cost < y->cost) return  1;
+
+  return (x->stream > y->stream) - (x->stream < y->stream);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          scheduleStreams ( void )                             /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t stream, proc, best, first;
+
+  Index_t *owner;
+  Scalar_t *load;
+  StreamCost_t *order;
+
+  Scalar_t total, maxLoad;
+
+  double timer_tmp;
+
+  timer_tmp = MPI_Wtime();
+
+  // Every stream was computed by exactly one rank of the face group.
+  MPI_Allreduce(MPI_IN_PLACE, streamCost, GROUP_NUM_STREAMS,
+                MPI_DOUBLE, MPI_SUM, comm_stream);
+
+  total = 0.0;
+
+  for (stream = 0; stream < GROUP_NUM_STREAMS; stream++)
+    total += streamCost[stream];
+
+  // Nothing measured yet: keep the round-robin schedule.
+  if (total <= 0.0)
+  {
+    timer_MPIsendrecv = timer_MPIsendrecv + (MPI_Wtime() - timer_tmp);
+    return;
+  }
+
+  if (mpi_rank == 0)
+  {
+
+    owner = (Index_t *) malloc(sizeof(Index_t) * GROUP_NUM_STREAMS);
+    order = (StreamCost_t *) malloc(sizeof(StreamCost_t) * GROUP_NUM_STREAMS);
+    load  = (Scalar_t *) calloc(N_PROCS, sizeof(Scalar_t));
+
+    for (stream = 0; stream < GROUP_NUM_STREAMS; stream++)
+    {
+      order[stream].cost   = streamCost[stream];
+      order[stream].stream = stream;
+    }
+
+    qsort(order, GROUP_NUM_STREAMS, sizeof(StreamCost_t), compareStreamCost);
+
+    for (proc = 0; proc < N_PROCS; proc++)
+      rankNumStreams[proc] = 0;
+
+    // Longest processing time first: each stream, most costly first,
+    // goes to the least loaded rank that still has room for it.
+    for (stream = 0; stream < GROUP_NUM_STREAMS; stream++)
+    {
+
+      best = -1;
+
+      for (proc = 0; proc < N_PROCS; proc++)
+        if ( (rankNumStreams[proc] < MAX_RANK_NUM_STREAMS) &&
+             ((best < 0) || (load[proc] < load[best])) )
+          best = proc;
+
+      owner[stream] = best;
+      load[best] += order[stream].cost;
+      rankNumStreams[best]++;
+
+    }
+
+    first = 0;
 
-  timer_MPIgatherscatter = timer_MPIgatherscatter
-                           + (MPI_Wtime() - timer_tmp);
+    for (proc = 0; proc < N_PROCS; proc++)
+    {
+      scheduleStart[proc] = first;
+      first += rankNumStreams[proc];
+      rankNumStreams[proc] = 0;
+    }
 
-}
-/*-----------------------------------------------------------------------*/
-/*-----------------------------------------------------------------------*/
+    for (stream = 0; stream < GROUP_NUM_STREAMS; stream++)
+    {
+      proc = owner[stream];
+      streamSchedule[scheduleStart[proc] + rankNumStreams[proc]] = order[stream].stream;
+      rankNumStreams[proc]++;
+    }
 
+    maxLoad = 0.0;
 
-/*-----------------------------------------------------------------------*/
-/*-----------------------------------------------------------------------*/
-/*--*/          void                                                 /*--*/
-/*--*/          update_shells_from_stream ( Index_t iterIndex )      /*--*/
-/*--                                                                   --*/
-/*-- Scatter single stream to the cooresponding shells                 --*/
-/*-- across all MPI ranks.                                             --*/
-/*--                                                                   --*/
-/*-----------------------------------------------------------------------*/
-/*-----------------------------------------------------------------------*/
-{
+    for (proc = 0; proc < N_PROCS; proc++)
+      if (load[proc] > maxLoad) maxLoad = load[proc];
 
-  Index_t proc, workIndex, num_calls;
+    ROOT_MSG("  --> Scheduled streams: largest stream load per rank %.3e s (mean %.3e s)\n",
+             maxLoad, total / N_PROCS);
 
-  double timer_tmp = 0;
+    free(load);
+    free(order);
+    free(owner);
 
-  MPI_Request request_grid[N_PROCS];
-  MPI_Request request_eparts[N_PROCS];
+  }
 
-  timer_tmp = MPI_Wtime();
+  MPI_Bcast(rankNumStreams, N_PROCS, MPI_INT, 0, comm_stream);
+  MPI_Bcast(streamSchedule, GROUP_NUM_STREAMS, MPI_INT, 0, comm_stream);
 
-  num_calls = 0;
+  first = 0;
+  STREAM_SCHEDULE_LENGTH = 0;
 
   for (proc = 0; proc < N_PROCS; proc++)
   {
 
-    workIndex = proc + N_PROCS * iterIndex;
-
-    if (workIndex < NUM_STREAMS)
-    {
-      num_calls++;
-
-      MPI_Iscatterv(ePartsStream,
-                    recvCountEparts,
-                    displEparts,
-                    Scalar_T,
-                    &eParts[idx_frcsspem(computeLines[workIndex][0],
-                                         computeLines[workIndex][1],
-                                         computeLines[workIndex][2],
-                                         INNER_ACTIVE_SHELL,0,0,0)],
-                    ACTIVE_STREAM_SIZE*NUM_SPECIES*NUM_ESTEPS*NUM_MUSTEPS,
-                    Scalar_T,
-                    proc,
-                    MPI_COMM_WORLD,
-                    &request_eparts[proc]);
-
-      MPI_Iscatterv(streamGrid,
-                    recvCountGrid,
-                    displGrid,
-                    Node_T,
-                    &grid[idx_frcs(computeLines[workIndex][0],
-                                   computeLines[workIndex][1],
-                                   computeLines[workIndex][2],
-                                   INNER_ACTIVE_SHELL)],
-                    ACTIVE_STREAM_SIZE,
-                    Node_T,
-                    proc,
-                    MPI_COMM_WORLD,
-                    &request_grid[proc]);
+    scheduleStart[proc] = first;
+    first += rankNumStreams[proc];
 
-    }
+    if (rankNumStreams[proc] > STREAM_SCHEDULE_LENGTH)
+      STREAM_SCHEDULE_LENGTH = rankNumStreams[proc];
 
   }
 
-  MPI_Waitall(num_calls, request_eparts, MPI_STATUSES_IGNORE);
-  MPI_Waitall(num_calls, request_grid,   MPI_STATUSES_IGNORE);
+  for (stream = 0; stream < GROUP_NUM_STREAMS; stream++)
+    streamCost[stream] = 0.0;
 
-  timer_MPIgatherscatter = timer_MPIgatherscatter
-                           + (MPI_Wtime() - timer_tmp);
+  timer_MPIsendrecv = timer_MPIsendrecv + (MPI_Wtime() - timer_tmp);
 
 }
 /*-----------------------------------------------------------------------*/
@@ -329,20 +1371,15 @@ Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
 // This routine basically acts as a "seam" for the streams across shell bounderies
 // But only for those values needed in the shell-stage (focusing).
 //
-  Index_t workIndex;
-
   Vec_t rMinus, r, rPlus;
   Index_t shellMinus, shell, shellPlus;
   Scalar_t dsPlus, dsMinus;
 
-  workIndex = mpi_rank + N_PROCS * iterIndex;
-
-  // workIndex is not used in this loop.
-  // However there may be procesors with some empty streams.
+  // There may be procesors with some empty streams.
   // Those procs do not need to compute these things so we put this conditional here
   // to avoid needless computation.
 
-  if (workIndex < NUM_STREAMS)
+  if (iterIndex < RANK_NUM_STREAMS(mpi_rank))
   {
 
     for (shell = 0; shell < TOTAL_NUM_SHELLS; shell++)
@@ -472,16 +1509,18 @@ Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
   Scalar_t * recvBuffF;
   Node_t *   sendBuffG;
   Node_t *   recvBuffG;
+  Node_t     links;
 
   double timer_tmp=0;
 
   timer_tmp = MPI_Wtime();
 
-  // allocate the memory for the send and receive buffers
-  sendBuffF = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)NUM_FACES*RCSPEM);
-  recvBuffF = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)NUM_FACES*RCSPEM);
-  sendBuffG = (Node_t *)   malloc(sizeof(Node_t)*(int)NUM_FACES*RC);
-  recvBuffG = (Node_t *)   malloc(sizeof(Node_t)*(int)NUM_FACES*RC);
+  // allocate the memory for the send and receive buffers; all ranks of
+  // a face group store the same nodes, in the same slots
+  sendBuffF = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)NUM_LOCAL_NODES*SPEM);
+  recvBuffF = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)NUM_LOCAL_NODES*SPEM);
+  sendBuffG = (Node_t *)   malloc(sizeof(Node_t)*(int)NUM_LOCAL_NODES);
+  recvBuffG = (Node_t *)   malloc(sizeof(Node_t)*(int)NUM_LOCAL_NODES);
 
   proc_left  = mpi_rank - 1;
   proc_right = mpi_rank + 1;
@@ -504,7 +1543,9 @@ Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
       for (row = 0; row < FACE_ROWS; row++) {
         for (col = 0; col < FACE_COLS; col++) {
 
-          sendBuffG[idx_frc(face,row,col)]
+          if (!LOCAL_NODE(face,row,col)) continue;
+
+          sendBuffG[NODE_SLOT(face,row,col)]
           = grid[idx_frcs(face,row,col,OUTER_SHELL)];
 
           for (species = 0; species < NUM_SPECIES; species++) {
@@ -524,35 +1565,35 @@ Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
   }
 
   MPI_Irecv(&recvBuffG[0],
-           NUM_FACES*RC,
+           NUM_LOCAL_NODES,
            Node_T,
            proc_left,
            RIPPLEG_TAG,
-           MPI_COMM_WORLD,
+           comm_stream,
            &req[0]);
 
   MPI_Irecv(&recvBuffF[0],
-           NUM_FACES*RCSPEM,
+           NUM_LOCAL_NODES*SPEM,
            Scalar_T,
            proc_left,
            RIPPLEF_TAG,
-           MPI_COMM_WORLD,
+           comm_stream,
            &req[1]);
 
   MPI_Isend(&sendBuffG[0],
-           NUM_FACES*RC,
+           NUM_LOCAL_NODES,
            Node_T,
            proc_right,
            RIPPLEG_TAG,
-           MPI_COMM_WORLD,
+           comm_stream,
            &req[2]);
 
   MPI_Isend(&sendBuffF[0],
-           NUM_FACES*RCSPEM,
+           NUM_LOCAL_NODES*SPEM,
            Scalar_T,
            proc_right,
            RIPPLEF_TAG,
-           MPI_COMM_WORLD,
+           comm_stream,
            &req[3]);
 
   MPI_Waitall(4,req,MPI_STATUSES_IGNORE);
@@ -567,8 +1608,20 @@ Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
       for (row = 0; row < FACE_ROWS; row++) {
         for (col = 0; col < FACE_COLS; col++) {
 
+          if (!LOCAL_NODE(face,row,col)) continue;
+
+          /*-- Keep this proc's own links on the received node. --*/
+          links = grid[idx_frcs(face,row,col,INNER_SHELL)];
+
           grid[idx_frcs(face,row,col,INNER_SHELL)]
-          = recvBuffG[idx_frc(face,row,col)];
+          = recvBuffG[NODE_SLOT(face,row,col)];
+
+          grid[idx_frcs(face,row,col,INNER_SHELL)].n = links.n;
+          grid[idx_frcs(face,row,col,INNER_SHELL)].e = links.e;
+          grid[idx_frcs(face,row,col,INNER_SHELL)].w = links.w;
+          grid[idx_frcs(face,row,col,INNER_SHELL)].s = links.s;
+          grid[idx_frcs(face,row,col,INNER_SHELL)].streamIn = links.streamIn;
+          grid[idx_frcs(face,row,col,INNER_SHELL)].streamOut = links.streamOut;
 
           for (species = 0; species < NUM_SPECIES; species++) {
             for (energy = 0; energy < NUM_ESTEPS; energy++) {
@@ -647,6 +1700,8 @@ Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
     for (row   = 0; row   < FACE_ROWS;  row++  ){
       for (col   = 0; col   < FACE_COLS;  col++  ){
 
+        if (!LOCAL_NODE(face,row,col)) continue;
+
         /*-- Get copies of new shell's position data  --*/
         /*-- for use in computing updates.            --*/
         azi    = grid[idx_frcs(face,row,col,INNER_ACTIVE_SHELL)].azi;
@@ -682,49 +1737,459 @@ Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
 /*--*/          void                                                /*---*/
 /*--*/    rippleShellsOut(void)                                     /*---*/
 /*--*                                                                *---*/
-/*--* Copy nodes from shell to shell sequentially starting from the  *---*/
-/*--* outer shell and moving to the inner shell. The outer shell's   *---*/
-/*--* node data gets clobbered, the inner shell's remains unchanged. *---*/
-/*--* Moves all shell data (but not cube adjacencies) out one cube.  *---*/
+/*--* Move all shell data (but not cube adjacencies) out one cube.   *---*/
+/*--* The outer shell's node data gets clobbered, the inner shell's  *---*/
+/*--* remains unchanged.                                             *---*/
+/*--*                                                                *---*/
+/*--* The shells are stored as a ring (see RING_SHELL in global.h),  *---*/
+/*--* so instead of copying every shell one slot outward we rotate   *---*/
+/*--* SHELL_OFFSET back by one: every shell now reads its data from  *---*/
+/*--* the slot that held the next shell in, and the old outer shell's *---*/
+/*--* slot becomes the inner shell, which is refilled from its       *---*/
+/*--* neighbor. Only the inner shell's data is copied.               *---*/
+/*--*                                                                *---*/
+/*--* Face links (n,e,w,s) always point into the node's own shell    *---*/
+/*--* and are otherwise the same on every shell of a proc, so they   *---*/
+/*--* move along with the data (their shell index is not kept up to  *---*/
+/*--* date; use the node's own shell). Stream links only differ at   *---*/
+/*--* the ends of the local stream, so those are reset for the       *---*/
+/*--* shells whose end-of-stream status changed.                     *---*/
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 {
-  Index_t  face, row, col, shell;
-  Neighbor_t n, e, w, s, streamIn, streamOut;
+  Index_t  face, row, col;
 
-  for (shell = OUTER_SHELL; shell > INNER_SHELL;  shell--){
-    for (face  = 0;            face  < NUM_FACES;    face++ ){
-      for (row   = 0;            row   < FACE_ROWS;    row++  ){
-        for (col   = 0;            col   < FACE_COLS;    col++  ){
+  SHELL_OFFSET = RING_SHELL(OUTER_SHELL);
 
-          n = grid[idx_frcs(face,row,col,shell)].n;
-          e = grid[idx_frcs(face,row,col,shell)].e;
-          w = grid[idx_frcs(face,row,col,shell)].w;
-          s = grid[idx_frcs(face,row,col,shell)].s;
-          streamIn = grid[idx_frcs(face,row,col,shell)].streamIn;
-          streamOut = grid[idx_frcs(face,row,col,shell)].streamOut;
+  for (face  = 0;            face  < NUM_FACES;    face++ ){
+    for (row   = 0;            row   < FACE_ROWS;    row++  ){
+      for (col   = 0;            col   < FACE_COLS;    col++  ){
 
-          memcpy(&grid[idx_frcs(face,row,col,shell)], &grid[idx_frcs(face,row,col,shell-1)],
-                 sizeof(Node_t));
-          memcpy(&eParts[idx_frcsspem(face,row,col,shell,0,0,0)], &eParts[idx_frcsspem(face,row,col,shell-1,0,0,0)],
-                 sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
+        if (!LOCAL_NODE(face,row,col)) continue;
 
-          grid[idx_frcs(face,row,col,shell)].n = n;
-          grid[idx_frcs(face,row,col,shell)].e = e;
-          grid[idx_frcs(face,row,col,shell)].w = w;
-          grid[idx_frcs(face,row,col,shell)].s = s;
-          grid[idx_frcs(face,row,col,shell)].streamIn = streamIn;
-          grid[idx_frcs(face,row,col,shell)].streamOut = streamOut;
+        memcpy(&grid[idx_frcs(face,row,col,INNER_SHELL)],
+               &grid[idx_frcs(face,row,col,INNER_ACTIVE_SHELL)],
+               sizeof(Node_t));
+        memcpy(&eParts[idx_frcsspem(face,row,col,INNER_SHELL,0,0,0)],
+               &eParts[idx_frcsspem(face,row,col,INNER_ACTIVE_SHELL,0,0,0)],
+               sizeof(Scalar_t) * NUM_SPECIES * NUM_ESTEPS * NUM_MUSTEPS);
 
-        }
       }
     }
   }
 
+  setStreamNeighbors(INNER_SHELL);
+  setStreamNeighbors(INNER_ACTIVE_SHELL);
+  if (INNER_ACTIVE_SHELL + 1 < OUTER_SHELL)
+    setStreamNeighbors(INNER_ACTIVE_SHELL + 1);
+  setStreamNeighbors(OUTER_SHELL);
+
+  /*-- The active part of each stream now starts at a new slot. --*/
+  initMPI_streamRing();
+
 } /*------ END  rippleShellsOut( ) ----------------------------------*/
 /*-------------------------------------------------------------------*/
 
 
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static Index_t                                       /*--*/
+/*--*/          splitShells ( Scalar_t *cost,                        /*--*/
+/*--*/                        Scalar_t bound,                        /*--*/
+/*--*/                        Index_t *counts )                      /*--*/
+/*--                                                                   --*/
+/*-- Cut the active shells, front to back, into consecutive ranges of  --*/
+/*-- at most MAX_LOCAL_NUM_SHELLS-1 shells that cost no more than      --*/
+/*-- bound (a single shell may). Returns the number of ranges; only    --*/
+/*-- the first N_PROCS of them are stored in counts.                   --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t shell, numRanges, numShells;
+
+  Scalar_t sum;
+
+  numRanges = 0;
+  numShells = 0;
+  sum       = 0.0;
+
+  for (shell = 0; shell < TOTAL_ACTIVE_STREAM_SIZE; shell++)
+  {
+
+    if ( (numShells > 0) &&
+         ((sum + cost[shell] > bound) || (numShells == MAX_LOCAL_NUM_SHELLS - 1)) )
+    {
+
+      if (numRanges < N_PROCS) counts[numRanges] = numShells;
+
+      numRanges++;
+      numShells = 0;
+      sum       = 0.0;
+
+    }
+
+    numShells++;
+    sum += cost[shell];
+
+  }
+
+  if (numRanges < N_PROCS) counts[numRanges] = numShells;
+
+  return numRanges + 1;
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static void                                          /*--*/
+/*--*/          partitionShells ( Scalar_t *cost, Index_t *counts )  /*--*/
+/*--                                                                   --*/
+/*-- Weighted partition of the active shells over the N_PROCS ranks:   --*/
+/*-- bisect for the smallest cost per rank that splitShells() fits     --*/
+/*-- into N_PROCS ranges, then give any rank left without a shell one  --*/
+/*-- from the nearest rank before it that has two or more.             --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t shell, proc, donor, numRanges, iter;
+
+  Scalar_t lo, hi, bound;
+
+  lo = 0.0;
+  hi = 0.0;
+
+  for (shell = 0; shell < TOTAL_ACTIVE_STREAM_SIZE; shell++)
+  {
+    hi += cost[shell];
+    if (cost[shell] > lo) lo = cost[shell];
+  }
+
+  for (iter = 0; iter < 64; iter++)
+  {
+
+    bound = 0.5 * (lo + hi);
+
+    if (splitShells(cost, bound, counts) <= N_PROCS)
+      hi = bound;
+    else
+      lo = bound;
+
+  }
+
+  numRanges = splitShells(cost, hi, counts);
+
+  for (proc = numRanges; proc < N_PROCS; proc++)
+    counts[proc] = 0;
+
+  // Only the lengths of the ranges are stored, so handing a shell from
+  // donor to proc shifts the ranges in between along by one.
+  for (proc = N_PROCS - 1; proc > 0; proc--)
+  {
+
+    donor = proc - 1;
+
+    while (counts[proc] == 0)
+    {
+
+      while (counts[donor] < 2) donor--;
+
+      counts[donor]--;
+      counts[proc]++;
+
+    }
+
+  }
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          static Scalar_t                                      /*--*/
+/*--*/          maxShellLoad ( Scalar_t *cost, Index_t *counts )     /*--*/
+/*--                                                                   --*/
+/*-- The largest summed cost of the shells any rank would hold.        --*/
+/*--                                                                   --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t proc, shell, first;
+
+  Scalar_t load, maxLoad;
+
+  maxLoad = 0.0;
+  first   = 0;
+
+  for (proc = 0; proc < N_PROCS; proc++)
+  {
+
+    load = 0.0;
+
+    for (shell = first; shell < first + counts[proc]; shell++)
+      load += cost[shell];
+
+    if (load > maxLoad) maxLoad = load;
+
+    first += counts[proc];
+
+  }
+
+  return maxLoad;
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          rebalanceShells ( void )                             /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+{
+
+  Index_t face, row, col, shell, proc, first, last, oldLocal;
+
+  Index_t oldCounts[N_PROCS], oldDispls[N_PROCS], counts[N_PROCS];
+
+  int gridSendCounts[N_PROCS], gridRecvCounts[N_PROCS];
+  int gridSendDispls[N_PROCS], gridRecvDispls[N_PROCS];
+  int epartsSendDispls[N_PROCS], epartsRecvDispls[N_PROCS];
+
+  MPI_Datatype gridSendTypes[N_PROCS], gridRecvTypes[N_PROCS];
+  MPI_Datatype epartsSendTypes[N_PROCS], epartsRecvTypes[N_PROCS];
+  MPI_Datatype node;
+
+  Scalar_t oldLoad, newLoad;
+
+  Scalar_t *cost;
+  Scalar_t *oldEparts;
+  Node_t   *oldGrid;
+
+  double timer_tmp;
+
+  timer_tmp = MPI_Wtime();
+
+  // Cost of every active shell, summed over the face groups: all
+  // groups must keep the same shells.
+  cost = (Scalar_t *) calloc(TOTAL_ACTIVE_STREAM_SIZE, sizeof(Scalar_t));
+
+  for (shell = INNER_ACTIVE_SHELL; shell < LOCAL_NUM_SHELLS; shell++)
+  {
+    cost[displGrid[mpi_rank] + shell - INNER_ACTIVE_SHELL] = shellCost[shell];
+    shellCost[shell] = 0.0;
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, cost, TOTAL_ACTIVE_STREAM_SIZE,
+                MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+  // Every rank takes the partition of world rank 0, so that all of
+  // them move to exactly the same one.
+  partitionShells(cost, counts);
+
+  MPI_Bcast(counts, N_PROCS, MPI_INT, 0, MPI_COMM_WORLD);
+
+  for (proc = 0; proc < N_PROCS; proc++)
+  {
+    oldCounts[proc] = recvCountGrid[proc];
+    oldDispls[proc] = displGrid[proc];
+  }
+
+  oldLoad = maxShellLoad(cost, oldCounts);
+  newLoad = maxShellLoad(cost, counts);
+
+  free(cost);
+
+  if (newLoad > (1.0 - MIN_REBALANCE_GAIN) * oldLoad)
+  {
+    timer_MPIsendrecv = timer_MPIsendrecv + (MPI_Wtime() - timer_tmp);
+    return;
+  }
+
+  ROOT_MSG("  --> Rebalanced shells: largest shell load per rank %.3e s -> %.3e s\n",
+           oldLoad, newLoad);
+
+  // Copy this rank's shells out in stream order; the new layout starts
+  // with an unrotated ring.
+  oldLocal  = LOCAL_NUM_SHELLS;
+  oldGrid   = (Node_t *) malloc(sizeof(Node_t) * NUM_LOCAL_NODES * oldLocal);
+  oldEparts = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_LOCAL_NODES * oldLocal * SPEM);
+
+  for (face = 0; face < NUM_FACES; face++)
+  {
+    for (row = 0; row < FACE_ROWS; row++)
+    {
+      for (col = 0; col < FACE_COLS; col++)
+      {
+
+        if (!LOCAL_NODE(face,row,col)) continue;
+
+        for (shell = 0; shell < oldLocal; shell++)
+        {
+
+          oldGrid[NODE_SLOT(face,row,col) * oldLocal + shell]
+            = grid[idx_frcs(face,row,col,shell)];
+
+          memcpy(&oldEparts[(NODE_SLOT(face,row,col) * oldLocal + shell) * SPEM],
+                 &eParts[idx_frcsspem(face,row,col,shell,0,0,0)],
+                 sizeof(Scalar_t) * SPEM);
+
+        }
+      }
+    }
+  }
+
+  setShellCounts(counts);
+  setLocalShellStrides();
+  SHELL_OFFSET = 0;
+
+  MPI_Type_create_resized(Node_T, 0, (MPI_Aint) sizeof(Node_t), &node);
+  MPI_Type_commit(&node);
+
+  // Each pair of ranks exchanges the shells it held before and the
+  // other holds now: the same run of shells out of every node.
+  for (proc = 0; proc < N_PROCS; proc++)
+  {
+
+    // Outgoing.
+    first = (oldDispls[mpi_rank] > displGrid[proc]) ?
+            oldDispls[mpi_rank] : displGrid[proc];
+    last  = (oldDispls[mpi_rank] + oldCounts[mpi_rank] < displGrid[proc] + counts[proc]) ?
+            oldDispls[mpi_rank] + oldCounts[mpi_rank] : displGrid[proc] + counts[proc];
+
+    gridSendCounts[proc]   = (last > first) ? 1 : 0;
+    gridSendTypes[proc]    = node;
+    epartsSendTypes[proc]  = Scalar_T;
+    gridSendDispls[proc]   = 0;
+    epartsSendDispls[proc] = 0;
+
+    if (last > first)
+    {
+
+      shell = first - oldDispls[mpi_rank] + INNER_ACTIVE_SHELL;
+
+      gridSendDispls[proc]   = (int) (sizeof(Node_t) * shell);
+      epartsSendDispls[proc] = (int) (sizeof(Scalar_t) * shell * SPEM);
+
+      MPI_Type_create_hvector(NUM_LOCAL_NODES, last - first,
+                              (MPI_Aint) sizeof(Node_t) * oldLocal,
+                              node, &gridSendTypes[proc]);
+      MPI_Type_commit(&gridSendTypes[proc]);
+
+      MPI_Type_create_hvector(NUM_LOCAL_NODES, (last - first) * SPEM,
+                              (MPI_Aint) sizeof(Scalar_t) * oldLocal * SPEM,
+                              Scalar_T, &epartsSendTypes[proc]);
+      MPI_Type_commit(&epartsSendTypes[proc]);
+
+    }
+
+    // Incoming.
+    first = (oldDispls[proc] > displGrid[mpi_rank]) ?
+            oldDispls[proc] : displGrid[mpi_rank];
+    last  = (oldDispls[proc] + oldCounts[proc] < displGrid[mpi_rank] + counts[mpi_rank]) ?
+            oldDispls[proc] + oldCounts[proc] : displGrid[mpi_rank] + counts[mpi_rank];
+
+    gridRecvCounts[proc]   = (last > first) ? 1 : 0;
+    gridRecvTypes[proc]    = node;
+    epartsRecvTypes[proc]  = Scalar_T;
+    gridRecvDispls[proc]   = 0;
+    epartsRecvDispls[proc] = 0;
+
+    if (last > first)
+    {
+
+      shell = first - displGrid[mpi_rank] + INNER_ACTIVE_SHELL;
+
+      gridRecvDispls[proc]   = (int) (sizeof(Node_t) * shell);
+      epartsRecvDispls[proc] = (int) (sizeof(Scalar_t) * shell * SPEM);
+
+      MPI_Type_create_hvector(NUM_LOCAL_NODES, last - first,
+                              (MPI_Aint) sizeof(Node_t) * LOCAL_NUM_SHELLS,
+                              node, &gridRecvTypes[proc]);
+      MPI_Type_commit(&gridRecvTypes[proc]);
+
+      MPI_Type_create_hvector(NUM_LOCAL_NODES, (last - first) * SPEM,
+                              (MPI_Aint) sizeof(Scalar_t) * LOCAL_NUM_SHELLS * SPEM,
+                              Scalar_T, &epartsRecvTypes[proc]);
+      MPI_Type_commit(&epartsRecvTypes[proc]);
+
+    }
+
+  }
+
+  MPI_Alltoallw(oldGrid, gridSendCounts, gridSendDispls, gridSendTypes,
+                grid, gridRecvCounts, gridRecvDispls, gridRecvTypes,
+                comm_stream);
+
+  MPI_Alltoallw(oldEparts, gridSendCounts, epartsSendDispls, epartsSendTypes,
+                eParts, gridRecvCounts, epartsRecvDispls, epartsRecvTypes,
+                comm_stream);
+
+  // Shell 0 stays with its rank: the spawn template on the inner rank,
+  // the buffer the ripple fills on the others.
+  for (face = 0; face < NUM_FACES; face++)
+  {
+    for (row = 0; row < FACE_ROWS; row++)
+    {
+      for (col = 0; col < FACE_COLS; col++)
+      {
+
+        if (!LOCAL_NODE(face,row,col)) continue;
+
+        grid[idx_frcs(face,row,col,0)] = oldGrid[NODE_SLOT(face,row,col) * oldLocal];
+
+        memcpy(&eParts[idx_frcsspem(face,row,col,0,0,0,0)],
+               &oldEparts[NODE_SLOT(face,row,col) * oldLocal * SPEM],
+               sizeof(Scalar_t) * SPEM);
+
+      }
+    }
+  }
+
+  for (proc = 0; proc < N_PROCS; proc++)
+  {
+
+    if (gridSendCounts[proc] > 0)
+    {
+      MPI_Type_free(&gridSendTypes[proc]);
+      MPI_Type_free(&epartsSendTypes[proc]);
+    }
+
+    if (gridRecvCounts[proc] > 0)
+    {
+      MPI_Type_free(&gridRecvTypes[proc]);
+      MPI_Type_free(&epartsRecvTypes[proc]);
+    }
+
+  }
+
+  MPI_Type_free(&node);
+
+  free(oldGrid);
+  free(oldEparts);
+
+  // The datatypes that depend on the shell layout.
+  initMPI_streamRing();
+  initFaceGroupHalo();
+
+  timer_MPIsendrecv = timer_MPIsendrecv + (MPI_Wtime() - timer_tmp);
+
+}
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 /*--*/          void                                                /*---*/
@@ -753,6 +2218,8 @@ Index_t hdf5_input=0;              // Set=1 if hdf5 input files (RMC move this)
       for (row   = 0;             row   < FACE_ROWS;  row++  ){
         for (col   = 0;             col   < FACE_COLS;  col++  ){
 
+          if (!LOCAL_NODE(face,row,col)) continue;
+
           node = grid[idx_frcs(face,row,col,shell)];
 
           r     = node.r;
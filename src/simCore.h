@@ -68,6 +68,18 @@ void rotSunAndSpawnShell( Time_t t_sun_del );
 /*--*/          void                                                /*---*/
 /*--*/    rippleShellsOut(void)                                     /*---*/;
 
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          rebalanceShells ( void );                            /*--*/
+/*--                                                                   --*/
+/*-- Repartition the active shells over the ranks of comm_stream by    --*/
+/*-- the EP cost measured on each shell (shellCost) since the last     --*/
+/*-- call, and move the shells that change rank. Must be called by     --*/
+/*-- all ranks.                                                        --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
 
 void    moveNodes(Scalar_t dt);    /*-- All shell nodes move in space.         --*/
 
@@ -102,6 +114,113 @@ void    moveNodes(Scalar_t dt);    /*-- All shell nodes move in space.         -
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          start_stream_from_shells ( Index_t iterIndex );      /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          finish_stream_from_shells ( Index_t iterIndex );     /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          start_shells_from_stream ( Index_t iterIndex );      /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          finish_shells_from_stream ( void );                  /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          update_streams_from_shells ( void );                 /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          update_shells_from_streams ( void );                 /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          initFaceGroupNodes ( void );                         /*--*/
+/*--                                                                   --*/
+/*-- Set nodeRole[], nodeSlot[] and NUM_LOCAL_NODES for this face      --*/
+/*-- group: its owned nodes plus the halo nodes linked with them are   --*/
+/*-- the only ones a rank stores. Called before grid is allocated.     --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          initFaceGroupHalo ( void );                          /*--*/
+/*--                                                                   --*/
+/*-- Build the datatypes of the halo exchange with the other face      --*/
+/*-- groups. Called again whenever the shell layout changes.           --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          exchangeFaceGroupHalo ( Index_t shell );             /*--*/
+/*--                                                                   --*/
+/*-- Refresh the eParts of the halo nodes of one shell from the face   --*/
+/*-- groups that own them.                                             --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          gatherFaceGroupStream ( Index_t face,                /*--*/
+/*--*/                                  Index_t row,                 /*--*/
+/*--*/                                  Index_t col,                 /*--*/
+/*--*/                                  Index_t withEparts );        /*--*/
+/*--                                                                   --*/
+/*-- Gather stream (face,row,col) into streamGrid (with withEparts,    --*/
+/*-- its eParts into ePartsStream too) on world rank 0, for the        --*/
+/*-- outputs that cover whole shells. Every rank calls it: the face    --*/
+/*-- group owning the stream gathers it and passes it to face group 0. --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          select_stream ( Index_t iterIndex );                 /*--*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/*--*/          void                                                 /*--*/
+/*--*/          scheduleStreams ( void );                            /*--*/
+/*--                                                                   --*/
+/*-- Reassign the streams of the face group to its ranks, longest      --*/
+/*-- processing time first, by the compute time measured on each       --*/
+/*-- stream (streamCost) since the last call. Keeps the current        --*/
+/*-- schedule if nothing was measured. Must be called by all ranks.    --*/
+/*-----------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+
 /*-----------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------*/
 /*--*/          void                                                 /*--*/
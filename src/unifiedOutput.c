@@ -103,10 +103,13 @@ Index_t strideSize = sizeof(Node_t) / sizeof(double);
 /*------------------------------------------------------------------*/
 {/*-----------------------------------------------------------------*/
 
-  Index_t stream;
+  Index_t stream, group;
   int i;
   FILE *rpout;
 
+  Scalar_t *groupAzi, *groupZen, *azi0, *zen0;
+  int *counts, *displs;
+
   // allocate memory for the output names
   outputLineNamesNetCDF=(char **)malloc(sizeof(char*)*NUM_STREAMS);
   for(i=0;i<NUM_STREAMS;i++){
@@ -123,8 +126,52 @@ Index_t strideSize = sizeof(Node_t) / sizeof(double);
     }
   }
 
+  // The shell 0 angles of every stream: each face group holds only its
+  // own streams, so their first ranks send them to world rank 0.
+  azi0 = NULL;
+  zen0 = NULL;
+
   if (mpi_rank == 0) {
 
+    groupAzi = (Scalar_t *) malloc(sizeof(Scalar_t) * GROUP_NUM_STREAMS);
+    groupZen = (Scalar_t *) malloc(sizeof(Scalar_t) * GROUP_NUM_STREAMS);
+
+    for (stream = 0; stream < GROUP_NUM_STREAMS; stream++) {
+      groupAzi[stream] = grid[idx_frcs(computeLines[FIRST_GROUP_STREAM + stream][0],
+                                       computeLines[FIRST_GROUP_STREAM + stream][1],
+                                       computeLines[FIRST_GROUP_STREAM + stream][2],0)].azi;
+      groupZen[stream] = grid[idx_frcs(computeLines[FIRST_GROUP_STREAM + stream][0],
+                                       computeLines[FIRST_GROUP_STREAM + stream][1],
+                                       computeLines[FIRST_GROUP_STREAM + stream][2],0)].zen;
+    }
+
+    counts = (int *) malloc(sizeof(int) * NUM_FACE_GROUPS);
+    displs = (int *) malloc(sizeof(int) * NUM_FACE_GROUPS);
+
+    for (group = 0; group < NUM_FACE_GROUPS; group++) {
+      counts[group] = (FACE_GROUP_ROW(group + 1) - FACE_GROUP_ROW(group)) * FACE_COLS;
+      displs[group] = FACE_GROUP_ROW(group) * FACE_COLS;
+    }
+
+    if (mpi_rank_world == 0) {
+      azi0 = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_STREAMS);
+      zen0 = (Scalar_t *) malloc(sizeof(Scalar_t) * NUM_STREAMS);
+    }
+
+    MPI_Gatherv(groupAzi, GROUP_NUM_STREAMS, Scalar_T,
+                azi0, counts, displs, Scalar_T, 0, comm_face);
+    MPI_Gatherv(groupZen, GROUP_NUM_STREAMS, Scalar_T,
+                zen0, counts, displs, Scalar_T, 0, comm_face);
+
+    free(groupAzi);
+    free(groupZen);
+    free(counts);
+    free(displs);
+
+  }
+
+  if (mpi_rank_world == 0) {
+
     rpout = fopen("./streamMapping.txt","w");
 
     fprintf(rpout,"%6s\t%4s\t%3s\t%3s\t%6s\t%6s\n","obsIDX","face","row","col","long0","colat0");
@@ -136,11 +183,14 @@ Index_t strideSize = sizeof(Node_t) / sizeof(double);
               computeLines[stream][0],
               computeLines[stream][1],
               computeLines[stream][2],
-              grid[idx_frcs(computeLines[stream][0],computeLines[stream][1],computeLines[stream][2],0)].azi + PI,
-              grid[idx_frcs(computeLines[stream][0],computeLines[stream][1],computeLines[stream][2],0)].zen);
+              azi0[stream] + PI,
+              zen0[stream]);
 
     fclose(rpout);
 
+    free(azi0);
+    free(zen0);
+
   }
 
 }/*--------------------- END buildOutputNames( ) -------------------*/
@@ -217,8 +267,6 @@ int * distObs_varid;
 {/*-----------------------------------------------------------------*/
 
 
-  Index_t numIters = NUM_STREAMS / N_PROCS;
-
   Index_t observerIndex, iterIndex;
   Scalar_t tempScale;
 
@@ -252,11 +300,12 @@ int * distObs_varid;
     nc_precision = NC_DOUBLE;
 
 
-  for (iterIndex = 0; iterIndex <= numIters; iterIndex++) {
+  for (iterIndex = 0; iterIndex < STREAM_SCHEDULE_LENGTH; iterIndex++) {
 
-    observerIndex = mpi_rank + N_PROCS * iterIndex;
+    // Each face group writes the files of its own streams.
+    if (iterIndex < RANK_NUM_STREAMS(mpi_rank)) {
 
-    if (observerIndex < NUM_STREAMS) {
+      observerIndex = GROUP_STREAM(WORK_INDEX(mpi_rank, iterIndex));
 
       if (unifiedOutputInit == 0)
       {
@@ -446,7 +495,6 @@ int * distObs_varid;
 {/*-----------------------------------------------------------------*/
 
   Index_t observerIndex, shell;
-  Index_t numIters = NUM_STREAMS / N_PROCS;
   Index_t iterIndex;
 
   size_t startTime[1]  = {0};
@@ -479,14 +527,15 @@ int * distObs_varid;
     for (shell = 0; shell < TOTAL_NUM_SHELLS; shell++)
       shellStream[shell] = shell;
 
-  for (iterIndex = 0; iterIndex <= numIters; iterIndex++) {
+  for (iterIndex = 0; iterIndex < STREAM_SCHEDULE_LENGTH; iterIndex++) {
 
     update_stream_from_shells( iterIndex );
-    observerIndex = mpi_rank + N_PROCS * iterIndex;
-
-    if (observerIndex < NUM_STREAMS)
+    // Each face group writes the files of its own streams.
+    if (iterIndex < RANK_NUM_STREAMS(mpi_rank))
     {
 
+      observerIndex = GROUP_STREAM(WORK_INDEX(mpi_rank, iterIndex));
+
       err = nc_open(outputLineNamesNetCDF[observerIndex], NC_WRITE, &ncid);
 
       if (observerTimeSlice == 0)
@@ -776,7 +825,7 @@ int * po_distObs_varid;
 
   Index_t numPointObs, pointObserverIndex;
   Index_t species, energy, mu;
-  Index_t face, row, col;
+  Index_t stream, face, row, col;
 
   Node_t pointObsNode[1];
 
@@ -806,7 +855,7 @@ int * po_distObs_varid;
   Scalar_t * tempDist;
   tempDist = (Scalar_t *) malloc(sizeof(Scalar_t)*(int)NUM_SPECIES*(int)NUM_ESTEPS*(int)NUM_MUSTEPS);
 
-  // get projections for the observer points
+  // get projections for the observer points of this face group's streams
   getPointObsProjections();
 
 
@@ -814,8 +863,90 @@ int * po_distObs_varid;
   for (pointObserverIndex = 0; pointObserverIndex < numPointObs; pointObserverIndex++)
   {
 
-    // only process one does any I/O
+    // every face group weighs in the streams it owns
     if (mpi_rank == 0)
+    {
+
+      // assign and normalize observer spherical position (stays in AU)
+      rSph.r     = config.obsR[pointObserverIndex];
+      rSph.theta = config.obsTheta[pointObserverIndex];
+      rSph.phi   = config.obsPhi[pointObserverIndex];
+
+      if (rSph.phi < 0.0) rSph.phi += 2.0 * PI;
+      if ( rSph.phi > (2.0 * PI) ) rSph.phi -= 2.0 * PI;
+
+      // compute observer Cartesian position (also used later)
+      rCart = sphToCartPos(rSph);
+
+      // zero out distribution
+      for (species = 0; species < NUM_SPECIES; species++)
+      {
+        for (energy = 0; energy < NUM_ESTEPS; energy++)
+        {
+          for (mu = 0; mu < NUM_MUSTEPS; mu++)
+          {
+
+            tempDist[idx_sem(species,energy,mu)] = 0.0;
+
+          }
+
+        }
+
+      }
+
+      weightSum = 0.0;
+
+      // calculate coefficients and interpolate the distribution
+      for (stream = FIRST_GROUP_STREAM; stream < FIRST_GROUP_STREAM + GROUP_NUM_STREAMS; stream++)
+      {
+
+        face = computeLines[stream][0];
+        row  = computeLines[stream][1];
+        col  = computeLines[stream][2];
+
+        rProj = projections[idx_frco(face,row,col,pointObserverIndex)].r;
+
+        distance = sqrt((rCart.x - rProj.x) * (rCart.x - rProj.x) +
+                        (rCart.y - rProj.y) * (rCart.y - rProj.y) +
+                        (rCart.z - rProj.z) * (rCart.z - rProj.z));
+
+        weight = pow(distance, -1.0 * config.idw_p);
+        weightSum += weight;
+
+        for (species = 0; species < NUM_SPECIES; species++)
+        {
+          for (energy = 0; energy < NUM_ESTEPS; energy++)
+          {
+            for (mu = 0; mu < NUM_MUSTEPS; mu++)
+            {
+
+              tempDist[idx_sem(species,energy,mu)] +=
+                (weight * ePartsProj[idx_frcspemo(face,row,col,species,energy,mu,pointObserverIndex)]);
+
+            }
+
+          }
+
+        }
+
+      }
+
+      // sum up the face groups on face group 0
+      if (face_group == 0)
+      {
+        MPI_Reduce(MPI_IN_PLACE, tempDist, SPEM, MPI_DOUBLE, MPI_SUM, 0, comm_face);
+        MPI_Reduce(MPI_IN_PLACE, &weightSum, 1, MPI_DOUBLE, MPI_SUM, 0, comm_face);
+      }
+      else
+      {
+        MPI_Reduce(tempDist, NULL, SPEM, MPI_DOUBLE, MPI_SUM, 0, comm_face);
+        MPI_Reduce(&weightSum, NULL, 1, MPI_DOUBLE, MPI_SUM, 0, comm_face);
+      }
+
+    }
+
+    // only process one does any I/O
+    if (mpi_rank_world == 0)
     {
 
       sprintf(pointObsName, "p_obs%03i.nc", pointObserverIndex);
@@ -844,16 +975,6 @@ int * po_distObs_varid;
       if (pointObsNode[0].azi < 0.0) pointObsNode[0].azi += 2.0 * PI;
       if ( pointObsNode[0].azi > (2.0 * PI) ) pointObsNode[0].azi -= 2.0 * PI;
 
-      // assign and normalize observer spherical position (stays in AU)
-      rSph.r     = config.obsR[pointObserverIndex];
-      rSph.theta = config.obsTheta[pointObserverIndex];
-      rSph.phi   = config.obsPhi[pointObserverIndex];
-
-      if (rSph.phi < 0.0) rSph.phi += 2.0 * PI;
-      if ( rSph.phi > (2.0 * PI) ) rSph.phi -= 2.0 * PI;
-
-      // compute observer Cartesian position (also used later)
-      rCart = sphToCartPos(rSph);
       pointObsNode[0].r = rCart;
       pointObsNode[0].rOld = rCart;
 
@@ -876,66 +997,8 @@ int * po_distObs_varid;
       pointObsNode[0].mhdVphi = mhdNode.mhdV.phi;
       pointObsNode[0].mhdDensity = mhdNode.mhdD;
 
-      // zero out distribution
-      for (species = 0; species < NUM_SPECIES; species++)
-      {
-        for (energy = 0; energy < NUM_ESTEPS; energy++)
-        {
-          for (mu = 0; mu < NUM_MUSTEPS; mu++)
-          {
-
-            tempDist[idx_sem(species,energy,mu)] = 0.0;
-
-          }
-
-        }
-
-      }
-
-      weightSum = 0.0;
-
       rSph.r /= config.rScale;
 
-      // calculate coefficients and interpolate the distribution
-      for (face = 0; face < NUM_FACES; face++)
-      {
-        for (row = 0; row < FACE_ROWS; row++)
-        {
-          for (col = 0; col < FACE_COLS; col++)
-          {
-
-            rProj = projections[idx_frco(face,row,col,pointObserverIndex)].r;
-
-            distance = sqrt((rCart.x - rProj.x) * (rCart.x - rProj.x) +
-                            (rCart.y - rProj.y) * (rCart.y - rProj.y) +
-                            (rCart.z - rProj.z) * (rCart.z - rProj.z));
-
-            weight = pow(distance, -1.0 * config.idw_p);
-            weightSum += weight;
-
-            for (species = 0; species < NUM_SPECIES; species++)
-            {
-              for (energy = 0; energy < NUM_ESTEPS; energy++)
-              {
-                for (mu = 0; mu < NUM_MUSTEPS; mu++)
-                {
-
-                  tempDist[idx_sem(species,energy,mu)] +=
-                    (weight * ePartsProj[idx_frcspemo(face,row,col,species,energy,mu,pointObserverIndex)]);
-
-                }
-
-              }
-
-            }
-
-
-          }
-
-        }
-
-      }
-
       // finalize the interpolation with the weight sum
       for (species = 0; species < NUM_SPECIES; species++)
       {
@@ -1108,9 +1171,7 @@ int domainDims[5];
   ptrdiff_t strideTimeFaceRowColShell[5] = {1, 1, 1, 1, 1};
   ptrdiff_t mapTimeFaceRowColShell[5]    = {0, 0, 0, 0, strideSize};
 
-  double timer_tmp = 0;
-
-  if (mpi_rank == 0)
+  if (mpi_rank_world == 0)
   {
 
     err = nc_open("epremDomain.nc", NC_WRITE, &ncid);
@@ -1128,24 +1189,11 @@ int domainDims[5];
       for (col = 0; col < FACE_COLS; col++)
       {
 
-        timer_tmp = MPI_Wtime();
-
         // gather up the stream
-        MPI_Gatherv(&grid[idx_frcs(face,row,col,INNER_ACTIVE_SHELL)],
-                    ACTIVE_STREAM_SIZE,
-                    Node_T,
-                    streamGrid,
-                    recvCountGrid,
-                    displGrid,
-                    Node_T,
-                    0,
-                    MPI_COMM_WORLD);
-
-        timer_MPIgatherscatter = timer_MPIgatherscatter
-                                 + (MPI_Wtime() - timer_tmp);
+        gatherFaceGroupStream(face, row, col, 0);
 
         // only process one does any I/O
-        if (mpi_rank == 0)
+        if (mpi_rank_world == 0)
         {
 
           // set the angles before writing to the cdf file
@@ -1182,7 +1230,7 @@ int domainDims[5];
 
   }
 
-  if (mpi_rank == 0)
+  if (mpi_rank_world == 0)
   {
 
     err = nc_close(ncid);
@@ -1350,16 +1398,19 @@ int unstructuredDims2D[2];
 
   countEnergy[0]=NUM_ESTEPS;
 
-  X=(Scalar_t*)malloc(totalNodes*sizeof(Scalar_t));
-  Y=(Scalar_t*)malloc(totalNodes*sizeof(Scalar_t));
-  Z=(Scalar_t*)malloc(totalNodes*sizeof(Scalar_t));
-  J=(Scalar_t*)malloc(totalNodes*NUM_ESTEPS*sizeof(Scalar_t));
+  X = NULL;
+  Y = NULL;
+  Z = NULL;
+  J = NULL;
 
-  double timer_tmp = 0;
-
-  if (mpi_rank == 0)
+  if (mpi_rank_world == 0)
   {
 
+    X=(Scalar_t*)malloc(totalNodes*sizeof(Scalar_t));
+    Y=(Scalar_t*)malloc(totalNodes*sizeof(Scalar_t));
+    Z=(Scalar_t*)malloc(totalNodes*sizeof(Scalar_t));
+    J=(Scalar_t*)malloc(totalNodes*NUM_ESTEPS*sizeof(Scalar_t));
+
     err = nc_open("unstructuredDomain.nc", NC_WRITE, &ncid);
 
     startTime[0] = unstructuredDomainTimeSlice;
@@ -1393,33 +1444,10 @@ int unstructuredDims2D[2];
       for (col = 0; col < FACE_COLS; col++)
       {
 
-        timer_tmp = MPI_Wtime();
-
-        MPI_Gatherv(&eParts[idx_frcsspem(face,row,col,INNER_ACTIVE_SHELL,0,0,0)],
-                    ACTIVE_STREAM_SIZE*NUM_SPECIES*NUM_ESTEPS*NUM_MUSTEPS,
-                    Scalar_T,
-                    ePartsStream,
-                    recvCountEparts,
-                    displEparts,
-                    Scalar_T,
-                    0,
-                    MPI_COMM_WORLD);
-
-        MPI_Gatherv(&grid[idx_frcs(face,row,col,INNER_ACTIVE_SHELL)],
-                    ACTIVE_STREAM_SIZE,
-                    Node_T,
-                    streamGrid,
-                    recvCountGrid,
-                    displGrid,
-                    Node_T,
-                    0,
-                    MPI_COMM_WORLD);
-
-        timer_MPIgatherscatter = timer_MPIgatherscatter
-                                 + (MPI_Wtime() - timer_tmp);
+        gatherFaceGroupStream(face, row, col, 1);
 
         // only process one does any I/O
-        if (mpi_rank == 0)
+        if (mpi_rank_world == 0)
         {
 
           for (shell = 0; shell < TOTAL_NUM_SHELLS; shell++)
@@ -1460,7 +1488,7 @@ int unstructuredDims2D[2];
 
   }
 
-  if (mpi_rank == 0)
+  if (mpi_rank_world == 0)
   {
 
     start2D[0] = unstructuredDomainTimeSlice;
@@ -1508,7 +1536,7 @@ int unstructuredDims2D[2];
         if ( (t_global == 0.0) || (t_global*DAY >= config.unifiedOutputTime) ) {
           writeObserverDataNetCDF();
           observerTimeSlice++;
-          if (mpi_rank==0) printf("  --> IO: Wrote observer data to file.\n");
+          if (mpi_rank_world == 0) printf("  --> IO: Wrote observer data to file.\n");
         }
       }
 
@@ -1518,7 +1546,7 @@ int unstructuredDims2D[2];
         if ( (t_global == 0.0) || (t_global*DAY >= config.pointObserverOutputTime) ) {
           writePointObserverDataNetCDF();
           pointObserverTimeSlice++;
-          if (mpi_rank==0) printf("  --> IO: Wrote point observer data to file.\n");
+          if (mpi_rank_world == 0) printf("  --> IO: Wrote point observer data to file.\n");
         }
       }
 
@@ -1528,7 +1556,7 @@ int unstructuredDims2D[2];
         if ( (t_global == 0.0) || (t_global*DAY >= config.epremDomainOutputTime) ) {
           domainDumpNetCDF();
           domainTimeSlice++;
-          if(mpi_rank==0) printf("  --> IO: Wrote domain to file.\n");
+          if(mpi_rank_world == 0) printf("  --> IO: Wrote domain to file.\n");
         }
       }
 
@@ -1538,7 +1566,7 @@ int unstructuredDims2D[2];
         if ( (t_global == 0.0) || (t_global*DAY >= config.epremDomainOutputTime) ) {
           unstructuredDomainDumpNetCDF();
           unstructuredDomainTimeSlice++;
-          if (mpi_rank==0) printf("  --> IO: Wrote unstructured domain data to file.\n");
+          if (mpi_rank_world == 0) printf("  --> IO: Wrote unstructured domain data to file.\n");
         }
       }
 
@@ -0,0 +1,222 @@
+/*-----------------------------------------------
+-- EMMREM: workspace.c
+--
+-- Persistent, per-thread scratch memory for the EP solver.
+--
+-- Each thread owns one contiguous workspace that is set up once and
+-- used as a stack: a kernel records workspaceMark() on entry, takes
+-- its scratch arrays with workspaceAlloc() and hands them all back
+-- with workspaceRelease() on exit.
+--
+-- ______________CHANGE HISTORY______________
+-- ______________END CHANGE HISTORY______________
+------------------------------------------------*/
+
+/* The Earth-Moon-Mars Radiation Environment Module (EMMREM) software is */
+/* free software; you can redistribute and/or modify the EMMREM sotware */
+/* or any part of the EMMREM software under the terms of the GNU General */
+/* Public License (GPL) as published by the Free Software Foundation; */
+/* either version 2 of the License, or (at your option) any later */
+/* version. Software that uses any portion of the EMMREM software must */
+/* also be released under the GNU GPL license (version 2 of the GNU GPL */
+/* license or a later version). A copy of this GNU General Public License */
+/* may be obtained by writing to the Free Software Foundation, Inc., 59 */
+/* Temple Place, Suite 330, Boston MA 02111-1307 USA or by viewing the */
+/* license online at http://www.gnu.org/copyleft/gpl.html. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "global.h"
+#include "mpiInit.h"
+#include "error.h"
+#include "workspace.h"
+
+// The bookkeeping of each thread fills a cache line of its own so that
+// threads moving their marks do not share lines.
+typedef struct {
+  char   *base;
+  size_t  size;
+  size_t  used;
+  size_t  highWater;
+  char    pad[WORKSPACE_ALIGN - sizeof(char *) - 3*sizeof(size_t)];
+} Workspace_t;
+
+static Workspace_t *workspace = NULL;
+static char *workspaceMemory = NULL;
+
+#ifdef _OPENMP
+#define THREAD_WORKSPACE (&workspace[omp_get_thread_num()])
+#else
+#define THREAD_WORKSPACE (&workspace[0])
+#endif
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         initWorkspace(size_t sharedBytes,        /*---*/
+/*---*/                       size_t threadBytes)        /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  Index_t thread;
+  size_t offset;
+
+  sharedBytes = workspaceBytes(sharedBytes, 1);
+  threadBytes = workspaceBytes(threadBytes, 1);
+
+  if ( (posix_memalign((void **) &workspace, WORKSPACE_ALIGN,
+                       sizeof(Workspace_t)*N_THREADS) != 0) ||
+       (posix_memalign((void **) &workspaceMemory, WORKSPACE_ALIGN,
+                       sharedBytes + threadBytes*N_THREADS) != 0) )
+    panic("initWorkspace: unable to allocate the EP workspaces\n");
+
+  offset = 0;
+
+  for (thread = 0; thread < N_THREADS; thread++) {
+
+    workspace[thread].base      = workspaceMemory + offset;
+    workspace[thread].size      = threadBytes + ((thread == 0) ? sharedBytes : 0);
+    workspace[thread].used      = 0;
+    workspace[thread].highWater = 0;
+
+    offset += workspace[thread].size;
+
+  }
+
+  // First touch: the pages of a workspace end up near the thread that
+  // uses it, and none of them fault later inside the solver.
+#ifdef _OPENMP
+  #pragma omp parallel num_threads(N_THREADS)
+#endif
+  {
+    Workspace_t *ws = THREAD_WORKSPACE;
+    memset(ws->base, 0, ws->size);
+  }
+
+}
+/*------------------ END  initWorkspace( ) ------------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void *                                   /*---*/
+/*---*/         workspaceAlloc(size_t bytes)             /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  Workspace_t *ws = THREAD_WORKSPACE;
+  void *block;
+
+  bytes = workspaceBytes(bytes, 1);
+
+  if (ws->used + bytes > ws->size) {
+    snprintf(err_msg, ERROR_MSG_SIZE,
+             "workspaceAlloc: workspace exhausted (%lu of %lu bytes in use, %lu requested)\n",
+             (unsigned long) ws->used, (unsigned long) ws->size,
+             (unsigned long) bytes);
+    panic(err_msg);
+  }
+
+  block = ws->base + ws->used;
+
+  ws->used += bytes;
+
+  if (ws->used > ws->highWater) ws->highWater = ws->used;
+
+  return block;
+
+}
+/*------------------ END  workspaceAlloc( ) -----------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         size_t                                   /*---*/
+/*---*/         workspaceMark(void)                      /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  return THREAD_WORKSPACE->used;
+
+}
+/*------------------ END  workspaceMark( ) ------------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         workspaceRelease(size_t mark)            /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  THREAD_WORKSPACE->used = mark;
+
+}
+/*------------------ END  workspaceRelease( ) ---------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         workspaceReport(void)                    /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  Index_t thread;
+  unsigned long local[2], global[2];
+
+  local[0] = 0;
+  local[1] = 0;
+
+  for (thread = 0; thread < N_THREADS; thread++) {
+    if (workspace[thread].highWater > local[0]) local[0] = workspace[thread].highWater;
+    if (workspace[thread].size > local[1]) local[1] = workspace[thread].size;
+  }
+
+  MPI_Reduce(local, global, 2, MPI_UNSIGNED_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+
+  ROOT_MSG("EP workspace high-water mark: %lu of %lu bytes (largest thread)\n",
+           global[0], global[1]);
+
+}
+/*------------------ END  workspaceReport( ) ----------------*/
+/*-----------------------------------------------------------*/
+
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         freeWorkspace(void)                      /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+{
+
+  free(workspaceMemory);
+  free(workspace);
+
+  workspaceMemory = NULL;
+  workspace = NULL;
+
+}
+/*------------------ END  freeWorkspace( ) ------------------*/
+/*-----------------------------------------------------------*/
@@ -0,0 +1,107 @@
+/*-----------------------------------------------
+-- EMMREM: workspace.h
+--
+-- Persistent, per-thread scratch memory for the EP solver.
+--
+-- ______________CHANGE HISTORY______________
+-- ______________END CHANGE HISTORY______________
+------------------------------------------------*/
+
+/* The Earth-Moon-Mars Radiation Environment Module (EMMREM) software is */
+/* free software; you can redistribute and/or modify the EMMREM sotware */
+/* or any part of the EMMREM software under the terms of the GNU General */
+/* Public License (GPL) as published by the Free Software Foundation; */
+/* either version 2 of the License, or (at your option) any later */
+/* version. Software that uses any portion of the EMMREM software must */
+/* also be released under the GNU GPL license (version 2 of the GNU GPL */
+/* license or a later version). A copy of this GNU General Public License */
+/* may be obtained by writing to the Free Software Foundation, Inc., 59 */
+/* Temple Place, Suite 330, Boston MA 02111-1307 USA or by viewing the */
+/* license online at http://www.gnu.org/copyleft/gpl.html. */
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Every block handed out by workspaceAlloc() starts on a boundary of
+// this many bytes (one cache line, and a full AVX-512 vector).
+#define WORKSPACE_ALIGN 64
+
+// Number of bytes a block of count elements of the given size takes
+// up in a workspace, including the padding to the next boundary.
+#define workspaceBytes(count,size) \
+  ((((size_t)(count)*(size_t)(size)) + WORKSPACE_ALIGN - 1) \
+   / WORKSPACE_ALIGN * WORKSPACE_ALIGN)
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         initWorkspace(size_t sharedBytes,        /*---*/
+/*---*/                       size_t threadBytes);       /*---*/
+/*---                                                      ---*/
+/*--- Set up one workspace of threadBytes for each of the  ---*/
+/*--- N_THREADS threads. The workspace of the master       ---*/
+/*--- thread gets an extra sharedBytes for the buffers it  ---*/
+/*--- keeps for the whole run. Each thread touches its     ---*/
+/*--- own workspace here so that no page faults are left   ---*/
+/*--- for the solver.                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void *                                   /*---*/
+/*---*/         workspaceAlloc(size_t bytes);            /*---*/
+/*---                                                      ---*/
+/*--- Take an aligned block from the calling thread's      ---*/
+/*--- workspace. Panics if the workspace is exhausted.     ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         size_t                                   /*---*/
+/*---*/         workspaceMark(void);                     /*---*/
+/*---                                                      ---*/
+/*--- Current top of the calling thread's workspace.       ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         workspaceRelease(size_t mark);           /*---*/
+/*---                                                      ---*/
+/*--- Give back every block the calling thread took since  ---*/
+/*--- workspaceMark() returned mark.                       ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         workspaceReport(void);                   /*---*/
+/*---                                                      ---*/
+/*--- Print the largest high-water mark of any thread on   ---*/
+/*--- any rank. Must be called by all ranks.              ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/*---*/         void                                     /*---*/
+/*---*/         freeWorkspace(void);                     /*---*/
+/*---                                                      ---*/
+/*------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif